@@ -8,6 +8,7 @@
 #include "Game/Item.hpp"
 #include "Game/Incident.hpp"
 #include "Game/Trigger.hpp"
+#include "Game/ScenarioImage.hpp"
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
@@ -41,6 +42,27 @@ String Action::GetAsString()
 }
 
 
+ActionType Action::GetType() const
+{
+	return ACTION_UNKNOWN;
+}
+
+
+void Action::WriteToImage(ScenarioImageWriter& writer) const
+{
+	UNUSED(writer);
+	ERROR_AND_DIE("Base class WriteToImage should never be called.");
+}
+
+
+// Actions with no name references have nothing to link
+void Action::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	UNUSED(referrer);
+	UNUSED(out_errors);
+}
+
+
 //-----------------------------------------------------
 ActionDisplayText::ActionDisplayText(Scenario* event_trigger, const XmlElement* element) :
 	Action(event_trigger)
@@ -94,6 +116,13 @@ ActionDisplayText::ActionDisplayText(Trigger* event_trigger, const XmlElement* e
 }
 
 
+ActionDisplayText::ActionDisplayText(Scenario* the_setup, ScenarioImageReader& reader) :
+	Action(the_setup)
+{
+	m_message = reader.ReadString();
+}
+
+
 ActionDisplayText::~ActionDisplayText()
 {
 }
@@ -113,6 +142,18 @@ String ActionDisplayText::GetAsString()
 }
 
 
+ActionType ActionDisplayText::GetType() const
+{
+	return ACTION_DISPLAY_TEXT;
+}
+
+
+void ActionDisplayText::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(m_message);
+}
+
+
 //-----------------------------------------------------
 ActionChangeCardState::ActionChangeCardState(Scenario* the_setup, const XmlElement* element) :
 	Action(the_setup)
@@ -147,15 +188,15 @@ ActionChangeCardState::ActionChangeCardState(Scenario* the_setup, const XmlEleme
 		}
 		else if (attribute_name == "name")
 		{
-			m_cardName = StringToLower(attribute->Value());
+			m_cardNameId = m_theScenario->InternName(attribute->Value());
 		}
 		else if (attribute_name == "fromstate")
 		{
-			m_fromStateName = StringToLower(attribute->Value());
+			m_fromStateId = m_theScenario->InternName(attribute->Value());
 		}
 		else if (attribute_name == "tostate")
 		{
-			m_toStateName = StringToLower(attribute->Value());
+			m_toStateId = m_theScenario->InternName(attribute->Value());
 		}
 		else
 		{
@@ -198,15 +239,15 @@ ActionChangeCardState::ActionChangeCardState(Trigger* event_trigger, const XmlEl
 		}
 		else if (attribute_name == "name")
 		{
-			m_cardName = StringToLower(attribute->Value());
+			m_cardNameId = m_theScenario->InternName(attribute->Value());
 		}
 		else if (attribute_name == "fromstate")
 		{
-			m_fromStateName = StringToLower(attribute->Value());
+			m_fromStateId = m_theScenario->InternName(attribute->Value());
 		}
 		else if (attribute_name == "tostate")
 		{
-			m_toStateName = StringToLower(attribute->Value());
+			m_toStateId = m_theScenario->InternName(attribute->Value());
 		}
 		else
 		{
@@ -216,6 +257,16 @@ ActionChangeCardState::ActionChangeCardState(Trigger* event_trigger, const XmlEl
 }
 
 
+ActionChangeCardState::ActionChangeCardState(Scenario* the_setup, ScenarioImageReader& reader) :
+	Action(the_setup)
+{
+	m_cardType = static_cast<CardType>(reader.ReadI32());
+	m_cardNameId = m_theScenario->InternName(reader.ReadString());
+	m_fromStateId = m_theScenario->InternName(reader.ReadString());
+	m_toStateId = m_theScenario->InternName(reader.ReadString());
+}
+
+
 ActionChangeCardState::~ActionChangeCardState()
 {
 }
@@ -225,75 +276,62 @@ void ActionChangeCardState::Execute()
 {
 	ASSERT_OR_DIE(m_cardType != UNKNOWN_CARD_TYPE, "Attempting to change the state of an unknown card type");
 
+	// dangling, reported by the link pass
+	if (m_cardIdx < 0 || m_toStateIdx < 0)
+	{
+		return;
+	}
 
-	String current_state = "";
+	const String& card_name = m_theScenario->GetSymbolName(m_cardNameId);
+	const String& from_state = m_theScenario->GetSymbolName(m_fromStateId);
+	const String& to_state = m_theScenario->GetSymbolName(m_toStateId);
 
+	SymbolId current_state = INVALID_SYMBOL;
 	switch (m_cardType)
 	{
 	case CARD_LOCATION:
 	{
-		LookupItr loc_itr;
-		bool in_scenario = m_theScenario->IsLocationInLookupTable(loc_itr, m_cardName);
-		if (in_scenario)
-		{
-			Location* loc_card = m_theScenario->GetLocationFromList(loc_itr->second);
-			current_state = StringToLower(loc_card->GetLocationState().m_name);
-
-			if (m_fromStateName == "*" || current_state == m_fromStateName)
-			{
-				loc_card->SetState(m_toStateName);
-				g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Changing %s state from %s to %s", m_cardName.c_str(), m_fromStateName.c_str(), m_toStateName.c_str()));
-			}
-			else
-			{
-				g_theDevConsole->PrintString(Rgba::RED, Stringf("Could not change %s state from %s to %s", m_cardName.c_str(), m_fromStateName.c_str(), m_toStateName.c_str()));
-			}
-		}
+		current_state = m_theScenario->GetLocationFromList(m_cardIdx)->GetLocationState().m_nameId;
 		break;
 	}
 	case CARD_CHARACTER:
 	{
-		LookupItr char_itr;
-		bool in_scenario = m_theScenario->IsCharacterInLookupTable(char_itr, m_cardName);
-		if (in_scenario)
-		{
-			Character* char_card = m_theScenario->GetCharacterFromList(char_itr->second);
-			current_state = StringToLower(char_card->GetCharacterState().m_name);
-
-			if (m_fromStateName == "*" || current_state == m_fromStateName)
-			{
-				char_card->SetState(m_toStateName);
-				g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Changing %s state from %s to %s", m_cardName.c_str(), m_fromStateName.c_str(), m_toStateName.c_str()));
-			}
-			else
-			{
-				g_theDevConsole->PrintString(Rgba::RED, Stringf("Could not change %s state from %s to %s", m_cardName.c_str(), m_fromStateName.c_str(), m_toStateName.c_str()));
-			}
-		}
+		current_state = m_theScenario->GetCharacterFromList(m_cardIdx)->GetCharacterState().m_nameId;
 		break;
 	}
 	case CARD_ITEM:
 	{
-		LookupItr item_itr;
-		bool in_scenario = m_theScenario->IsItemInLookupTable(item_itr, m_cardName);
-		if (in_scenario)
-		{
-			Item* item_card = m_theScenario->GetItemFromList(item_itr->second);
-			current_state = StringToLower(item_card->GetItemState().m_name);
+		current_state = m_theScenario->GetItemFromList(m_cardIdx)->GetItemState().m_nameId;
+		break;
+	}
+	}
 
-			if (m_fromStateName == "*" || current_state == m_fromStateName)
-			{
-				item_card->SetState(m_toStateName);
-				g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Changing %s state from %s to %s", m_cardName.c_str(), m_fromStateName.c_str(), m_toStateName.c_str()));
-			}
-			else
-			{
-				g_theDevConsole->PrintString(Rgba::RED, Stringf("Could not change %s state from %s to %s", m_cardName.c_str(), m_fromStateName.c_str(), m_toStateName.c_str()));
-			}
-		}
+	if (m_fromStateId != SYMBOL_WILDCARD && current_state != m_fromStateId)
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("Could not change %s state from %s to %s", card_name.c_str(), from_state.c_str(), to_state.c_str()));
+		return;
+	}
+
+	switch (m_cardType)
+	{
+	case CARD_LOCATION:
+	{
+		m_theScenario->GetLocationFromList(m_cardIdx)->SetStateIdx(m_toStateIdx);
 		break;
 	}
+	case CARD_CHARACTER:
+	{
+		m_theScenario->GetCharacterFromList(m_cardIdx)->SetStateIdx(m_toStateIdx);
+		break;
 	}
+	case CARD_ITEM:
+	{
+		m_theScenario->GetItemFromList(m_cardIdx)->SetStateIdx(m_toStateIdx);
+		break;
+	}
+	}
+
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Changing %s state from %s to %s", card_name.c_str(), from_state.c_str(), to_state.c_str()));
 }
 
 
@@ -305,27 +343,50 @@ String ActionChangeCardState::GetAsString()
 	{
 	case CARD_LOCATION:
 	{
-		line = Stringf("Change the location %s", m_cardName.c_str());
+		line = Stringf("Change the location %s", m_theScenario->GetSymbolName(m_cardNameId).c_str());
 		break;
 	}
 	case CARD_CHARACTER:
 	{
-		line = Stringf("Change the character %s", m_cardName.c_str());
+		line = Stringf("Change the character %s", m_theScenario->GetSymbolName(m_cardNameId).c_str());
 		break;
 	}
 	case CARD_ITEM:
 	{
-		line = Stringf("Change the item %s", m_cardName.c_str());
+		line = Stringf("Change the item %s", m_theScenario->GetSymbolName(m_cardNameId).c_str());
 		break;
 	}
 	}
 
-	line += Stringf(" from state %s to state %s.", m_fromStateName.c_str(), m_toStateName.c_str());
+	line += Stringf(" from state %s to state %s.", m_theScenario->GetSymbolName(m_fromStateId).c_str(), m_theScenario->GetSymbolName(m_toStateId).c_str());
 
 	return Stringf("ActionChangeCardState: %s", line.c_str());
 }
 
 
+ActionType ActionChangeCardState::GetType() const
+{
+	return ACTION_CHANGE_CARD_STATE;
+}
+
+
+void ActionChangeCardState::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteI32(m_cardType);
+	writer.WriteString(m_theScenario->GetSymbolName(m_cardNameId));
+	writer.WriteString(m_theScenario->GetSymbolName(m_fromStateId));
+	writer.WriteString(m_theScenario->GetSymbolName(m_toStateId));
+}
+
+
+void ActionChangeCardState::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	m_cardIdx = m_theScenario->LinkCardReference(m_cardType, m_cardNameId, referrer, out_errors);
+	m_theScenario->LinkStateReference(m_cardType, m_cardIdx, m_fromStateId, referrer, out_errors);
+	m_toStateIdx = m_theScenario->LinkStateReference(m_cardType, m_cardIdx, m_toStateId, referrer, out_errors);
+}
+
+
 //-----------------------------------------------------
 ActionIncidentToggle::ActionIncidentToggle(Scenario* event_trigger, const XmlElement* element) :
 	Action(event_trigger)
@@ -404,6 +465,14 @@ ActionIncidentToggle::ActionIncidentToggle(Trigger* event_trigger, const XmlElem
 }
 
 
+ActionIncidentToggle::ActionIncidentToggle(Scenario* the_setup, ScenarioImageReader& reader) :
+	Action(the_setup)
+{
+	m_incidentName = reader.ReadString();
+	m_set = reader.ReadBool();
+}
+
+
 ActionIncidentToggle::~ActionIncidentToggle()
 {
 }
@@ -411,11 +480,9 @@ ActionIncidentToggle::~ActionIncidentToggle()
 
 void ActionIncidentToggle::Execute()
 {
-	LookupItr inc_itr;
-	const bool in_scenario = m_theScenario->IsIncidentInLookupTable(inc_itr, m_incidentName);
-	if (in_scenario)
+	if (m_incidentIdx >= 0)
 	{
-		Incident* inc = m_theScenario->GetIncidentFromList(inc_itr->second);
+		Incident* inc = m_theScenario->GetIncidentFromList(m_incidentIdx);
 		inc->SetActive(m_set);
 		g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Setting %s, to %s", m_incidentName.c_str(), (m_set ? "enable" : "disable")));
 	}
@@ -443,3 +510,82 @@ String ActionIncidentToggle::GetAsString()
 
 	return Stringf("ActionIncidentToggle: %s", line.c_str());
 }
+
+
+ActionType ActionIncidentToggle::GetType() const
+{
+	return ACTION_INCIDENT_TOGGLE;
+}
+
+
+void ActionIncidentToggle::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(m_incidentName);
+	writer.WriteBool(m_set);
+}
+
+
+void ActionIncidentToggle::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	m_incidentIdx = m_theScenario->LinkIncidentReference(m_incidentName, referrer, out_errors);
+}
+
+
+//-----------------------------------------------------
+void WriteActionListToImage(ScenarioImageWriter& writer, const ActionList& actions)
+{
+	const uint num_actions = static_cast<uint>(actions.size());
+	writer.WriteU32(num_actions);
+
+	for (uint act_idx = 0; act_idx < num_actions; ++act_idx)
+	{
+		writer.WriteI32(actions[act_idx]->GetType());
+		actions[act_idx]->WriteToImage(writer);
+	}
+}
+
+
+void ReadActionListFromImage(ActionList& out_actions, Scenario* the_setup, ScenarioImageReader& reader)
+{
+	const uint num_actions = reader.ReadU32();
+	out_actions.reserve(out_actions.size() + num_actions);
+
+	for (uint act_idx = 0; act_idx < num_actions; ++act_idx)
+	{
+		const ActionType type = static_cast<ActionType>(reader.ReadI32());
+
+		switch (type)
+		{
+		case ACTION_DISPLAY_TEXT:
+		{
+			out_actions.push_back(the_setup->GetArena().Create<ActionDisplayText>(the_setup, reader));
+			break;
+		}
+		case ACTION_CHANGE_CARD_STATE:
+		{
+			out_actions.push_back(the_setup->GetArena().Create<ActionChangeCardState>(the_setup, reader));
+			break;
+		}
+		case ACTION_INCIDENT_TOGGLE:
+		{
+			out_actions.push_back(the_setup->GetArena().Create<ActionIncidentToggle>(the_setup, reader));
+			break;
+		}
+		default:
+		{
+			ERROR_AND_DIE(Stringf("Unknown action type %i in scenario image", type));
+			break;
+		}
+		}
+	}
+}
+
+
+void LinkActionListReferences(ActionList& actions, const String& referrer, StringList& out_errors)
+{
+	const uint num_actions = static_cast<uint>(actions.size());
+	for (uint act_idx = 0; act_idx < num_actions; ++act_idx)
+	{
+		actions[act_idx]->LinkReferences(referrer, out_errors);
+	}
+}
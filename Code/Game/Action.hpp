@@ -12,6 +12,9 @@ public:
 
 	virtual void Execute();
 	virtual String GetAsString();
+	virtual ActionType GetType() const;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const;
+	virtual void LinkReferences(const String& referrer, StringList& out_errors);
 
 protected:
 	Scenario*	m_theScenario = nullptr;
@@ -20,13 +23,16 @@ protected:
 	String m_message;
 
 	//ActionChangeCardState
-	String m_cardName = "";
+	SymbolId m_cardNameId = SYMBOL_EMPTY;
+	int m_cardIdx = -1;
 	CardType m_cardType = UNKNOWN_CARD_TYPE;
-	String m_fromStateName = "";
-	String m_toStateName = "";
+	SymbolId m_fromStateId = SYMBOL_EMPTY;
+	SymbolId m_toStateId = SYMBOL_EMPTY;
+	int m_toStateIdx = -1;		// index into the card's state table, bound by the link pass
 
 	//ActionIncidentToggle
 	String m_incidentName = "";
+	int m_incidentIdx = -1;
 	bool m_set = false;
 };
 
@@ -37,10 +43,13 @@ class ActionDisplayText : public Action
 public:
 	explicit ActionDisplayText(Scenario* event_trigger, const XmlElement* element);
 	explicit ActionDisplayText(Trigger* event_trigger, const XmlElement* element);
+	explicit ActionDisplayText(Scenario* the_setup, ScenarioImageReader& reader);
 	virtual ~ActionDisplayText();
 
 	virtual void Execute() override;
 	virtual String GetAsString() override;
+	virtual ActionType GetType() const override;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const override;
 };
 
 
@@ -50,10 +59,14 @@ class ActionChangeCardState : public Action
 public:
 	explicit ActionChangeCardState(Scenario* the_setup, const XmlElement* element);
 	explicit ActionChangeCardState(Trigger* event_trigger, const XmlElement* element);
+	explicit ActionChangeCardState(Scenario* the_setup, ScenarioImageReader& reader);
 	virtual ~ActionChangeCardState();
 
 	virtual void Execute() override;
 	virtual String GetAsString() override;
+	virtual ActionType GetType() const override;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const override;
+	virtual void LinkReferences(const String& referrer, StringList& out_errors) override;
 
 };
 
@@ -64,9 +77,19 @@ class ActionIncidentToggle : public Action
 public:
 	explicit ActionIncidentToggle(Scenario* event_trigger, const XmlElement* element);
 	explicit ActionIncidentToggle(Trigger* event_trigger, const XmlElement* element);
+	explicit ActionIncidentToggle(Scenario* the_setup, ScenarioImageReader& reader);
 	virtual ~ActionIncidentToggle();
 
 	virtual void Execute() override;
 	virtual String GetAsString() override;
+	virtual ActionType GetType() const override;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const override;
+	virtual void LinkReferences(const String& referrer, StringList& out_errors) override;
 
-};
\ No newline at end of file
+};
+
+
+//-----------------------------------------------------
+void WriteActionListToImage(ScenarioImageWriter& writer, const ActionList& actions);
+void ReadActionListFromImage(ActionList& out_actions, Scenario* the_setup, ScenarioImageReader& reader);
+void LinkActionListReferences(ActionList& actions, const String& referrer, StringList& out_errors);
\ No newline at end of file
@@ -1,4 +1,9 @@
 #include "Game/Card.hpp"
+#include "Game/ScenarioImage.hpp"
+#include "Game/CardImage.hpp"
+#include "Game/Scenario.hpp"
+
+#include "Engine/Core/CPUMesh.hpp"
 
 #include "Engine/Renderer/GPUMesh.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
@@ -26,6 +31,24 @@ void Card::Render() const
 }
 
 
+// Called for cards that are about to be shown, starts loading the image and builds the card once it arrives
+void Card::UpdateCardImage()
+{
+	if (m_image == nullptr || m_material != nullptr)
+	{
+		return;
+	}
+
+	g_theCardImageLoader->RequestLoad(m_image);
+
+	if (m_image->GetMaterial() != nullptr)
+	{
+		m_material = m_image->GetMaterial();
+		CreateCardMesh();
+	}
+}
+
+
 Card::Card(Scenario* the_setup, CardType type) : m_theScenario(the_setup), m_type(type)
 {
 	m_nickNames = StringList();
@@ -36,7 +59,10 @@ Card::Card(Scenario* the_setup, const CardType type, const String& name, const S
 	const String& desc)	: m_theScenario(the_setup), m_type(type), m_name(name), m_nickNames(list_of_nicknames),
 	m_description(desc)
 {
-	
+	if (m_theScenario != nullptr)
+	{
+		m_nameId = m_theScenario->InternName(m_name);
+	}
 }
 
 
@@ -52,24 +78,36 @@ CardType Card::GetCardType() const
 }
 
 
-String Card::GetName() const
+const String& Card::GetName() const
 {
 	return m_name;
 }
 
 
-StringList Card::GetListOfNicknames() const
+SymbolId Card::GetNameId() const
+{
+	return m_nameId;
+}
+
+
+const StringList& Card::GetListOfNicknames() const
 {
 	return m_nickNames;
 }
 
 
-String Card::GetDescription() const
+const String& Card::GetDescription() const
 {
 	return m_description;
 }
 
 
+const String& Card::GetImageDir() const
+{
+	return m_imageDir;
+}
+
+
 void Card::SetDiscovery(const bool discovered)
 {
 	m_found = discovered;
@@ -79,3 +117,57 @@ void Card::SetPosition(const Vec2& pos)
 {
 	m_modelMatrix = m_modelMatrix.MakeTranslation2D(pos);
 }
+
+
+void Card::WriteCardToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(m_name);
+	writer.WriteStringList(m_nickNames);
+	writer.WriteString(m_description);
+	writer.WriteString(m_imageDir);
+}
+
+
+void Card::ReadCardFromImage(ScenarioImageReader& reader)
+{
+	m_name = reader.ReadString();
+	m_nameId = m_theScenario->InternName(m_name);
+	m_nickNames = reader.ReadStringList();
+	m_description = reader.ReadString();
+	m_imageDir = reader.ReadString();
+}
+
+
+// Resets everything read from the scenario files so the card can be imported again, discovery is live state and is kept
+void Card::ClearCardData()
+{
+	m_description = "";
+	m_nickNames.clear();
+	m_imageDir = "";
+	m_image = nullptr;
+	m_material = nullptr;
+
+	if (m_mesh != nullptr)
+	{
+		delete m_mesh;
+		m_mesh = nullptr;
+	}
+}
+
+
+// Only takes a handle to the image, it is loaded the first time the card is about to be shown
+void Card::SetCardImage(const String& image_dir, const AABB2& card_bounds)
+{
+	m_imageDir = image_dir;
+	m_cardBounds = card_bounds;
+	m_image = g_theCardImageLoader->CreateOrGetImage(image_dir);
+}
+
+
+void Card::CreateCardMesh()
+{
+	CPUMesh quad_mesh;
+	CpuMeshAddQuad(&quad_mesh, m_cardBounds);
+	m_mesh = new GPUMesh(g_theRenderer);
+	m_mesh->CreateFromCPUMesh<Vertex_Lit>(quad_mesh); // we won't be updated this;
+}
@@ -2,12 +2,16 @@
 #include "Engine/Math/Matrix44.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/CardStateTable.hpp"
 
 #include <string>
 #include <vector>
 
 class Scenario;
+class ScenarioImageWriter;
+class ScenarioImageReader;
 class Material;
+class CardImage;
 class GPUMesh;
 class Shader;
 
@@ -21,19 +25,28 @@ public:
 	virtual ~Card();
 
 	virtual void Render() const;
+	virtual void UpdateCardImage();
 	
 	// ACCESSORS
 	bool		IsDiscovered() const;
 	CardType	GetCardType() const;
-	String		GetName() const;
-	StringList	GetListOfNicknames() const;
-	String		GetDescription() const;
+	const String&		GetName() const;
+	SymbolId			GetNameId() const;
+	const StringList&	GetListOfNicknames() const;
+	const String&		GetDescription() const;
+	const String&		GetImageDir() const;
 	
 	// MUTATORS
 	void SetDiscovery(bool discovered);
 	void SetPosition(const Vec2& pos);
 
 protected:
+	void WriteCardToImage(ScenarioImageWriter& writer) const;
+	void ReadCardFromImage(ScenarioImageReader& reader);
+	void ClearCardData();
+	void SetCardImage(const String& image_dir, const AABB2& card_bounds);
+	void CreateCardMesh();
+
 	//void ImportStatesFromXml(const XmlElement* element);
 	//void ImportDialogueFromXml(const XmlElement* element);
 
@@ -49,8 +62,12 @@ protected:
 	String			m_description = "";
 	
 	String			m_name = "";
+	SymbolId		m_nameId = SYMBOL_EMPTY;
 	StringList		m_nickNames;
+	String			m_imageDir = "";
 
+	CardImage* m_image = nullptr;
+	AABB2 m_cardBounds = AABB2(0.0f, 0.0f, 0.0f, 0.0f);
 	Material* m_material = nullptr;
 	GPUMesh* m_mesh = nullptr;
 	Matrix44 m_modelMatrix = Matrix44::IDENTITY;
@@ -0,0 +1,254 @@
+#include "Game/CardImage.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+
+#include <cstdio>
+
+CardImageLoader* g_theCardImageLoader = nullptr;
+
+
+//------------------------------------------------------------
+bool CardImageBackend::ReadImageFile(const String& image_dir, std::vector<unsigned char>& out_bytes) const
+{
+	const String file_path = String(CARD_IMAGE_FOLDER) + image_dir;
+
+	FILE* file = fopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	const long file_size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (file_size <= 0)
+	{
+		fclose(file);
+		return false;
+	}
+
+	out_bytes.resize(static_cast<size_t>(file_size));
+	const size_t bytes_read = fread(out_bytes.data(), 1, out_bytes.size(), file);
+	fclose(file);
+
+	return bytes_read == out_bytes.size();
+}
+
+
+// The engine decodes from the file path, the worker read has already pulled the file into the OS cache
+Material* RendererCardImageBackend::CreateImageMaterial(const String& image_dir, const std::vector<unsigned char>& file_bytes)
+{
+	UNUSED(file_bytes);
+
+	const String file_name = image_dir + ".mat";
+	Material* material = g_theRenderer->CreateOrGetMaterial(file_name, false);
+	material->SetShader("default_lit.hlsl");
+	material->m_shader->SetDepth(COMPARE_LESS_EQUAL, true);
+
+	TextureView* texture(reinterpret_cast<TextureView*>(g_theRenderer->CreateOrGetTextureView2D(image_dir)));
+	material->SetDiffuseMap(texture);
+
+	return material;
+}
+
+
+Material* NullCardImageBackend::CreateImageMaterial(const String& image_dir, const std::vector<unsigned char>& file_bytes)
+{
+	UNUSED(image_dir);
+	UNUSED(file_bytes);
+
+	m_numImagesCreated++;
+	return nullptr;
+}
+
+
+uint NullCardImageBackend::GetNumImagesCreated() const
+{
+	return m_numImagesCreated;
+}
+
+
+//------------------------------------------------------------
+CardImage::CardImage(const String& image_dir) : m_imageDir(image_dir) { }
+
+
+const String& CardImage::GetImageDir() const
+{
+	return m_imageDir;
+}
+
+
+CardImageStatus CardImage::GetStatus() const
+{
+	return m_status;
+}
+
+
+bool CardImage::IsReady() const
+{
+	return m_status == IMAGE_READY;
+}
+
+
+Material* CardImage::GetMaterial() const
+{
+	return m_material;
+}
+
+
+//------------------------------------------------------------
+CardImageLoader::CardImageLoader(CardImageBackend* backend) : m_backend(backend)
+{
+	ASSERT_OR_DIE(m_backend != nullptr, "CardImageLoader needs a backend, use NullCardImageBackend when there is no renderer");
+
+	m_worker = std::thread(&CardImageLoader::WorkerMain, this);
+}
+
+
+CardImageLoader::~CardImageLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_queueLock);
+		m_isQuitting = true;
+	}
+	m_queueSignal.notify_all();
+	m_worker.join();
+
+	for (std::map<String, CardImage*>::iterator image_itr = m_images.begin(); image_itr != m_images.end(); ++image_itr)
+	{
+		delete image_itr->second;
+	}
+	m_images.clear();
+
+	delete m_backend;
+	m_backend = nullptr;
+}
+
+
+// Only hands out the handle, nothing is read until RequestLoad
+CardImage* CardImageLoader::CreateOrGetImage(const String& image_dir)
+{
+	const std::map<String, CardImage*>::iterator image_itr = m_images.find(image_dir);
+	if (image_itr != m_images.end())
+	{
+		return image_itr->second;
+	}
+
+	CardImage* image = new CardImage(image_dir);
+	m_images.insert(std::pair<String, CardImage*>(image_dir, image));
+
+	return image;
+}
+
+
+void CardImageLoader::RequestLoad(CardImage* image)
+{
+	if (image == nullptr || image->m_status != IMAGE_UNLOADED)
+	{
+		return;
+	}
+
+	image->m_status = IMAGE_LOADING;
+	m_numInFlight++;
+
+	{
+		std::lock_guard<std::mutex> lock(m_queueLock);
+		m_pendingReads.push_back(image);
+	}
+	m_queueSignal.notify_one();
+}
+
+
+void CardImageLoader::Update()
+{
+	std::vector<CardImage*> finished_reads;
+	{
+		std::lock_guard<std::mutex> lock(m_queueLock);
+		finished_reads.swap(m_finishedReads);
+	}
+
+	const uint num_finished = static_cast<uint>(finished_reads.size());
+	for (uint image_idx = 0; image_idx < num_finished; ++image_idx)
+	{
+		FinishLoad(finished_reads[image_idx]);
+	}
+}
+
+
+void CardImageLoader::FinishAllLoads()
+{
+	while (m_numInFlight > 0)
+	{
+		std::unique_lock<std::mutex> lock(m_queueLock);
+		m_queueSignal.wait(lock, [this]() { return !m_finishedReads.empty(); });
+		lock.unlock();
+
+		Update();
+	}
+}
+
+
+uint CardImageLoader::GetNumImages() const
+{
+	return static_cast<uint>(m_images.size());
+}
+
+
+uint CardImageLoader::GetNumPendingLoads() const
+{
+	return m_numInFlight;
+}
+
+
+void CardImageLoader::WorkerMain()
+{
+	for (;;)
+	{
+		CardImage* image = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_queueLock);
+			m_queueSignal.wait(lock, [this]() { return m_isQuitting || !m_pendingReads.empty(); });
+
+			if (m_isQuitting)
+			{
+				return;
+			}
+
+			image = m_pendingReads.front();
+			m_pendingReads.pop_front();
+		}
+
+		// the image belongs to the worker until it is put on the finished list
+		image->m_readSucceeded = m_backend->ReadImageFile(image->m_imageDir, image->m_fileBytes);
+
+		{
+			std::lock_guard<std::mutex> lock(m_queueLock);
+			m_finishedReads.push_back(image);
+		}
+		m_queueSignal.notify_all();
+	}
+}
+
+
+void CardImageLoader::FinishLoad(CardImage* image)
+{
+	m_numInFlight--;
+
+	if (!image->m_readSucceeded)
+	{
+		ERROR_RECOVERABLE(Stringf("Could not read card image %s%s", CARD_IMAGE_FOLDER, image->m_imageDir.c_str()));
+		image->m_status = IMAGE_FAILED;
+		return;
+	}
+
+	image->m_material = m_backend->CreateImageMaterial(image->m_imageDir, image->m_fileBytes);
+	image->m_status = IMAGE_READY;
+
+	image->m_fileBytes.clear();
+	image->m_fileBytes.shrink_to_fit();
+}
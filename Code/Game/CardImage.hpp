@@ -0,0 +1,117 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+class Material;
+
+// Card and room images are handles that only load the first time a card is about to be shown.
+// The file is read on a worker thread, the texture and material are made on the main thread in CardImageLoader::Update.
+
+constexpr char CARD_IMAGE_FOLDER[] = "Data/Images/";
+
+enum CardImageStatus
+{
+	IMAGE_UNLOADED,
+	IMAGE_LOADING,
+	IMAGE_READY,
+	IMAGE_FAILED,
+
+	NUM_IMAGE_STATUSES
+};
+
+
+//------------------------------------------------------------
+class CardImageBackend
+{
+public:
+	virtual ~CardImageBackend() = default;
+
+	// worker thread, must not touch the renderer
+	virtual bool		ReadImageFile(const String& image_dir, std::vector<unsigned char>& out_bytes) const;
+
+	// main thread
+	virtual Material*	CreateImageMaterial(const String& image_dir, const std::vector<unsigned char>& file_bytes) = 0;
+};
+
+
+class RendererCardImageBackend : public CardImageBackend
+{
+public:
+	Material* CreateImageMaterial(const String& image_dir, const std::vector<unsigned char>& file_bytes) override;
+};
+
+
+// Used when there is no renderer, images still go through the worker but never become materials
+class NullCardImageBackend : public CardImageBackend
+{
+public:
+	Material* CreateImageMaterial(const String& image_dir, const std::vector<unsigned char>& file_bytes) override;
+
+	uint GetNumImagesCreated() const;
+
+private:
+	uint m_numImagesCreated = 0;
+};
+
+
+//------------------------------------------------------------
+class CardImage
+{
+	friend class CardImageLoader;
+
+public:
+	explicit CardImage(const String& image_dir);
+
+	const String&	GetImageDir() const;
+	CardImageStatus	GetStatus() const;
+	bool			IsReady() const;
+	Material*		GetMaterial() const;
+
+private:
+	String						m_imageDir = "";
+	CardImageStatus				m_status = IMAGE_UNLOADED;
+	Material*					m_material = nullptr;
+	std::vector<unsigned char>	m_fileBytes;		// only alive while loading
+	bool						m_readSucceeded = false;
+};
+
+
+//------------------------------------------------------------
+class CardImageLoader
+{
+public:
+	explicit CardImageLoader(CardImageBackend* backend);	// takes ownership of the backend
+	~CardImageLoader();
+
+	CardImage*	CreateOrGetImage(const String& image_dir);
+	void		RequestLoad(CardImage* image);
+	void		Update();
+	void		FinishAllLoads();
+
+	uint		GetNumImages() const;
+	uint		GetNumPendingLoads() const;
+
+private:
+	void WorkerMain();
+	void FinishLoad(CardImage* image);
+
+private:
+	CardImageBackend*				m_backend = nullptr;
+	std::map<String, CardImage*>	m_images;
+	uint							m_numInFlight = 0;		// main thread only
+
+	// shared with the worker
+	std::mutex						m_queueLock;
+	std::condition_variable			m_queueSignal;
+	std::deque<CardImage*>			m_pendingReads;
+	std::vector<CardImage*>			m_finishedReads;
+	bool							m_isQuitting = false;
+
+	std::thread						m_worker;
+};
+
+extern CardImageLoader* g_theCardImageLoader;
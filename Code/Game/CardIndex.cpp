@@ -0,0 +1,585 @@
+#include "Game/CardIndex.hpp"
+#include "Game/CaseFold.hpp"
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <random>
+
+constexpr uint32_t MIN_CARD_INDEX_SLOTS = 64;
+constexpr uint32_t NAMES_PER_PERFECT_BUCKET = 4;
+constexpr uint32_t MAX_DISPLACEMENT_TRIES_PER_NAME = 16;
+constexpr uint32_t MAX_PERFECT_HASH_SEEDS = 16;
+constexpr uint CARD_INDEX_BENCHMARK_QUERY_POOL = 4096;
+
+
+//------------------------------------------------------------
+CardIndex::CardIndex()
+{
+	Clear();
+}
+
+
+void CardIndex::Clear()
+{
+	m_slots.assign(MIN_CARD_INDEX_SLOTS, Slot());
+	m_perfectSlots.clear();
+	m_displacements.clear();
+	m_keyData.clear();
+	m_numNames = 0;
+}
+
+
+void CardIndex::ClearKind(const CardIndexKind kind)
+{
+	for (Slot& slot : m_slots)
+	{
+		slot.m_listIdx[kind] = -1;
+	}
+
+	for (Slot& slot : m_perfectSlots)
+	{
+		slot.m_listIdx[kind] = -1;
+	}
+}
+
+
+bool CardIndex::Insert(const CardIndexKind kind, const std::string_view name, const int list_idx)
+{
+	const FoldedText folded(name);
+	const std::string_view folded_name = folded.GetView();
+	const uint64_t hash = HashFolded(folded_name);
+
+	if (HasPerfectHash())
+	{
+		// a reload putting back names that are already in the set keeps the perfect hash
+		if (const Slot* existing_slot = FindSlot(folded_name))
+		{
+			Slot& slot = m_perfectSlots[existing_slot - m_perfectSlots.data()];
+			if (slot.m_listIdx[kind] >= 0)
+			{
+				return false;
+			}
+
+			slot.m_listIdx[kind] = list_idx;
+			return true;
+		}
+
+		DropPerfectHash();
+	}
+
+	// stay at most half full so probes stay short and there is always an empty slot to stop on
+	if ((m_numNames + 1) * 2 > m_slots.size())
+	{
+		Grow();
+	}
+
+	Slot& slot = m_slots[ProbeSlot(folded_name, static_cast<uint32_t>(hash))];
+
+	if (slot.m_keyOffset == EMPTY_SLOT)
+	{
+		slot.m_hash = static_cast<uint32_t>(hash);
+		slot.m_keyOffset = static_cast<uint32_t>(m_keyData.size());
+		slot.m_keyLength = static_cast<uint32_t>(folded_name.size());
+		m_keyData.append(folded_name);
+
+		m_numNames++;
+	}
+
+	if (slot.m_listIdx[kind] >= 0)
+	{
+		return false;
+	}
+
+	slot.m_listIdx[kind] = list_idx;
+	return true;
+}
+
+
+// A seed can leave a last bucket of several names with too few free slots, the next seed deals the buckets again
+bool CardIndex::BuildPerfectHash()
+{
+	if (HasPerfectHash() || m_numNames == 0)
+	{
+		return true;
+	}
+
+	std::vector<uint64_t> hashes;
+	std::vector<uint32_t> slot_indices;
+	hashes.reserve(m_numNames);
+	slot_indices.reserve(m_numNames);
+	for (uint32_t slot_idx = 0; slot_idx < static_cast<uint32_t>(m_slots.size()); ++slot_idx)
+	{
+		const Slot& slot = m_slots[slot_idx];
+		if (slot.m_keyOffset != EMPTY_SLOT)
+		{
+			hashes.push_back(HashFolded(std::string_view(m_keyData.data() + slot.m_keyOffset, slot.m_keyLength)));
+			slot_indices.push_back(slot_idx);
+		}
+	}
+
+	for (uint32_t seed_idx = 0; seed_idx < MAX_PERFECT_HASH_SEEDS; ++seed_idx)
+	{
+		m_perfectSeed = seed_idx * 0xC2B2AE3D27D4EB4Full;
+		if (TryBuildPerfectHash(hashes, slot_indices))
+		{
+			return true;
+		}
+	}
+
+	m_perfectSeed = 0;
+	return false;
+}
+
+
+// Buckets are placed largest first, each with the first displacement that sends all of its names to free slots.
+// The small buckets left at the end only need one free slot each, which keeps the search short even at one slot per name.
+bool CardIndex::TryBuildPerfectHash(const std::vector<uint64_t>& hashes, const std::vector<uint32_t>& slot_indices)
+{
+	const uint32_t num_names = m_numNames;
+	const uint32_t num_buckets = (num_names + NAMES_PER_PERFECT_BUCKET - 1) / NAMES_PER_PERFECT_BUCKET;
+	m_displacements.assign(num_buckets, 0);
+
+	// names grouped by bucket, counting sort so each bucket is a contiguous range
+	std::vector<uint32_t> bucket_start(num_buckets + 1, 0);
+	for (const uint64_t hash : hashes)
+	{
+		bucket_start[GetPerfectBucket(hash) + 1]++;
+	}
+	for (uint32_t bucket_idx = 0; bucket_idx < num_buckets; ++bucket_idx)
+	{
+		bucket_start[bucket_idx + 1] += bucket_start[bucket_idx];
+	}
+
+	std::vector<uint32_t> bucket_names(num_names);
+	std::vector<uint32_t> bucket_fill(bucket_start.begin(), bucket_start.end() - 1);
+	for (uint32_t name_idx = 0; name_idx < num_names; ++name_idx)
+	{
+		bucket_names[bucket_fill[GetPerfectBucket(hashes[name_idx])]++] = name_idx;
+	}
+
+	std::vector<uint32_t> bucket_order(num_buckets);
+	for (uint32_t bucket_idx = 0; bucket_idx < num_buckets; ++bucket_idx)
+	{
+		bucket_order[bucket_idx] = bucket_idx;
+	}
+	std::stable_sort(bucket_order.begin(), bucket_order.end(), [&bucket_start](const uint32_t lhs, const uint32_t rhs)
+	{
+		return bucket_start[lhs + 1] - bucket_start[lhs] > bucket_start[rhs + 1] - bucket_start[rhs];
+	});
+
+	std::vector<Slot> perfect_slots(num_names);
+	std::vector<bool> is_taken(num_names, false);
+	std::vector<uint32_t> bucket_slots;
+	const uint32_t max_tries = std::max(num_names * MAX_DISPLACEMENT_TRIES_PER_NAME, MIN_CARD_INDEX_SLOTS);
+
+	for (const uint32_t bucket_idx : bucket_order)
+	{
+		const uint32_t first_name = bucket_start[bucket_idx];
+		const uint32_t end_name = bucket_start[bucket_idx + 1];
+		if (first_name == end_name)
+		{
+			break;
+		}
+
+		bool is_placed = false;
+		for (uint32_t displacement = 0; displacement < max_tries && !is_placed; ++displacement)
+		{
+			bucket_slots.clear();
+			is_placed = true;
+
+			for (uint32_t bucket_name = first_name; bucket_name < end_name; ++bucket_name)
+			{
+				const uint32_t perfect_idx = GetPerfectSlot(hashes[bucket_names[bucket_name]], displacement);
+				if (is_taken[perfect_idx] || std::find(bucket_slots.begin(), bucket_slots.end(), perfect_idx) != bucket_slots.end())
+				{
+					is_placed = false;
+					break;
+				}
+
+				bucket_slots.push_back(perfect_idx);
+			}
+
+			if (is_placed)
+			{
+				m_displacements[bucket_idx] = displacement;
+			}
+		}
+
+		if (!is_placed)
+		{
+			m_displacements.clear();
+			return false;
+		}
+
+		for (uint32_t bucket_name = first_name; bucket_name < end_name; ++bucket_name)
+		{
+			const uint32_t perfect_idx = bucket_slots[bucket_name - first_name];
+			is_taken[perfect_idx] = true;
+			perfect_slots[perfect_idx] = m_slots[slot_indices[bucket_names[bucket_name]]];
+		}
+	}
+
+	m_perfectSlots.swap(perfect_slots);
+	std::vector<Slot>().swap(m_slots);
+	return true;
+}
+
+
+int CardIndex::Find(const CardIndexKind kind, const std::string_view name) const
+{
+	const FoldedText folded(name);
+	const Slot* slot = FindSlot(folded.GetView());
+	return slot ? slot->m_listIdx[kind] : -1;
+}
+
+
+bool CardIndex::FindCard(const std::string_view name, CardType& out_type, int& out_list_idx) const
+{
+	const FoldedText folded(name);
+	const Slot* slot = FindSlot(folded.GetView());
+	if (!slot)
+	{
+		return false;
+	}
+
+	for (int type_idx = 0; type_idx < NUM_CARD_TYPES; ++type_idx)
+	{
+		if (slot->m_listIdx[type_idx] >= 0)
+		{
+			out_type = static_cast<CardType>(type_idx);
+			out_list_idx = slot->m_listIdx[type_idx];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+bool CardIndex::HasPerfectHash() const
+{
+	return !m_perfectSlots.empty();
+}
+
+
+uint CardIndex::GetNumNames() const
+{
+	return m_numNames;
+}
+
+
+uint CardIndex::GetCapacity() const
+{
+	return static_cast<uint>(HasPerfectHash() ? m_perfectSlots.size() : m_slots.size());
+}
+
+
+size_t CardIndex::GetMemoryBytes() const
+{
+	return m_slots.capacity() * sizeof(Slot) + m_perfectSlots.capacity() * sizeof(Slot)
+		+ m_displacements.capacity() * sizeof(uint32_t) + m_keyData.capacity();
+}
+
+
+// FNV-1a over a name already folded. The last character barely reaches the high bits, so a final mix spreads it over the
+// whole hash: the probing table uses the low half, the perfect hash buckets on the high half
+STATIC uint64_t CardIndex::HashFolded(const std::string_view folded_name)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	for (const char c : folded_name)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+
+const CardIndex::Slot* CardIndex::FindSlot(const std::string_view folded_name) const
+{
+	const uint64_t hash = HashFolded(folded_name);
+
+	if (HasPerfectHash())
+	{
+		// every name lands on some slot, the key compare turns away the ones that are not in the set
+		const Slot& slot = m_perfectSlots[GetPerfectSlot(hash, m_displacements[GetPerfectBucket(hash)])];
+		return IsSlotKey(slot, folded_name, static_cast<uint32_t>(hash)) ? &slot : nullptr;
+	}
+
+	const Slot& slot = m_slots[ProbeSlot(folded_name, static_cast<uint32_t>(hash))];
+	return slot.m_keyOffset == EMPTY_SLOT ? nullptr : &slot;
+}
+
+
+// Index of the slot that holds the name, or of the empty slot it would go in
+uint32_t CardIndex::ProbeSlot(const std::string_view folded_name, const uint32_t hash) const
+{
+	const uint32_t mask = static_cast<uint32_t>(m_slots.size()) - 1;
+	uint32_t slot_idx = hash & mask;
+
+	while (m_slots[slot_idx].m_keyOffset != EMPTY_SLOT && !IsSlotKey(m_slots[slot_idx], folded_name, hash))
+	{
+		slot_idx = (slot_idx + 1) & mask;
+	}
+
+	return slot_idx;
+}
+
+
+bool CardIndex::IsSlotKey(const Slot& slot, const std::string_view folded_name, const uint32_t hash) const
+{
+	if (slot.m_hash != hash || slot.m_keyLength != folded_name.size())
+	{
+		return false;
+	}
+
+	return memcmp(m_keyData.data() + slot.m_keyOffset, folded_name.data(), folded_name.size()) == 0;
+}
+
+
+void CardIndex::Grow()
+{
+	std::vector<Slot> old_slots;
+	old_slots.swap(m_slots);
+	m_slots.assign(old_slots.size() * 2, Slot());
+
+	// every key is unique, so each one goes in the first empty slot from its home
+	const uint32_t mask = static_cast<uint32_t>(m_slots.size()) - 1;
+	for (const Slot& old_slot : old_slots)
+	{
+		if (old_slot.m_keyOffset == EMPTY_SLOT)
+		{
+			continue;
+		}
+
+		uint32_t slot_idx = old_slot.m_hash & mask;
+		while (m_slots[slot_idx].m_keyOffset != EMPTY_SLOT)
+		{
+			slot_idx = (slot_idx + 1) & mask;
+		}
+
+		m_slots[slot_idx] = old_slot;
+	}
+}
+
+
+// Back to the probing table so new names can go in, BuildPerfectHash makes a new one once they are all there
+void CardIndex::DropPerfectHash()
+{
+	uint32_t num_slots = MIN_CARD_INDEX_SLOTS;
+	while ((m_numNames + 1) * 2 > num_slots)
+	{
+		num_slots *= 2;
+	}
+
+	m_slots.assign(num_slots, Slot());
+
+	const uint32_t mask = num_slots - 1;
+	for (const Slot& perfect_slot : m_perfectSlots)
+	{
+		uint32_t slot_idx = perfect_slot.m_hash & mask;
+		while (m_slots[slot_idx].m_keyOffset != EMPTY_SLOT)
+		{
+			slot_idx = (slot_idx + 1) & mask;
+		}
+
+		m_slots[slot_idx] = perfect_slot;
+	}
+
+	m_perfectSlots.clear();
+	m_displacements.clear();
+	m_perfectSeed = 0;
+}
+
+
+// The high half of the seeded hash picks the bucket, scaled instead of taken modulo the count
+uint32_t CardIndex::GetPerfectBucket(const uint64_t hash) const
+{
+	return static_cast<uint32_t>((((hash ^ m_perfectSeed) >> 32) * m_displacements.size()) >> 32);
+}
+
+
+// The whole hash mixed with the displacement, a fresh spread of slots for every displacement tried
+uint32_t CardIndex::GetPerfectSlot(const uint64_t hash, const uint32_t displacement) const
+{
+	uint64_t mixed = hash ^ m_perfectSeed ^ (displacement * 0x9E3779B97F4A7C15ull);
+	mixed ^= mixed >> 33;
+	mixed *= 0xFF51AFD7ED558CCDull;
+	mixed ^= mixed >> 33;
+
+	const uint64_t num_names = m_numNames;
+	return static_cast<uint32_t>(((mixed & 0xFFFFFFFFull) * num_names) >> 32);
+}
+
+
+//------------------------------------------------------------
+// The old lookup, a folded copy of the name then one map per list
+static bool FindCardInMaps(const LookupTable* maps, const String& name, CardType& out_type, int& out_list_idx)
+{
+	const String name_to_lower = StringToLower(name);
+
+	for (int type_idx = 0; type_idx < NUM_CARD_TYPES; ++type_idx)
+	{
+		const LookupTable::const_iterator card_itr = maps[type_idx].find(name_to_lower);
+		if (card_itr != maps[type_idx].end())
+		{
+			out_type = static_cast<CardType>(type_idx);
+			out_list_idx = card_itr->second;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+// Node sizes are the usual red-black tree layout, three links and a color ahead of the value, plus the key's heap
+// buffer once it outgrows the small string
+static size_t GetMapMemoryBytes(const LookupTable* maps)
+{
+	constexpr size_t TREE_NODE_HEADER_BYTES = 4 * sizeof(void*);
+	const size_t small_string_capacity = String().capacity();
+
+	size_t num_bytes = 0;
+	for (int kind_idx = 0; kind_idx < NUM_CARD_INDEX_KINDS; ++kind_idx)
+	{
+		for (const LookupTable::value_type& entry : maps[kind_idx])
+		{
+			num_bytes += TREE_NODE_HEADER_BYTES + sizeof(LookupTable::value_type);
+			if (entry.first.capacity() > small_string_capacity)
+			{
+				num_bytes += entry.first.capacity() + 1;
+			}
+		}
+	}
+
+	return num_bytes;
+}
+
+
+// Hits plus a checksum of what they found, the same for every lookup being timed
+struct CardLookupResult
+{
+	uint	m_hits = 0;
+	int		m_checksum = 0;
+	double	m_seconds = 0.0;
+};
+
+
+template <typename FIND_CARD>
+static CardLookupResult TimeCardLookups(const StringList& queries, const uint num_queries, const FIND_CARD& find_card)
+{
+	CardLookupResult result;
+	const uint num_distinct_queries = static_cast<uint>(queries.size());
+
+	const double start = GetCurrentTimeSeconds();
+	for (uint query_idx = 0; query_idx < num_queries; ++query_idx)
+	{
+		CardType type = UNKNOWN_CARD_TYPE;
+		int list_idx = -1;
+		if (find_card(queries[query_idx % num_distinct_queries], type, list_idx))
+		{
+			result.m_hits++;
+			result.m_checksum += list_idx + type;
+		}
+	}
+	result.m_seconds = GetCurrentTimeSeconds() - start;
+
+	return result;
+}
+
+
+void BenchmarkCardIndex(const char* label, const std::vector<CardIndexName>& names, const uint num_queries)
+{
+	if (names.empty() || num_queries == 0)
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("%s: no names to look up", label));
+		return;
+	}
+
+	LookupTable maps[NUM_CARD_INDEX_KINDS];
+	CardIndex index;
+
+	double build_start = GetCurrentTimeSeconds();
+	for (const CardIndexName& entry : names)
+	{
+		maps[entry.m_kind].insert(LookupTable::value_type(StringToLower(entry.m_name), entry.m_listIdx));
+	}
+	const double map_build_seconds = GetCurrentTimeSeconds() - build_start;
+
+	build_start = GetCurrentTimeSeconds();
+	for (const CardIndexName& entry : names)
+	{
+		index.Insert(entry.m_kind, entry.m_name, entry.m_listIdx);
+	}
+	const double index_build_seconds = GetCurrentTimeSeconds() - build_start;
+
+	// a fixed mix of hits in typed case and misses, built before timing. The pool is small enough to stay in cache
+	// so the timings are of the lookups and not of streaming the queries in from memory
+	const uint num_distinct_queries = std::min(num_queries, CARD_INDEX_BENCHMARK_QUERY_POOL);
+	std::mt19937 rng(1);
+	StringList queries;
+	queries.reserve(num_distinct_queries);
+	for (uint query_idx = 0; query_idx < num_distinct_queries; ++query_idx)
+	{
+		String query = names[rng() % names.size()].m_name;
+		const uint variant = rng() % 4;
+
+		if (variant == 1)
+		{
+			for (char& c : query)
+			{
+				c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+			}
+		}
+		else if (variant == 2)
+		{
+			query += " not a card";
+		}
+
+		queries.push_back(query);
+	}
+
+	const CardLookupResult map_result = TimeCardLookups(queries, num_queries,
+		[&maps](const String& name, CardType& out_type, int& out_list_idx) { return FindCardInMaps(maps, name, out_type, out_list_idx); });
+	const auto find_in_index = [&index](const String& name, CardType& out_type, int& out_list_idx) { return index.FindCard(name, out_type, out_list_idx); };
+
+	const CardLookupResult probe_result = TimeCardLookups(queries, num_queries, find_in_index);
+	const size_t probe_bytes = index.GetMemoryBytes();
+
+	const double perfect_build_start = GetCurrentTimeSeconds();
+	const bool is_perfect = index.BuildPerfectHash();
+	const double perfect_build_seconds = GetCurrentTimeSeconds() - perfect_build_start;
+
+	const CardLookupResult perfect_result = TimeCardLookups(queries, num_queries, find_in_index);
+	const size_t perfect_bytes = index.GetMemoryBytes();
+
+	const bool results_match = is_perfect
+		&& map_result.m_hits == probe_result.m_hits && map_result.m_checksum == probe_result.m_checksum
+		&& map_result.m_hits == perfect_result.m_hits && map_result.m_checksum == perfect_result.m_checksum;
+	const Rgba result_color = results_match ? Rgba::GREEN : Rgba::RED;
+	const double num_names = static_cast<double>(names.size());
+
+	const auto print_result = [&](const char* name, const double build_seconds, const CardLookupResult& result, const size_t num_bytes)
+	{
+		g_theDevConsole->PrintString(result_color, Stringf("\t %-13s build %8.3f ms  lookup %8.3f ms  %7.1f ns/query  %6.1f bytes/name",
+			name, build_seconds * 1000.0, result.m_seconds * 1000.0, result.m_seconds * 1e9 / num_queries, num_bytes / num_names));
+	};
+
+	g_theDevConsole->PrintString(result_color, Stringf("%s: %u names, %u queries, %u hits%s", label,
+		static_cast<uint>(names.size()), num_queries, perfect_result.m_hits,
+		!is_perfect ? " (perfect hash FAILED)" : results_match ? "" : " (MISMATCH with the maps)"));
+	print_result("std::map x4", map_build_seconds, map_result, GetMapMemoryBytes(maps));
+	print_result("CardIndex", index_build_seconds, probe_result, probe_bytes);
+	print_result("perfect hash", perfect_build_seconds, perfect_result, perfect_bytes);
+}
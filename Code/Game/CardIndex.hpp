@@ -0,0 +1,92 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+// One open addressing table from every case folded card name and nickname to its index in each entity list.
+// A name can belong to a location, a character, an item and an incident at once, so every slot holds one index per
+// list and a single probe answers any of them. Names are folded with FoldCase, the same as the symbol table, so
+// a lookup folds its name once into a FoldedText and hashes and compares the folded bytes.
+//
+// Once a scenario is loaded its names are fixed, so BuildPerfectHash replaces the table with a minimal perfect hash
+// (CHD, hash and displace): one slot per name and one displacement per bucket of about four names. A lookup is one
+// hash, one displacement read and one key compare to reject names that are not in the set. Inserting a new name
+// goes back to the open addressing table until the next build.
+
+enum CardIndexKind
+{
+	CARD_INDEX_LOCATION = CARD_LOCATION,
+	CARD_INDEX_CHARACTER = CARD_CHARACTER,
+	CARD_INDEX_ITEM = CARD_ITEM,
+	CARD_INDEX_INCIDENT = NUM_CARD_TYPES,
+
+	NUM_CARD_INDEX_KINDS
+};
+
+
+// One name or nickname and where it points
+struct CardIndexName
+{
+	CardIndexKind	m_kind = CARD_INDEX_LOCATION;
+	String			m_name = "";
+	int				m_listIdx = -1;
+};
+
+
+//------------------------------------------------------------
+class CardIndex
+{
+public:
+	CardIndex();
+
+	void	Clear();
+	void	ClearKind(CardIndexKind kind);		// keeps the names, every other kind stays valid
+	bool	Insert(CardIndexKind kind, std::string_view name, int list_idx);	// false if the kind already has the name
+	bool	BuildPerfectHash();					// false if no displacement was found, lookups keep probing
+
+	int		Find(CardIndexKind kind, std::string_view name) const;				// -1 when missing
+	bool	FindCard(std::string_view name, CardType& out_type, int& out_list_idx) const;	// locations, then characters, then items
+
+	bool	HasPerfectHash() const;
+	uint	GetNumNames() const;
+	uint	GetCapacity() const;
+	size_t	GetMemoryBytes() const;
+
+	static uint64_t HashFolded(std::string_view folded_name);
+
+private:
+	static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+	struct Slot
+	{
+		uint32_t	m_hash = 0;
+		uint32_t	m_keyOffset = EMPTY_SLOT;
+		uint32_t	m_keyLength = 0;
+		int			m_listIdx[NUM_CARD_INDEX_KINDS] = { -1, -1, -1, -1 };
+	};
+
+	const Slot*	FindSlot(std::string_view folded_name) const;
+	uint32_t	ProbeSlot(std::string_view folded_name, uint32_t hash) const;
+	bool		IsSlotKey(const Slot& slot, std::string_view folded_name, uint32_t hash) const;
+	void		Grow();
+	bool		TryBuildPerfectHash(const std::vector<uint64_t>& hashes, const std::vector<uint32_t>& slot_indices);
+	void		DropPerfectHash();
+
+	uint32_t	GetPerfectBucket(uint64_t hash) const;
+	uint32_t	GetPerfectSlot(uint64_t hash, uint32_t displacement) const;
+
+private:
+	std::vector<Slot>	m_slots;			// size is always a power of two, empty while the perfect hash is built
+	std::vector<Slot>	m_perfectSlots;		// exactly one per name
+	std::vector<uint32_t> m_displacements;	// one per perfect hash bucket
+	uint64_t			m_perfectSeed = 0;
+	String				m_keyData;			// every folded key back to back
+	uint				m_numNames = 0;
+};
+
+
+//------------------------------------------------------------
+// Times CardIndex, before and after BuildPerfectHash, against the four std::map lookups it replaced, all built from
+// the same names
+void BenchmarkCardIndex(const char* label, const std::vector<CardIndexName>& names, uint num_queries);
@@ -0,0 +1,129 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+#include <algorithm>
+
+// The states a card can be in, filled once while the card loads and never changed after. The current state is an
+// index into the table, so changing state is one write and reading it is a reference, nothing is copied.
+// State names are looked up through a small table of name ids sorted once as the states are added.
+
+template <typename STATE>
+class CardStateTable
+{
+public:
+	void	Clear();
+	void	Reserve(uint num_states);
+	void	Add(const STATE& state);		// a name added twice keeps the first state for lookups
+
+	int				FindStateIdx(SymbolId state_id) const;		// -1 when the card has no such state
+	bool			HasState(SymbolId state_id) const;
+	void			SetCurrentIdx(int state_idx);
+	int				GetCurrentIdx() const;
+	const STATE&	GetCurrent() const;							// a default state until one is set
+
+	uint			GetNumStates() const;
+	const STATE&	GetState(uint state_idx) const;
+
+private:
+	struct StateKey
+	{
+		SymbolId	m_nameId = SYMBOL_EMPTY;
+		int			m_stateIdx = -1;
+	};
+
+	inline static const STATE s_noState = STATE();
+
+	std::vector<STATE>		m_states;
+	std::vector<StateKey>	m_keys;			// sorted by name id
+	int						m_currentIdx = -1;
+};
+
+
+//------------------------------------------------------------
+template <typename STATE>
+void CardStateTable<STATE>::Clear()
+{
+	m_states.clear();
+	m_keys.clear();
+	m_currentIdx = -1;
+}
+
+
+template <typename STATE>
+void CardStateTable<STATE>::Reserve(const uint num_states)
+{
+	m_states.reserve(num_states);
+	m_keys.reserve(num_states);
+}
+
+
+template <typename STATE>
+void CardStateTable<STATE>::Add(const STATE& state)
+{
+	const int state_idx = static_cast<int>(m_states.size());
+	m_states.push_back(state);
+
+	const typename std::vector<StateKey>::iterator key_itr = std::lower_bound(m_keys.begin(), m_keys.end(), state.m_nameId,
+		[](const StateKey& key, const SymbolId name_id) { return key.m_nameId < name_id; });
+
+	if (key_itr == m_keys.end() || key_itr->m_nameId != state.m_nameId)
+	{
+		m_keys.insert(key_itr, { state.m_nameId, state_idx });
+	}
+}
+
+
+template <typename STATE>
+int CardStateTable<STATE>::FindStateIdx(const SymbolId state_id) const
+{
+	const typename std::vector<StateKey>::const_iterator key_itr = std::lower_bound(m_keys.begin(), m_keys.end(), state_id,
+		[](const StateKey& key, const SymbolId name_id) { return key.m_nameId < name_id; });
+
+	return (key_itr != m_keys.end() && key_itr->m_nameId == state_id) ? key_itr->m_stateIdx : -1;
+}
+
+
+template <typename STATE>
+bool CardStateTable<STATE>::HasState(const SymbolId state_id) const
+{
+	return FindStateIdx(state_id) >= 0;
+}
+
+
+template <typename STATE>
+void CardStateTable<STATE>::SetCurrentIdx(const int state_idx)
+{
+	ASSERT_OR_DIE(state_idx >= 0 && state_idx < static_cast<int>(m_states.size()), Stringf("State index %i is out of range", state_idx));
+	m_currentIdx = state_idx;
+}
+
+
+template <typename STATE>
+int CardStateTable<STATE>::GetCurrentIdx() const
+{
+	return m_currentIdx;
+}
+
+
+template <typename STATE>
+const STATE& CardStateTable<STATE>::GetCurrent() const
+{
+	return m_currentIdx >= 0 ? m_states[m_currentIdx] : s_noState;
+}
+
+
+template <typename STATE>
+uint CardStateTable<STATE>::GetNumStates() const
+{
+	return static_cast<uint>(m_states.size());
+}
+
+
+template <typename STATE>
+const STATE& CardStateTable<STATE>::GetState(const uint state_idx) const
+{
+	return m_states[state_idx];
+}
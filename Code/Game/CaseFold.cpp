@@ -0,0 +1,284 @@
+#include "Game/CaseFold.hpp"
+
+#include <cstring>
+
+// x64 always has SSE2, AVX2 is checked for once at startup so the build does not need /arch:AVX2
+#if defined(_M_X64) || defined(__x86_64__)
+	#include <immintrin.h>
+	#define CASE_FOLD_SSE2
+	#define CASE_FOLD_AVX2
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define CASE_FOLD_AVX2_TARGET
+	#else
+		#define CASE_FOLD_AVX2_TARGET __attribute__((target("avx2")))
+	#endif
+#elif defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define CASE_FOLD_SSE2
+#endif
+
+//------------------------------------------------------------
+static bool IsContinuationByte(const unsigned char byte)
+{
+	return (byte & 0xC0) == 0x80;
+}
+
+
+#if defined(CASE_FOLD_AVX2)
+static bool HasAvx2()
+{
+#if defined(__AVX2__)
+	return true;
+#elif defined(_MSC_VER)
+	int cpu_info[4] = {};
+	__cpuid(cpu_info, 0);
+	if (cpu_info[0] < 7)
+	{
+		return false;
+	}
+
+	// the OS has to save the ymm registers too
+	__cpuid(cpu_info, 1);
+	const bool has_os_avx = (cpu_info[2] & (1 << 27)) != 0 && (cpu_info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+	__cpuidex(cpu_info, 7, 0);
+	return has_os_avx && (cpu_info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+
+static const bool s_hasAvx2 = HasAvx2();
+
+
+// Whole 32 byte blocks up to the first one with a byte that is not ASCII, FoldAsciiRun does the rest
+CASE_FOLD_AVX2_TARGET static size_t FoldAsciiRunAvx2(const char* src, char* dst, const size_t length)
+{
+	const __m256i before_upper_32 = _mm256_set1_epi8('A' - 1);
+	const __m256i after_upper_32 = _mm256_set1_epi8('Z' + 1);
+	const __m256i case_bit_32 = _mm256_set1_epi8(0x20);
+
+	size_t byte_idx = 0;
+	for (; byte_idx + 32 <= length; byte_idx += 32)
+	{
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + byte_idx));
+		if (_mm256_movemask_epi8(bytes) != 0)
+		{
+			break;
+		}
+
+		// bytes are signed here, so ones past 0x7F would fail the first compare anyway
+		const __m256i is_upper = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, before_upper_32), _mm256_cmpgt_epi8(after_upper_32, bytes));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + byte_idx), _mm256_or_si256(bytes, _mm256_and_si256(is_upper, case_bit_32)));
+	}
+
+	return byte_idx;
+}
+#endif
+
+
+// Folds from src into dst until the first byte that is not ASCII, src and dst may be the same buffer
+static size_t FoldAsciiRun(const char* src, char* dst, const size_t length)
+{
+	size_t byte_idx = 0;
+
+#if defined(CASE_FOLD_AVX2)
+	if (s_hasAvx2)
+	{
+		byte_idx = FoldAsciiRunAvx2(src, dst, length);
+	}
+#endif
+
+#if defined(CASE_FOLD_SSE2)
+	const __m128i before_upper = _mm_set1_epi8('A' - 1);
+	const __m128i after_upper = _mm_set1_epi8('Z' + 1);
+	const __m128i case_bit = _mm_set1_epi8(0x20);
+
+	for (; byte_idx + 16 <= length; byte_idx += 16)
+	{
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + byte_idx));
+		if (_mm_movemask_epi8(bytes) != 0)
+		{
+			break;
+		}
+
+		const __m128i is_upper = _mm_and_si128(_mm_cmpgt_epi8(bytes, before_upper), _mm_cmplt_epi8(bytes, after_upper));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + byte_idx), _mm_or_si128(bytes, _mm_and_si128(is_upper, case_bit)));
+	}
+#endif
+
+	for (; byte_idx < length; ++byte_idx)
+	{
+		const unsigned char byte = static_cast<unsigned char>(src[byte_idx]);
+		if (byte >= 0x80)
+		{
+			break;
+		}
+
+		dst[byte_idx] = static_cast<char>(static_cast<unsigned>(byte - 'A') < 26u ? byte + ('a' - 'A') : byte);
+	}
+
+	return byte_idx;
+}
+
+
+// Folds the one sequence at src, which starts with a byte past 0x7F, and returns how many bytes it took
+static size_t FoldUtf8Sequence(const char* src, char* dst, const size_t length)
+{
+	const unsigned char lead = static_cast<unsigned char>(src[0]);
+
+	if ((lead & 0xE0) == 0xC0 && length >= 2 && IsContinuationByte(static_cast<unsigned char>(src[1])))
+	{
+		const uint32_t code_point = ((lead & 0x1Fu) << 6) | (static_cast<unsigned char>(src[1]) & 0x3Fu);
+		const uint32_t folded = FoldCodePoint(code_point);
+
+		// every capital handled folds to another two byte character
+		dst[0] = static_cast<char>(0xC0 | (folded >> 6));
+		dst[1] = static_cast<char>(0x80 | (folded & 0x3F));
+		return 2;
+	}
+
+	size_t sequence_length = 1;
+	if ((lead & 0xF0) == 0xE0)
+	{
+		sequence_length = 3;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		sequence_length = 4;
+	}
+
+	// nothing longer than two bytes is folded, and a broken sequence is copied a byte at a time
+	size_t num_bytes = 1;
+	while (num_bytes < sequence_length && num_bytes < length && IsContinuationByte(static_cast<unsigned char>(src[num_bytes])))
+	{
+		num_bytes++;
+	}
+	if (num_bytes < sequence_length)
+	{
+		num_bytes = 1;
+	}
+
+	if (dst != src)
+	{
+		memcpy(dst, src, num_bytes);
+	}
+	return num_bytes;
+}
+
+
+static void FoldCaseBytes(const char* src, char* dst, const size_t length)
+{
+	size_t byte_idx = 0;
+	while (byte_idx < length)
+	{
+		byte_idx += FoldAsciiRun(src + byte_idx, dst + byte_idx, length - byte_idx);
+		if (byte_idx < length)
+		{
+			byte_idx += FoldUtf8Sequence(src + byte_idx, dst + byte_idx, length - byte_idx);
+		}
+	}
+}
+
+
+//------------------------------------------------------------
+void FoldCaseInPlace(char* text, const size_t length)
+{
+	FoldCaseBytes(text, text, length);
+}
+
+
+void FoldCaseInPlace(String& text)
+{
+	FoldCaseBytes(text.data(), text.data(), text.size());
+}
+
+
+void FoldCase(const std::string_view text, String& out_folded)
+{
+	out_folded.resize(text.size());
+	FoldCaseBytes(text.data(), out_folded.data(), text.size());
+}
+
+
+bool IsFoldedEqual(const std::string_view text, const std::string_view folded)
+{
+	if (text.size() != folded.size())
+	{
+		return false;
+	}
+
+	const FoldedText folded_text(text);
+	return folded_text.GetView() == folded;
+}
+
+
+// Simple one to one folds only, so the capital dotted I and the long s, which fold to a different length, stay as they are
+uint32_t FoldCodePoint(const uint32_t code_point)
+{
+	if (code_point < 0x80)
+	{
+		return (code_point - 'A') < 26u ? code_point + ('a' - 'A') : code_point;
+	}
+
+	// Latin-1 Supplement, without the multiplication sign
+	if (code_point >= 0xC0 && code_point <= 0xDE && code_point != 0xD7)
+	{
+		return code_point + 0x20;
+	}
+
+	// Latin Extended-A alternates capital and small, the capital on the even code point in two runs and the odd in two
+	if ((code_point >= 0x100 && code_point <= 0x137 && code_point != 0x130) || (code_point >= 0x14A && code_point <= 0x177))
+	{
+		return code_point | 1u;
+	}
+	if ((code_point >= 0x139 && code_point <= 0x148) || (code_point >= 0x179 && code_point <= 0x17E))
+	{
+		return (code_point & 1u) != 0 ? code_point + 1 : code_point;
+	}
+	if (code_point == 0x178)
+	{
+		return 0xFF;
+	}
+
+	// Greek, without the gap where a final sigma capital would be
+	if (code_point >= 0x391 && code_point <= 0x3AB && code_point != 0x3A2)
+	{
+		return code_point + 0x20;
+	}
+
+	// Cyrillic
+	if (code_point >= 0x410 && code_point <= 0x42F)
+	{
+		return code_point + 0x20;
+	}
+	if (code_point >= 0x400 && code_point <= 0x40F)
+	{
+		return code_point + 0x50;
+	}
+
+	return code_point;
+}
+
+
+//------------------------------------------------------------
+FoldedText::FoldedText(const std::string_view text)
+{
+	char* folded_bytes = m_stackBytes;
+	if (text.size() > FOLDED_TEXT_STACK_BYTES)
+	{
+		m_heapBytes.resize(text.size());
+		folded_bytes = m_heapBytes.data();
+	}
+
+	FoldCaseBytes(text.data(), folded_bytes, text.size());
+	m_view = std::string_view(folded_bytes, text.size());
+}
+
+
+std::string_view FoldedText::GetView() const
+{
+	return m_view;
+}
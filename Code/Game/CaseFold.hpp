@@ -0,0 +1,38 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+// Case folding that never allocates past the caller's buffer. ASCII runs are folded 16 or 32 bytes at a time with
+// SSE2/AVX2 where the compiler targets them, anything else goes through a UTF-8 decoder that folds Latin-1, Latin
+// Extended-A, Greek and Cyrillic capitals. Every fold keeps the encoded length, so folding in place is always safe.
+// Bytes that are not valid UTF-8 and characters outside those ranges are left as they are.
+// Everything that compares names folds through here, so a name matches the same way wherever it is looked up.
+
+constexpr size_t FOLDED_TEXT_STACK_BYTES = 256;
+
+void	FoldCaseInPlace(char* text, size_t length);
+void	FoldCaseInPlace(String& text);
+void	FoldCase(std::string_view text, String& out_folded);				// reuses out_folded's capacity
+bool	IsFoldedEqual(std::string_view text, std::string_view folded);		// folded is already lower case, a literal usually
+
+uint32_t	FoldCodePoint(uint32_t code_point);
+
+
+//------------------------------------------------------------
+// A folded copy of some text for the length of a call, on the stack unless it is longer than FOLDED_TEXT_STACK_BYTES
+class FoldedText
+{
+public:
+	explicit FoldedText(std::string_view text);
+	FoldedText(const FoldedText&) = delete;
+	FoldedText& operator=(const FoldedText&) = delete;
+
+	std::string_view	GetView() const;
+
+private:
+	char				m_stackBytes[FOLDED_TEXT_STACK_BYTES];
+	String				m_heapBytes;
+	std::string_view	m_view;
+};
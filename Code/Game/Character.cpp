@@ -3,6 +3,8 @@
 #include "Game/Location.hpp"
 #include "Game/Item.hpp"
 #include "Game/Action.hpp"
+#include "Game/ScenarioImage.hpp"
+#include "Game/CaseFold.hpp"
 
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -17,17 +19,9 @@ CharacterDialogue::CharacterDialogue()
 }
 
 
+// the actions belong to the scenario arena
 CharacterDialogue::~CharacterDialogue()
 {
-	uint num_actions = static_cast<uint>(m_actions.size());
-	for (uint action_idx = 0; action_idx < num_actions; ++action_idx)
-	{
-		if (m_actions[action_idx] != nullptr)
-		{
-			delete m_actions[action_idx];
-			m_actions[action_idx] = nullptr;
-		}
-	}
 }
 
 
@@ -40,55 +34,38 @@ Character::Character(Scenario* the_setup, const String& name, const StringList&
 
 Character::Character(Scenario* the_setup, const XmlElement* element) : Card(the_setup, CARD_CHARACTER)
 {
-	String current_state = "";
+	ImportFromXml(element);
+}
+
+
+void Character::ImportFromXml(const XmlElement* element)
+{
+	SymbolId current_state = SYMBOL_EMPTY;
 
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "name")
 		{
 			m_name = attribute->Value();
+			m_nameId = m_theScenario->InternName(m_name);
 		}
 		else if (attribute_name == "startingstate")
 		{
-			current_state = StringToLower(String(attribute->Value()));
+			current_state = m_theScenario->InternName(attribute->Value());
 		}
 		else if (attribute_name == "startloc")
 		{
-			if (strcmp(attribute->Value(), "NONE") == 0)
-			{
-				continue;
-			}
-
-			LookupItr loc_itr;
-			m_theScenario->IsLocationInLookupTable(loc_itr, attribute->Value());
-			Location* loc = m_theScenario->GetLocationFromList(loc_itr->second);
-			loc->AddCharacterToLocation(this);
+			m_startLocation = attribute->Value();
 		}
 		else if (attribute_name == "imagedir")
 		{
-			String file_name = m_name + ".mat";
-			m_material = g_theRenderer->CreateOrGetMaterial(file_name, false);
-			m_material->SetShader("default_lit.hlsl");
-			m_material->m_shader->SetDepth(COMPARE_LESS_EQUAL, true);
-
-			std::string texture_src = attribute->Value();
-			TextureView* texture(reinterpret_cast<TextureView*>(g_theRenderer->CreateOrGetTextureView2D(texture_src)));
-			m_material->SetDiffuseMap(texture);
-
-			CPUMesh quad_mesh;
-			CpuMeshAddQuad(&quad_mesh,
-				AABB2(
-					-(CHAR_CARD_ASPECT_RATIO * CHAR_CARD_HEIGHT),
-					-CHAR_CARD_HEIGHT,
-					CHAR_CARD_ASPECT_RATIO * CHAR_CARD_HEIGHT,
-					CHAR_CARD_HEIGHT));
-			m_mesh = new GPUMesh(g_theRenderer);
-			m_mesh->CreateFromCPUMesh<Vertex_Lit>(quad_mesh); // we won't be updated this;
+			LoadCardImage(attribute->Value());
 		}
 		else
 		{
@@ -97,12 +74,13 @@ Character::Character(Scenario* the_setup, const XmlElement* element) : Card(the_
 	}
 
 
+	String element_name;
 	for (const XmlElement* child_element = element->FirstChildElement();
 		child_element;
 		child_element = child_element->NextSiblingElement()
 		)
 	{
-		String element_name = StringToLower(child_element->Name());
+		FoldCase(child_element->Name(), element_name);
 
 		if (element_name == "nicknames")
 		{
@@ -136,26 +114,82 @@ Character::Character(Scenario* the_setup, const XmlElement* element) : Card(the_
 }
 
 
+Character::Character(Scenario* the_setup, ScenarioImageReader& reader) : Card(the_setup, CARD_CHARACTER)
+{
+	ReadCardFromImage(reader);
+
+	const String image_dir = m_imageDir;
+	if (!image_dir.empty())
+	{
+		LoadCardImage(image_dir);
+	}
+
+	m_startLocation = reader.ReadString();
+
+	const SymbolId current_state = m_theScenario->InternName(reader.ReadString());
+
+	const uint num_states = reader.ReadU32();
+	m_states.Reserve(num_states);
+	for (uint state_idx = 0; state_idx < num_states; ++state_idx)
+	{
+		CharacterState new_state;
+		new_state.m_nameId = m_theScenario->InternName(reader.ReadString());
+		new_state.m_addGameTime = reader.ReadBool();
+		new_state.m_contextMode = static_cast<ContextMode>(reader.ReadI32());
+
+		m_states.Add(new_state);
+	}
+
+	ReadDialogueFromImage(reader, m_dialogueAboutCharacter, CARD_CHARACTER);
+	ReadDialogueFromImage(reader, m_dialogueAboutItem, CARD_ITEM);
+
+	SetState(current_state);
+}
+
+
+// Rebuilds the character from its edited xml element, keeping the current state and discovery
+void Character::ReloadFromXml(const XmlElement* element)
+{
+	const SymbolId live_state = GetCharacterState().m_nameId;
+
+	RemoveFromStartLocation();
+	ClearCardData();
+	m_states.Clear();
+	m_dialogueAboutCharacter.clear();
+	m_dialogueAboutItem.clear();
+
+	ImportFromXml(element);
+	PlaceInStartLocation(m_theScenario->GetCharacterListIdx(this));
+
+	if (HasState(live_state))
+	{
+		SetState(live_state);
+	}
+}
+
+
 void Character::ImportCharacterStatesFromXml(const XmlElement* element)
 {
+	String element_name;
 	for (const XmlElement* child_element = element->FirstChildElement();
 		child_element;
 		child_element = child_element->NextSiblingElement()
 		)
 	{
-		String element_name(StringToLower(child_element->Name()));
+		FoldCase(child_element->Name(), element_name);
 		ASSERT_OR_DIE(element_name == "state", Stringf("Could not get State for Card %s", m_name.c_str()));
 
 		CharacterState new_state;
+		String atr_name;
 		for (const XmlAttribute* attribute = child_element->FirstAttribute();
 			attribute;
 			attribute = attribute->Next())
 		{
-			String atr_name(StringToLower(attribute->Name()));
+			FoldCase(attribute->Name(), atr_name);
 
 			if (atr_name == "name")
 			{
-				new_state.m_name = StringToLower(attribute->Value());
+				new_state.m_nameId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "addgametime")
 			{
@@ -177,7 +211,7 @@ void Character::ImportCharacterStatesFromXml(const XmlElement* element)
 			}
 		}
 
-		m_states.push_back(new_state);
+		m_states.Add(new_state);
 	}
 }
 
@@ -208,12 +242,13 @@ void Character::ImportCharacterDialogueFromXml(const XmlElement* element, CardTy
 	}
 	}
 
+	String element_name;
 	for (const XmlElement* child_element = element->FirstChildElement();
 		child_element;
 		child_element = child_element->NextSiblingElement()
 		)
 	{
-		String element_name(StringToLower(child_element->Name()));
+		FoldCase(child_element->Name(), element_name);
 		ASSERT_OR_DIE(element_name == "scan", Stringf("Could not get character dialogue for Card %s", m_name.c_str()));
 
 		CharacterDialogue* new_dialog = nullptr;
@@ -236,23 +271,24 @@ void Character::ImportCharacterDialogueFromXml(const XmlElement* element, CardTy
 		}
 
 		new_dialog->m_cardType = type;
+		String atr_name;
 		for (const XmlAttribute* attribute = child_element->FirstAttribute();
 			attribute;
 			attribute = attribute->Next())
 		{
-			String atr_name(StringToLower(attribute->Name()));
+			FoldCase(attribute->Name(), atr_name);
 
 			if (atr_name == "state")
 			{
-				new_dialog->m_characterState = StringToLower(attribute->Value());
+				new_dialog->m_characterStateId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "loc")
 			{
-				new_dialog->m_locationName = StringToLower(attribute->Value());
+				new_dialog->m_locationNameId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "locstate")
 			{
-				new_dialog->m_locationState = StringToLower(attribute->Value());
+				new_dialog->m_locationStateId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "line")
 			{
@@ -266,11 +302,11 @@ void Character::ImportCharacterDialogueFromXml(const XmlElement* element, CardTy
 					{
 						if (atr_name == "char")
 						{
-							new_dialog->m_cardName = StringToLower(attribute->Value());
+							new_dialog->m_cardNameId = m_theScenario->InternName(attribute->Value());
 						}
 						else if (atr_name == "charstate")
 						{
-							new_dialog->m_cardState = StringToLower(attribute->Value());
+							new_dialog->m_cardStateId = m_theScenario->InternName(attribute->Value());
 						}
 
 						break;
@@ -279,11 +315,11 @@ void Character::ImportCharacterDialogueFromXml(const XmlElement* element, CardTy
 					{
 						if (atr_name == "item")
 						{
-							new_dialog->m_cardName = StringToLower(attribute->Value());
+							new_dialog->m_cardNameId = m_theScenario->InternName(attribute->Value());
 						}
 						else if (atr_name == "itemstate")
 						{
-							new_dialog->m_cardState = StringToLower(attribute->Value());
+							new_dialog->m_cardStateId = m_theScenario->InternName(attribute->Value());
 						}
 					}
 				}
@@ -295,12 +331,12 @@ void Character::ImportCharacterDialogueFromXml(const XmlElement* element, CardTy
 			grand_child_element = grand_child_element->NextSiblingElement()
 			)
 		{
-			element_name = StringToLower(grand_child_element->Name());
+			FoldCase(grand_child_element->Name(), element_name);
 
 			if (element_name == "setcardstate")
 			{
 				new_dialog->m_actions.push_back(
-					new ActionChangeCardState(m_theScenario, grand_child_element)
+					m_theScenario->GetArena().Create<ActionChangeCardState>(m_theScenario, grand_child_element)
 				);
 			}
 		}
@@ -311,16 +347,16 @@ void Character::ImportCharacterDialogueFromXml(const XmlElement* element, CardTy
 
 const CharacterState& Character::GetCharacterState() const
 {
-	return m_currentState;
+	return m_states.GetCurrent();
 }
 
 
 bool Character::AskAboutCharacter(String& out, const Location* location, const Character* character)
 {
-	String loc_name = location->GetName();
-	String loc_state = location->GetLocationState().m_name;
-	String char_name = StringToLower(character->GetName());
-	String char_state = StringToLower(character->GetCharacterState().m_name);
+	const SymbolId loc_name = location->GetNameId();
+	const SymbolId loc_state = location->GetLocationState().m_nameId;
+	const SymbolId char_name = character->GetNameId();
+	const SymbolId char_state = character->GetCharacterState().m_nameId;
 	
 	const int num_dialogue = static_cast<int>(m_dialogueAboutCharacter.size());
 	std::vector<int> dialogue_ranking;
@@ -335,50 +371,50 @@ bool Character::AskAboutCharacter(String& out, const Location* location, const C
 		int score = 0;
 
 		//testing character state
-		if (test_state.m_characterState == "*")
+		if (test_state.m_characterStateId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_characterState == m_currentState.m_name)
+		else if (test_state.m_characterStateId == GetCharacterState().m_nameId)
 		{
 			score += 3;
 		}
 
 		//testing location name
-		if (test_state.m_locationName == "*")
+		if (test_state.m_locationNameId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_locationName == loc_name)
+		else if (test_state.m_locationNameId == loc_name)
 		{
 			score += 3;
 
 			//testing location name
-			if (test_state.m_locationState == "*")
+			if (test_state.m_locationStateId == SYMBOL_WILDCARD)
 			{
 				score += 1;
 			}
-			else if (test_state.m_locationState == loc_state)
+			else if (test_state.m_locationStateId == loc_state)
 			{
 				score += 5;
 			}
 		}
 
 		//testing character name
-		if (test_state.m_cardName == "*")
+		if (test_state.m_cardNameId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_cardName == char_name)
+		else if (test_state.m_cardNameId == char_name)
 		{
 			score += 3;
 
 			//testing character state
-			if (test_state.m_cardState == "*")
+			if (test_state.m_cardStateId == SYMBOL_WILDCARD)
 			{
 				score += 1;
 			}
-			else if (test_state.m_cardState == char_state)
+			else if (test_state.m_cardStateId == char_state)
 			{
 				score += 5;
 			}
@@ -413,10 +449,10 @@ bool Character::AskAboutCharacter(String& out, const Location* location, const C
 
 bool Character::AskAboutItem(String& out, const Location* location, const Item* item)
 {
-	String loc_name = location->GetName();
-	String loc_state = location->GetLocationState().m_name;
-	String item_name = StringToLower(item->GetName());
-	String item_state = StringToLower(item->GetItemState().m_name);
+	const SymbolId loc_name = location->GetNameId();
+	const SymbolId loc_state = location->GetLocationState().m_nameId;
+	const SymbolId item_name = item->GetNameId();
+	const SymbolId item_state = item->GetItemState().m_nameId;
 
 	const int num_dialogue = static_cast<int>(m_dialogueAboutItem.size());
 	std::vector<int> dialogue_ranking;
@@ -431,50 +467,50 @@ bool Character::AskAboutItem(String& out, const Location* location, const Item*
 		int score = 0;
 
 		//testing character state
-		if (test_state.m_characterState == "*")
+		if (test_state.m_characterStateId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_characterState == m_currentState.m_name)
+		else if (test_state.m_characterStateId == GetCharacterState().m_nameId)
 		{
 			score += 3;
 		}
 
 		//testing location name
-		if (test_state.m_locationName == "*")
+		if (test_state.m_locationNameId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_locationName == loc_name)
+		else if (test_state.m_locationNameId == loc_name)
 		{
 			score += 3;
 
 			//testing location name
-			if (test_state.m_locationState == "*")
+			if (test_state.m_locationStateId == SYMBOL_WILDCARD)
 			{
 				score += 1;
 			}
-			else if (test_state.m_locationState == loc_state)
+			else if (test_state.m_locationStateId == loc_state)
 			{
 				score += 5;
 			}
 		}
 
 		//testing character name
-		if (test_state.m_cardName == "*")
+		if (test_state.m_cardNameId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_cardName == item_name)
+		else if (test_state.m_cardNameId == item_name)
 		{
 			score += 3;
 
 			//testing character state
-			if (test_state.m_cardState == "*")
+			if (test_state.m_cardStateId == SYMBOL_WILDCARD)
 			{
 				score += 1;
 			}
-			else if (test_state.m_cardState == item_state)
+			else if (test_state.m_cardStateId == item_state)
 			{
 				score += 5;
 			}
@@ -513,7 +549,11 @@ String Character::GetAsString() const
 	const uint num_nicknames = static_cast<uint>(m_nickNames.size());
 	for (uint nn_idx = 0; nn_idx < num_nicknames; ++nn_idx)
 	{
-		m_line += nn_idx != num_nicknames - 1 ? (m_nickNames[nn_idx] + ", ") : (m_nickNames[nn_idx]);
+		m_line += m_nickNames[nn_idx];
+		if (nn_idx != num_nicknames - 1)
+		{
+			m_line += ", ";
+		}
 	}
 	m_line += ")";
 
@@ -521,17 +561,181 @@ String Character::GetAsString() const
 }
 
 
+bool Character::HasState(const String& state_name) const
+{
+	return HasState(m_theScenario->GetSymbolTable().Find(state_name));
+}
+
+
+bool Character::HasState(const SymbolId state_id) const
+{
+	return m_states.HasState(state_id);
+}
+
+
+int Character::FindStateIdx(const SymbolId state_id) const
+{
+	return m_states.FindStateIdx(state_id);
+}
+
+
 void Character::SetState(const String& starting_state)
 {
-	int num_states = static_cast<int>(m_states.size());
-	for (int state_idx = 0; state_idx < num_states; ++state_idx)
+	SetState(m_theScenario->GetSymbolTable().Find(starting_state));
+}
+
+
+void Character::SetState(const SymbolId state_id)
+{
+	const int state_idx = m_states.FindStateIdx(state_id);
+	if (state_idx < 0)
 	{
-		if (StringToLower(m_states[state_idx].m_name) == starting_state)
+		ERROR_AND_DIE(Stringf("StartingState for Card '%s' was not found in the list of states", m_name.c_str()));
+	}
+
+	m_states.SetCurrentIdx(state_idx);
+}
+
+
+// Only called while playing, loading sets the state by name and the compile after it tests every incident anyway
+void Character::SetStateIdx(const int state_idx)
+{
+	m_states.SetCurrentIdx(state_idx);
+	m_theScenario->OnCardStateChanged(CARD_CHARACTER, m_theScenario->GetCharacterListIdx(this));
+}
+
+
+void Character::WriteToImage(ScenarioImageWriter& writer) const
+{
+	WriteCardToImage(writer);
+	writer.WriteString(m_startLocation);
+	writer.WriteString(m_theScenario->GetSymbolName(GetCharacterState().m_nameId));
+
+	const uint num_states = m_states.GetNumStates();
+	writer.WriteU32(num_states);
+	for (uint state_idx = 0; state_idx < num_states; ++state_idx)
+	{
+		const CharacterState& state = m_states.GetState(state_idx);
+		writer.WriteString(m_theScenario->GetSymbolName(state.m_nameId));
+		writer.WriteBool(state.m_addGameTime);
+		writer.WriteI32(state.m_contextMode);
+	}
+
+	WriteDialogueToImage(writer, m_dialogueAboutCharacter);
+	WriteDialogueToImage(writer, m_dialogueAboutItem);
+}
+
+
+void Character::LoadCardImage(const String& image_dir)
+{
+	SetCardImage(image_dir, AABB2(-(CHAR_CARD_ASPECT_RATIO * CHAR_CARD_HEIGHT), -CHAR_CARD_HEIGHT, CHAR_CARD_ASPECT_RATIO * CHAR_CARD_HEIGHT, CHAR_CARD_HEIGHT));
+}
+
+
+void Character::PlaceInStartLocation(const int char_idx)
+{
+	if (m_startLocation == "NONE")
+	{
+		return;
+	}
+
+	int loc_idx = -1;
+	m_theScenario->IsLocationInLookupTable(loc_idx, m_startLocation);
+	Location* loc = m_theScenario->GetLocationFromList(loc_idx);
+	loc->AddCharacterToLocation(char_idx);
+}
+
+
+void Character::RemoveFromStartLocation()
+{
+	if (m_startLocation == "NONE")
+	{
+		return;
+	}
+
+	int loc_idx = -1;
+	if (m_theScenario->IsLocationInLookupTable(loc_idx, m_startLocation))
+	{
+		Location* loc = m_theScenario->GetLocationFromList(loc_idx);
+		loc->RemoveCharacterFromLocation(this);
+	}
+}
+
+
+void Character::WriteDialogueToImage(ScenarioImageWriter& writer, const CharacterDialogueList& dialogue) const
+{
+	const uint num_dialogue = static_cast<uint>(dialogue.size());
+	writer.WriteU32(num_dialogue);
+
+	for (uint dialogue_idx = 0; dialogue_idx < num_dialogue; ++dialogue_idx)
+	{
+		const CharacterDialogue& line = dialogue[dialogue_idx];
+		writer.WriteString(m_theScenario->GetSymbolName(line.m_characterStateId));
+		writer.WriteString(m_theScenario->GetSymbolName(line.m_locationNameId));
+		writer.WriteString(m_theScenario->GetSymbolName(line.m_locationStateId));
+		writer.WriteString(m_theScenario->GetSymbolName(line.m_cardNameId));
+		writer.WriteString(m_theScenario->GetSymbolName(line.m_cardStateId));
+		writer.WriteString(line.m_line);
+		WriteActionListToImage(writer, line.m_actions);
+	}
+}
+
+
+void Character::ReadDialogueFromImage(ScenarioImageReader& reader, CharacterDialogueList& out_dialogue, const CardType type)
+{
+	const uint num_dialogue = reader.ReadU32();
+	out_dialogue.reserve(num_dialogue);
+
+	for (uint dialogue_idx = 0; dialogue_idx < num_dialogue; ++dialogue_idx)
+	{
+		out_dialogue.emplace_back();
+		CharacterDialogue& line = out_dialogue.back();
+
+		line.m_cardType = type;
+		line.m_characterStateId = m_theScenario->InternName(reader.ReadString());
+		line.m_locationNameId = m_theScenario->InternName(reader.ReadString());
+		line.m_locationStateId = m_theScenario->InternName(reader.ReadString());
+		line.m_cardNameId = m_theScenario->InternName(reader.ReadString());
+		line.m_cardStateId = m_theScenario->InternName(reader.ReadString());
+		line.m_line = reader.ReadString();
+		ReadActionListFromImage(line.m_actions, m_theScenario, reader);
+	}
+}
+
+
+void Character::LinkReferences(StringList& out_errors)
+{
+	LinkDialogue(m_dialogueAboutCharacter, out_errors);
+	LinkDialogue(m_dialogueAboutItem, out_errors);
+}
+
+
+// The match keys stay symbol ids, linking only checks that every one of them names something real
+void Character::LinkDialogue(CharacterDialogueList& dialogue, StringList& out_errors)
+{
+	const uint num_dialogue = static_cast<uint>(dialogue.size());
+	for (uint dialogue_idx = 0; dialogue_idx < num_dialogue; ++dialogue_idx)
+	{
+		CharacterDialogue& line = dialogue[dialogue_idx];
+		const String referrer = Stringf("Character %s, dialogue %u", m_name.c_str(), dialogue_idx);
+
+		if (line.m_characterStateId != SYMBOL_WILDCARD && !HasState(line.m_characterStateId))
 		{
-			m_currentState = m_states[state_idx];
-			return;
+			out_errors.push_back(Stringf("%s: the character has no state '%s'", referrer.c_str(), m_theScenario->GetSymbolName(line.m_characterStateId).c_str()));
 		}
-	}
 
-	ERROR_AND_DIE(Stringf("StartingState for Card '%s' was not found in the list of states", m_name.c_str()));
+		if (line.m_locationNameId != SYMBOL_WILDCARD)
+		{
+			const int loc_idx = m_theScenario->LinkCardReference(CARD_LOCATION, line.m_locationNameId, referrer, out_errors);
+			m_theScenario->LinkStateReference(CARD_LOCATION, loc_idx, line.m_locationStateId, referrer, out_errors);
+		}
+
+		if (line.m_cardNameId != SYMBOL_WILDCARD)
+		{
+			const int card_idx = m_theScenario->LinkCardReference(line.m_cardType, line.m_cardNameId, referrer, out_errors);
+			m_theScenario->LinkStateReference(line.m_cardType, card_idx, line.m_cardStateId, referrer, out_errors);
+		}
+
+		LinkActionListReferences(line.m_actions, referrer, out_errors);
+	}
 }
@@ -4,7 +4,7 @@
 struct CharacterState
 {
 public:
-	String		m_name = "";
+	SymbolId	m_nameId = SYMBOL_EMPTY;
 	bool		m_addGameTime = false;
 	ContextMode	m_contextMode = CONTEXT_NONE;
 };
@@ -17,15 +17,15 @@ public:
 	~CharacterDialogue();
 
 public:
-	String m_characterState = "*";
+	SymbolId m_characterStateId = SYMBOL_WILDCARD;
 
-	String m_locationName = "*";
-	String m_locationState = "*";
+	SymbolId m_locationNameId = SYMBOL_WILDCARD;
+	SymbolId m_locationStateId = SYMBOL_WILDCARD;
 
 	// either a character or item
 	CardType m_cardType = UNKNOWN_CARD_TYPE;
-	String m_cardName = "*";
-	String m_cardState = "*";
+	SymbolId m_cardNameId = SYMBOL_WILDCARD;
+	SymbolId m_cardStateId = SYMBOL_WILDCARD;
 
 	String m_line = "default dialogue for any card";
 	ActionList m_actions = ActionList();
@@ -39,22 +39,42 @@ public:
 	explicit Character(Scenario* the_setup);
 	explicit Character(Scenario* the_setup, const std::string& name, const std::vector<std::string>& list_of_nicknames, const std::string& desc);
 	explicit Character(Scenario* the_setup, const XmlElement* element);
+	explicit Character(Scenario* the_setup, ScenarioImageReader& reader);
 	~Character() = default;
 
 	// ACCESSORS
 	void					ImportCharacterStatesFromXml(const XmlElement* element);
 	void					ImportCharacterDialogueFromXml(const XmlElement* element, CardType type);
 	const CharacterState&	GetCharacterState() const;
+	bool					HasState(const String& state_name) const;
+	bool					HasState(SymbolId state_id) const;
+	int						FindStateIdx(SymbolId state_id) const;	// -1 when there is no such state
 	bool					AskAboutCharacter(String& out, const Location* location, const Character* character);
 	bool					AskAboutItem(String& out, const Location* location, const Item* item);
 	String					GetAsString() const;
 
 	// MUTATORS
 	void SetState(const String& starting_state);
+	void SetState(SymbolId state_id);
+	void SetStateIdx(int state_idx);
+
+	void WriteToImage(ScenarioImageWriter& writer) const;
+	void ReloadFromXml(const XmlElement* element);
+	void LinkReferences(StringList& out_errors);
+	void PlaceInStartLocation(int char_idx);		// by the loader, once the character sits at char_idx in the list
+
+private:
+	void ImportFromXml(const XmlElement* element);
+	void LoadCardImage(const String& image_dir);
+	void RemoveFromStartLocation();
+
+	void WriteDialogueToImage(ScenarioImageWriter& writer, const CharacterDialogueList& dialogue) const;
+	void ReadDialogueFromImage(ScenarioImageReader& reader, CharacterDialogueList& out_dialogue, CardType type);
+	void LinkDialogue(CharacterDialogueList& dialogue, StringList& out_errors);
 
 private:
-	CharacterState			m_currentState;
-	CharStateList			m_states;
+	String					m_startLocation = "NONE";
+	CardStateTable<CharacterState>	m_states;
 
 	CharacterDialogueList		m_dialogueAboutCharacter;
 	CharacterDialogueList		m_dialogueAboutItem;
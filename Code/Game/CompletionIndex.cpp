@@ -0,0 +1,219 @@
+#include "Game/CompletionIndex.hpp"
+#include "Game/CardIndex.hpp"
+#include "Game/CaseFold.hpp"
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+
+constexpr uint COMPLETION_BENCHMARK_MAX_NAMES_TYPED = 4096;
+
+
+//------------------------------------------------------------
+CompletionIndex::CompletionIndex()
+{
+	Clear();
+}
+
+
+void CompletionIndex::Clear()
+{
+	m_texts.clear();
+	m_foldedTexts.clear();
+	m_prefix.clear();
+	m_ranges.assign(1, MatchRange());
+}
+
+
+void CompletionIndex::Add(const std::string_view text)
+{
+	String folded_text;
+	FoldCase(text, folded_text);
+
+	m_texts.emplace_back(text);
+	m_foldedTexts.push_back(folded_text);
+}
+
+
+void CompletionIndex::Sort()
+{
+	std::vector<uint32_t> order(m_texts.size());
+	for (uint32_t entry_idx = 0; entry_idx < static_cast<uint32_t>(order.size()); ++entry_idx)
+	{
+		order[entry_idx] = entry_idx;
+	}
+
+	std::sort(order.begin(), order.end(), [this](const uint32_t lhs, const uint32_t rhs)
+	{
+		const int folded_order = m_foldedTexts[lhs].compare(m_foldedTexts[rhs]);
+		return folded_order != 0 ? folded_order < 0 : m_texts[lhs] < m_texts[rhs];
+	});
+
+	StringList sorted_texts;
+	StringList sorted_folded_texts;
+	sorted_texts.reserve(order.size());
+	sorted_folded_texts.reserve(order.size());
+
+	for (const uint32_t entry_idx : order)
+	{
+		if (!sorted_folded_texts.empty() && sorted_folded_texts.back() == m_foldedTexts[entry_idx])
+		{
+			continue;
+		}
+
+		sorted_texts.push_back(std::move(m_texts[entry_idx]));
+		sorted_folded_texts.push_back(std::move(m_foldedTexts[entry_idx]));
+	}
+
+	m_texts.swap(sorted_texts);
+	m_foldedTexts.swap(sorted_folded_texts);
+
+	m_prefix.clear();
+	m_ranges.assign(1, { 0, static_cast<uint32_t>(m_texts.size()) });
+}
+
+
+// Keeps the ranges of the part of the prefix that did not change, so a keystroke costs one narrowing
+void CompletionIndex::SetPrefix(const std::string_view prefix)
+{
+	const FoldedText folded(prefix);
+	const std::string_view folded_prefix = folded.GetView();
+
+	size_t num_same_chars = 0;
+	while (num_same_chars < folded_prefix.size() && num_same_chars < m_prefix.size()
+		&& folded_prefix[num_same_chars] == m_prefix[num_same_chars])
+	{
+		num_same_chars++;
+	}
+
+	m_prefix.resize(num_same_chars);
+	m_ranges.resize(num_same_chars + 1);
+
+	for (size_t char_idx = num_same_chars; char_idx < folded_prefix.size(); ++char_idx)
+	{
+		const unsigned char folded_char = static_cast<unsigned char>(folded_prefix[char_idx]);
+		m_ranges.push_back(NarrowRange(m_ranges.back(), char_idx, folded_char));
+		m_prefix.push_back(static_cast<char>(folded_char));
+	}
+}
+
+
+uint CompletionIndex::GetNumMatches() const
+{
+	return m_ranges.back().m_end - m_ranges.back().m_begin;
+}
+
+
+const String& CompletionIndex::GetMatch(const uint match_idx) const
+{
+	return m_texts[m_ranges.back().m_begin + match_idx];
+}
+
+
+uint CompletionIndex::GetNumEntries() const
+{
+	return static_cast<uint>(m_texts.size());
+}
+
+
+// Every entry in the range shares the characters before char_idx, so they are sorted on this one
+CompletionIndex::MatchRange CompletionIndex::NarrowRange(const MatchRange& range, const size_t char_idx, const unsigned char folded_char) const
+{
+	uint32_t low = range.m_begin;
+	uint32_t high = range.m_end;
+	while (low < high)
+	{
+		const uint32_t mid = low + (high - low) / 2;
+		if (GetFoldedChar(mid, char_idx) < folded_char)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	MatchRange narrowed;
+	narrowed.m_begin = low;
+
+	high = range.m_end;
+	while (low < high)
+	{
+		const uint32_t mid = low + (high - low) / 2;
+		if (GetFoldedChar(mid, char_idx) <= folded_char)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	narrowed.m_end = low;
+	return narrowed;
+}
+
+
+int CompletionIndex::GetFoldedChar(const uint32_t entry_idx, const size_t char_idx) const
+{
+	const String& folded_text = m_foldedTexts[entry_idx];
+	return char_idx < folded_text.size() ? static_cast<unsigned char>(folded_text[char_idx]) : -1;
+}
+
+
+//------------------------------------------------------------
+void BenchmarkCompletionIndex(const char* label, const StringList& names)
+{
+	if (names.empty())
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("%s: no names to complete", label));
+		return;
+	}
+
+	CompletionIndex index;
+
+	const double build_start = GetCurrentTimeSeconds();
+	for (const String& name : names)
+	{
+		index.Add(name);
+	}
+	index.Sort();
+	const double build_seconds = GetCurrentTimeSeconds() - build_start;
+
+	// every prefix of the typed names, the way the input box sees them
+	const uint num_names_typed = std::min(static_cast<uint>(names.size()), COMPLETION_BENCHMARK_MAX_NAMES_TYPED);
+	const uint name_stride = static_cast<uint>(names.size()) / num_names_typed;
+
+	uint64_t num_keystrokes = 0;
+	uint64_t num_full_matches = 0;
+	const double typing_start = GetCurrentTimeSeconds();
+	for (uint typed_idx = 0; typed_idx < num_names_typed; ++typed_idx)
+	{
+		const std::string_view name = names[typed_idx * name_stride];
+
+		for (size_t length = 0; length <= name.size(); ++length)
+		{
+			index.SetPrefix(name.substr(0, length));
+			num_keystrokes++;
+		}
+
+		num_full_matches += index.GetNumMatches() > 0 ? 1 : 0;
+
+		for (size_t length = name.size(); length-- > 0;)
+		{
+			index.SetPrefix(name.substr(0, length));
+			num_keystrokes++;
+		}
+	}
+	const double typing_seconds = GetCurrentTimeSeconds() - typing_start;
+
+	const Rgba result_color = num_full_matches == num_names_typed ? Rgba::GREEN : Rgba::RED;
+	g_theDevConsole->PrintString(result_color, Stringf("%s: %u completions, build %.3f ms, %u names typed and deleted",
+		label, index.GetNumEntries(), build_seconds * 1000.0, num_names_typed));
+	g_theDevConsole->PrintString(result_color, Stringf("\t %u keystrokes  %.1f ns/keystroke",
+		static_cast<uint>(num_keystrokes), typing_seconds * 1e9 / static_cast<double>(num_keystrokes)));
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+// Completions sorted by their case folded text, so everything starting with a prefix is one contiguous range.
+// The range of every length of the current prefix is kept: typing a character narrows the last range with two binary
+// searches on that character alone, deleting one drops back to the range before it. Nothing is rescanned per keystroke.
+
+class CompletionIndex
+{
+public:
+	CompletionIndex();
+
+	void	Clear();
+	void	Add(std::string_view text);
+	void	Sort();							// after the last Add, drops texts that fold to the same thing
+
+	void	SetPrefix(std::string_view prefix);
+	uint	GetNumMatches() const;
+	const String& GetMatch(uint match_idx) const;	// in folded order
+	uint	GetNumEntries() const;
+
+private:
+	struct MatchRange
+	{
+		uint32_t	m_begin = 0;
+		uint32_t	m_end = 0;
+	};
+
+	MatchRange	NarrowRange(const MatchRange& range, size_t char_idx, unsigned char folded_char) const;
+	int			GetFoldedChar(uint32_t entry_idx, size_t char_idx) const;	// -1 past the end of the entry
+
+private:
+	StringList				m_texts;
+	StringList				m_foldedTexts;
+	String					m_prefix;		// folded
+	std::vector<MatchRange>	m_ranges;		// m_ranges[n] is what matches the first n characters of m_prefix
+};
+
+
+//------------------------------------------------------------
+// Types every name a character at a time, then deletes it again, and reports the cost of each keystroke
+void BenchmarkCompletionIndex(const char* label, const StringList& names);
@@ -5,6 +5,9 @@
 #include "Game/Location.hpp"
 #include "Game/Character.hpp"
 #include "Game/Item.hpp"
+#include "Game/ScenarioImage.hpp"
+#include "Game/IncidentProgram.hpp"
+#include "Game/CaseFold.hpp"
 
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -23,7 +26,7 @@ Condition::~Condition()
 
 bool Condition::Test()
 {
-	ERROR_AND_DIE("Have not setup the Trigger::Execute() function");
+	ERROR_AND_DIE("Have not setup the Condition::Test() function");
 }
 
 
@@ -33,16 +36,51 @@ String Condition::GetAsString() const
 }
 
 
+ConditionType Condition::GetType() const
+{
+	return CONDITION_UNKNOWN;
+}
+
+
+Scenario* Condition::GetScenario() const
+{
+	return m_trigger->GetOwner()->GetOwner();
+}
+
+
+void Condition::WriteToImage(ScenarioImageWriter& writer) const
+{
+	UNUSED(writer);
+	ERROR_AND_DIE("Base class WriteToImage should never be called.");
+}
+
+
+// Conditions with no name references have nothing to link
+void Condition::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	UNUSED(referrer);
+	UNUSED(out_errors);
+}
+
+
+// Conditions without an opcode of their own are called through Test
+void Condition::CompileInto(IncidentProgram& program)
+{
+	program.EmitCondition(this);
+}
+
+
 //-------------------------------------------------------------------
 ConditionTimePassed::ConditionTimePassed(Trigger* event_trigger, const XmlElement* element) :
 	Condition(event_trigger)
 {
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "since")
 		{
@@ -82,65 +120,34 @@ ConditionTimePassed::ConditionTimePassed(Trigger* event_trigger, const XmlElemen
 }
 
 
+ConditionTimePassed::ConditionTimePassed(Trigger* event_trigger, ScenarioImageReader& reader) :
+	Condition(event_trigger)
+{
+	m_since = static_cast<TimeRelativeTo>(reader.ReadI32());
+	m_timePassed = reader.ReadGameTime();
+}
+
+
 ConditionTimePassed::~ConditionTimePassed()
 {
 }
 
+// Time only goes forward, once the minute is reached the condition holds from then on
 bool ConditionTimePassed::Test()
 {
+	const int now_minutes = GetGameTimeInMinutes(GetScenario()->GetCurrentTime());
+	const int threshold_minutes = GetGameTimeInMinutes(m_timePassed);
 
-	
 	switch(m_since)
 	{
 		case ABSOLUTE_GAME_TIME:
 		{
-			Scenario* the_scenario = m_trigger->GetOwner()->GetOwner();
-			GameTime relative_time = the_scenario->GetCurrentTime();
-
-			int relative_time_in_minutes = static_cast<int>(relative_time.m_min);
-			relative_time_in_minutes += 60 * static_cast<int>(relative_time.m_hour);
-			relative_time_in_minutes += 1440 * static_cast<int>(relative_time.m_day);
-
-			int time_set_in_minutes = static_cast<int>(m_timePassed.m_min);
-			time_set_in_minutes += 60 * static_cast<int>(m_timePassed.m_hour);
-			time_set_in_minutes += 1440 * static_cast<int>(m_timePassed.m_day);
-
-			const uint time_remaining_in_minutes = time_set_in_minutes - relative_time_in_minutes;
-
-			if(time_remaining_in_minutes <= 0)
-			{
-				return true;
-			}
-				
-			break;
+			return now_minutes >= threshold_minutes;
 		}
 		case INCIDENT_ENABLED:
 		{
-			Scenario* the_scenario = m_trigger->GetOwner()->GetOwner();
-			const GameTime relative_time = the_scenario->GetCurrentTime();
-
-			int relative_time_in_minutes = static_cast<int>(relative_time.m_min);
-			relative_time_in_minutes += 60 * static_cast<int>(relative_time.m_hour);
-			relative_time_in_minutes += 1440 * static_cast<int>(relative_time.m_day);
-				
-			Incident* the_event = m_trigger->GetOwner();
-			const GameTime time_event_active = the_event->GetActivatedTime();
-			int active_in_minutes = static_cast<int>(time_event_active.m_min);
-			active_in_minutes += 60 * static_cast<int>(time_event_active.m_hour);
-			active_in_minutes += 1440 * static_cast<int>(time_event_active.m_day);
-
-			const int time_remaining_in_minutes = relative_time_in_minutes - active_in_minutes;
-				
-			int time_threshold_minutes = static_cast<int>(m_timePassed.m_min);
-			time_threshold_minutes += 60 * static_cast<int>(m_timePassed.m_hour);
-			time_threshold_minutes += 1440 * static_cast<int>(m_timePassed.m_day);
-
-			if (time_remaining_in_minutes >= time_threshold_minutes)
-			{
-				return true;
-			}
-
-			break;
+			const int enabled_minutes = GetGameTimeInMinutes(m_trigger->GetOwner()->GetActivatedTime());
+			return now_minutes - enabled_minutes >= threshold_minutes;
 		}
 		default:
 		{
@@ -178,20 +185,47 @@ String ConditionTimePassed::GetAsString() const
 	return Stringf("ConditionTimePassed: %s", since_string.c_str());
 }
 
+
+ConditionType ConditionTimePassed::GetType() const
+{
+	return CONDITION_TIME_PASSED;
+}
+
+
+void ConditionTimePassed::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteI32(m_since);
+	writer.WriteGameTime(m_timePassed);
+}
+
+
+void ConditionTimePassed::CompileInto(IncidentProgram& program)
+{
+	const uint minutes = static_cast<uint>(GetGameTimeInMinutes(m_timePassed));
+
+	switch (m_since)
+	{
+		case ABSOLUTE_GAME_TIME:	program.EmitTest(INCIDENT_OP_TEST_TIME_REACHED, -1, minutes);			break;
+		case INCIDENT_ENABLED:		program.EmitTest(INCIDENT_OP_TEST_TIME_SINCE_ENABLED, -1, minutes);	break;
+		default:					program.EmitNeverPasses();												break;
+	}
+}
+
 //-------------------------------------------------------------------
 ConditionLocationCheck::ConditionLocationCheck(Trigger* event_trigger, const XmlElement* element) :
 	Condition(event_trigger)
 {
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "location")
 		{
-			m_atLocationName = StringToLower(attribute->Value());
+			m_atLocationNameId = GetScenario()->InternName(attribute->Value());
 		}
 		else if (attribute_name == "condition")
 		{
@@ -218,6 +252,14 @@ ConditionLocationCheck::ConditionLocationCheck(Trigger* event_trigger, const Xml
 }
 
 
+ConditionLocationCheck::ConditionLocationCheck(Trigger* event_trigger, ScenarioImageReader& reader) :
+	Condition(event_trigger)
+{
+	m_atLocationNameId = GetScenario()->InternName(reader.ReadString());
+	m_playerPresence = reader.ReadBool();
+}
+
+
 ConditionLocationCheck::~ConditionLocationCheck()
 {
 
@@ -226,38 +268,22 @@ ConditionLocationCheck::~ConditionLocationCheck()
 
 bool ConditionLocationCheck::Test()
 {
-	Scenario* the_scenario = m_trigger->GetOwner()->GetOwner();
-	Location* current_location = the_scenario->GetCurrentLocation();
-	
-	LookupItr loc_itr;
-	bool is_valid_location = the_scenario->IsLocationInLookupTable(loc_itr, m_atLocationName);
-
-	if(is_valid_location)
+	// dangling, reported by the link pass
+	if (m_atLocationIdx < 0)
 	{
-		Location* location_lookup = the_scenario->GetLocationFromList(loc_itr->second);
-
-		if (m_playerPresence)
-		{
-			if (current_location == location_lookup)
-			{
-				return true;
-			}
-		}
-		else
-		{
-			if (current_location != location_lookup)
-			{
-				return true;
-			}
-		}
+		return false;
 	}
-	else
+
+	Scenario* the_scenario = GetScenario();
+	const Location* current_location = the_scenario->GetCurrentLocation();
+	const Location* location_lookup = the_scenario->GetLocationFromList(m_atLocationIdx);
+
+	if (m_playerPresence)
 	{
-		ERROR_RECOVERABLE(Stringf("ConditionLocationCheck error, the name of the location %s is not a valid location", m_atLocationName.c_str()))
+		return current_location == location_lookup;
 	}
 
-
-	return false;
+	return current_location != location_lookup;
 }
 
 
@@ -267,30 +293,62 @@ String ConditionLocationCheck::GetAsString() const
 
 	if (m_playerPresence)
 	{
-		line = Stringf("if the player is at %s", m_atLocationName.c_str());
+		line = Stringf("if the player is at %s", GetScenario()->GetSymbolName(m_atLocationNameId).c_str());
 	}
 	else
 	{
-		line = Stringf("if the player is not at %s", m_atLocationName.c_str());
+		line = Stringf("if the player is not at %s", GetScenario()->GetSymbolName(m_atLocationNameId).c_str());
 	}
 
 	return Stringf("ConditionLocationCheck: %s", line.c_str());
 }
 
+
+ConditionType ConditionLocationCheck::GetType() const
+{
+	return CONDITION_LOCATION;
+}
+
+
+void ConditionLocationCheck::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(GetScenario()->GetSymbolName(m_atLocationNameId));
+	writer.WriteBool(m_playerPresence);
+}
+
+
+void ConditionLocationCheck::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	m_atLocationIdx = GetScenario()->LinkCardReference(CARD_LOCATION, m_atLocationNameId, referrer, out_errors);
+}
+
+
+void ConditionLocationCheck::CompileInto(IncidentProgram& program)
+{
+	if (m_atLocationIdx < 0)
+	{
+		program.EmitNeverPasses();
+		return;
+	}
+
+	program.EmitPlayerAtTest(m_atLocationIdx, m_playerPresence);
+}
+
 //-------------------------------------------------------------------
 ConditionStateCheck::ConditionStateCheck(Trigger* event_trigger, const XmlElement* element) :
 	Condition(event_trigger)
 {
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "object")
 		{
-			m_cardName = StringToLower(attribute->Value());
+			m_cardNameId = GetScenario()->InternName(attribute->Value());
 		}
 		else if (attribute_name == "type")
 		{
@@ -332,7 +390,7 @@ ConditionStateCheck::ConditionStateCheck(Trigger* event_trigger, const XmlElemen
 		}
 		else if (attribute_name == "state")
 		{
-			m_cardStateName = StringToLower(attribute->Value());
+			m_cardStateId = GetScenario()->InternName(attribute->Value());
 		}
 		else
 		{
@@ -342,6 +400,16 @@ ConditionStateCheck::ConditionStateCheck(Trigger* event_trigger, const XmlElemen
 }
 
 
+ConditionStateCheck::ConditionStateCheck(Trigger* event_trigger, ScenarioImageReader& reader) :
+	Condition(event_trigger)
+{
+	m_cardNameId = GetScenario()->InternName(reader.ReadString());
+	m_cardType = static_cast<CardType>(reader.ReadI32());
+	m_qualCondition = static_cast<QualCondition>(reader.ReadI32());
+	m_cardStateId = GetScenario()->InternName(reader.ReadString());
+}
+
+
 ConditionStateCheck::~ConditionStateCheck()
 {
 
@@ -350,137 +418,30 @@ ConditionStateCheck::~ConditionStateCheck()
 
 bool ConditionStateCheck::Test()
 {
-	Scenario* the_scenario = m_trigger->GetOwner()->GetOwner();
+	// dangling, reported by the link pass
+	if (m_cardIdx < 0)
+	{
+		return false;
+	}
+
+	Scenario* the_scenario = GetScenario();
+	SymbolId cur_state = INVALID_SYMBOL;
 
 	switch(m_cardType)
 	{
 		case CARD_LOCATION:
 		{
-			LookupItr loc_itr;
-			const bool is_valid_location = the_scenario->IsLocationInLookupTable(loc_itr, m_cardName);
-
-			if (is_valid_location)
-			{
-				Location* location_lookup = the_scenario->GetLocationFromList(loc_itr->second);
-				LocationState loc_cur_state = location_lookup->GetLocationState();
-				String loc_cur_state_name = StringToLower(loc_cur_state.m_name);
-
-				switch(m_qualCondition)
-				{
-					case QUAL_IS:
-					{
-						if(loc_cur_state_name == m_cardStateName)
-						{
-							return true;
-						}
-						break;
-					}
-					case QUAL_IS_NOT: 
-					{
-						if (loc_cur_state_name != m_cardStateName)
-						{
-							return true;
-						}
-						break;
-					}
-					default: 
-					{
-						ERROR_RECOVERABLE("ConditionStateCheck error, the qual condition was not set properly")
-						break;
-					}
-				}
-			}
-			else
-			{
-				ERROR_RECOVERABLE(Stringf("ConditionStateCheck error, the name of the location %s is not a valid location", m_cardName.c_str()))
-			}
-				
+			cur_state = the_scenario->GetLocationFromList(m_cardIdx)->GetLocationState().m_nameId;
 			break;
 		}
 		case CARD_CHARACTER:
 		{
-			LookupItr char_itr;
-			const bool is_valid_character = the_scenario->IsCharacterInLookupTable(char_itr, m_cardName);
-
-			if (is_valid_character)
-			{
-				Character* character_lookup = the_scenario->GetCharacterFromList(char_itr->second);
-				CharacterState char_cur_state = character_lookup->GetCharacterState();
-				String char_cur_state_name = StringToLower(char_cur_state.m_name);
-
-				switch (m_qualCondition)
-				{
-					case QUAL_IS:
-					{
-						if (char_cur_state_name == m_cardStateName)
-						{
-							return true;
-						}
-						break;
-					}
-					case QUAL_IS_NOT:
-					{
-						if (char_cur_state_name != m_cardStateName)
-						{
-							return true;
-						}
-						break;
-					}
-					default:
-					{
-						ERROR_RECOVERABLE("ConditionStateCheck error, the qual condition was not set properly")
-							break;
-					}
-				}
-			}
-			else
-			{
-				ERROR_RECOVERABLE(Stringf("ConditionStateCheck error, the name of the character %s is not a valid character", m_cardName.c_str()))
-			}
-
+			cur_state = the_scenario->GetCharacterFromList(m_cardIdx)->GetCharacterState().m_nameId;
 			break;
 		}
 		case CARD_ITEM: 
 		{
-			LookupItr item_itr;
-			const bool is_valid_item = the_scenario->IsItemInLookupTable(item_itr, m_cardName);
-
-			if (is_valid_item)
-			{
-				Item* item_lookup = the_scenario->GetItemFromList(item_itr->second);
-				ItemState item_cur_state = item_lookup->GetItemState();
-				String item_cur_state_name = StringToLower(item_cur_state.m_name);
-
-				switch (m_qualCondition)
-				{
-				case QUAL_IS:
-				{
-					if (item_cur_state_name == m_cardStateName)
-					{
-						return true;
-					}
-					break;
-				}
-				case QUAL_IS_NOT:
-				{
-					if (item_cur_state_name != m_cardStateName)
-					{
-						return true;
-					}
-					break;
-				}
-				default:
-				{
-					ERROR_RECOVERABLE("ConditionStateCheck error, the qual condition was not set properly")
-						break;
-				}
-				}
-			}
-			else
-			{
-				ERROR_RECOVERABLE(Stringf("ConditionStateCheck error, the name of the item %s is not a valid item", m_cardName.c_str()))
-			}
-
+			cur_state = the_scenario->GetItemFromList(m_cardIdx)->GetItemState().m_nameId;
 			break;
 		}
 		default:
@@ -490,6 +451,23 @@ bool ConditionStateCheck::Test()
 		}
 	}
 
+	switch(m_qualCondition)
+	{
+		case QUAL_IS:
+		{
+			return cur_state == m_cardStateId;
+		}
+		case QUAL_IS_NOT: 
+		{
+			return cur_state != m_cardStateId;
+		}
+		default: 
+		{
+			ERROR_RECOVERABLE("ConditionStateCheck error, the qual condition was not set properly")
+			break;
+		}
+	}
+
 	return false;
 }
 
@@ -501,7 +479,7 @@ String ConditionStateCheck::GetAsString() const
 	{
 	case CARD_LOCATION:
 	{
-		line = Stringf("if the location %s", m_cardName.c_str());
+		line = Stringf("if the location %s", GetScenario()->GetSymbolName(m_cardNameId).c_str());
 		switch (m_qualCondition)
 		{
 		case QUAL_IS:
@@ -519,7 +497,7 @@ String ConditionStateCheck::GetAsString() const
 	}
 	case CARD_CHARACTER:
 	{
-		line = Stringf("if the character %s", m_cardName.c_str());
+		line = Stringf("if the character %s", GetScenario()->GetSymbolName(m_cardNameId).c_str());
 		switch (m_qualCondition)
 		{
 		case QUAL_IS:
@@ -537,7 +515,7 @@ String ConditionStateCheck::GetAsString() const
 	}
 	case CARD_ITEM:
 	{
-		line = Stringf("if the item %s", m_cardName.c_str());
+		line = Stringf("if the item %s", GetScenario()->GetSymbolName(m_cardNameId).c_str());
 		switch (m_qualCondition)
 		{
 		case QUAL_IS:
@@ -555,25 +533,74 @@ String ConditionStateCheck::GetAsString() const
 	}
 	}
 
-	line += Stringf(" in the state %s", m_cardStateName.c_str());
+	line += Stringf(" in the state %s", GetScenario()->GetSymbolName(m_cardStateId).c_str());
 
 	return Stringf("ConditionStateCheck: %s", line.c_str());
 }
 
+
+ConditionType ConditionStateCheck::GetType() const
+{
+	return CONDITION_CARD_STATE;
+}
+
+
+void ConditionStateCheck::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(GetScenario()->GetSymbolName(m_cardNameId));
+	writer.WriteI32(m_cardType);
+	writer.WriteI32(m_qualCondition);
+	writer.WriteString(GetScenario()->GetSymbolName(m_cardStateId));
+}
+
+
+void ConditionStateCheck::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	Scenario* the_scenario = GetScenario();
+	m_cardIdx = the_scenario->LinkCardReference(m_cardType, m_cardNameId, referrer, out_errors);
+	the_scenario->LinkStateReference(m_cardType, m_cardIdx, m_cardStateId, referrer, out_errors);
+}
+
+
+// A card type or qual condition that was not set keeps going through Test, which reports it
+void ConditionStateCheck::CompileInto(IncidentProgram& program)
+{
+	if (m_cardIdx < 0)
+	{
+		program.EmitNeverPasses();
+		return;
+	}
+
+	const bool is_card_type_set = m_cardType == CARD_LOCATION || m_cardType == CARD_CHARACTER || m_cardType == CARD_ITEM;
+	if (!is_card_type_set)
+	{
+		Condition::CompileInto(program);
+		return;
+	}
+
+	switch (m_qualCondition)
+	{
+		case QUAL_IS:		program.EmitCardStateTest(m_cardType, m_cardIdx, m_cardStateId, true);	break;
+		case QUAL_IS_NOT:	program.EmitCardStateTest(m_cardType, m_cardIdx, m_cardStateId, false);	break;
+		default:			Condition::CompileInto(program);										break;
+	}
+}
+
 //-------------------------------------------------------------------
 ConditionContextCheck::ConditionContextCheck(Trigger* event_trigger, const XmlElement* element) :
 	Condition(event_trigger)
 {
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "object")
 		{
-			m_cardName = StringToLower(attribute->Value());
+			m_cardNameId = GetScenario()->InternName(attribute->Value());
 		}
 		else if (attribute_name == "type")
 		{
@@ -621,6 +648,15 @@ ConditionContextCheck::ConditionContextCheck(Trigger* event_trigger, const XmlEl
 }
 
 
+ConditionContextCheck::ConditionContextCheck(Trigger* event_trigger, ScenarioImageReader& reader) :
+	Condition(event_trigger)
+{
+	m_cardNameId = GetScenario()->InternName(reader.ReadString());
+	m_cardType = static_cast<CardType>(reader.ReadI32());
+	m_qualCondition = static_cast<QualCondition>(reader.ReadI32());
+}
+
+
 ConditionContextCheck::~ConditionContextCheck()
 {
 
@@ -629,134 +665,30 @@ ConditionContextCheck::~ConditionContextCheck()
 
 bool ConditionContextCheck::Test()
 {
-	Scenario* the_scenario = m_trigger->GetOwner()->GetOwner();
+	// dangling, reported by the link pass
+	if (m_cardIdx < 0)
+	{
+		return false;
+	}
+
+	Scenario* the_scenario = GetScenario();
+	const Card* card = nullptr;
 
 	switch (m_cardType)
 	{
 		case CARD_LOCATION:
 		{
-			LookupItr loc_itr;
-			const bool is_valid_location = the_scenario->IsLocationInLookupTable(loc_itr, m_cardName);
-
-			if (is_valid_location)
-			{
-				Location* location_lookup = the_scenario->GetLocationFromList(loc_itr->second);
-				String loc_name = StringToLower(location_lookup->GetName());
-
-				switch (m_qualCondition)
-				{
-				case QUAL_IS:
-				{
-					if (loc_name == m_cardName)
-					{
-						return true;
-					}
-					break;
-				}
-				case QUAL_IS_NOT:
-				{
-					if (loc_name != m_cardName)
-					{
-						return true;
-					}
-					break;
-				}
-				default:
-				{
-					ERROR_RECOVERABLE("ConditionStateCheck error, the qual condition was not set properly")
-						break;
-				}
-				}
-			}
-			else
-			{
-				ERROR_RECOVERABLE(Stringf("ConditionStateCheck error, the name of the location %s is not a valid location", m_cardName.c_str()))
-			}
-
+			card = the_scenario->GetLocationFromList(m_cardIdx);
 			break;
 		}
 		case CARD_CHARACTER:
 		{
-			LookupItr char_itr;
-			const bool is_valid_character = the_scenario->IsCharacterInLookupTable(char_itr, m_cardName);
-
-			if (is_valid_character)
-			{
-				Character* character_lookup = the_scenario->GetCharacterFromList(char_itr->second);
-				String char_name = StringToLower(character_lookup->GetName());
-
-				switch (m_qualCondition)
-				{
-				case QUAL_IS:
-				{
-					if (char_name == m_cardName)
-					{
-						return true;
-					}
-					break;
-				}
-				case QUAL_IS_NOT:
-				{
-					if (char_name != m_cardName)
-					{
-						return true;
-					}
-					break;
-				}
-				default:
-				{
-					ERROR_RECOVERABLE("ConditionStateCheck error, the qual condition was not set properly")
-						break;
-				}
-				}
-			}
-			else
-			{
-				ERROR_RECOVERABLE(Stringf("ConditionStateCheck error, the name of the character %s is not a valid character", m_cardName.c_str()))
-			}
-
+			card = the_scenario->GetCharacterFromList(m_cardIdx);
 			break;
 		}
 		case CARD_ITEM:
 		{
-			LookupItr item_itr;
-			const bool is_valid_item = the_scenario->IsItemInLookupTable(item_itr, m_cardName);
-
-			if (is_valid_item)
-			{
-				Item* item_lookup = the_scenario->GetItemFromList(item_itr->second);
-				String item_name = StringToLower(item_lookup->GetName());
-
-				switch (m_qualCondition)
-				{
-				case QUAL_IS:
-				{
-					if (item_name == m_cardName)
-					{
-						return true;
-					}
-					break;
-				}
-				case QUAL_IS_NOT:
-				{
-					if (item_name != m_cardName)
-					{
-						return true;
-					}
-					break;
-				}
-				default:
-				{
-					ERROR_RECOVERABLE("ConditionStateCheck error, the qual condition was not set properly")
-						break;
-				}
-				}
-			}
-			else
-			{
-				ERROR_RECOVERABLE(Stringf("ConditionStateCheck error, the name of the item %s is not a valid item", m_cardName.c_str()))
-			}
-
+			card = the_scenario->GetItemFromList(m_cardIdx);
 			break;
 		}
 		default:
@@ -765,6 +697,27 @@ bool ConditionContextCheck::Test()
 				break;
 		}
 	}
+
+	// the card being talked to or looked at right now
+	const bool is_interest = card == the_scenario->GetCurrentInterest();
+
+	switch (m_qualCondition)
+	{
+		case QUAL_IS:
+		{
+			return is_interest;
+		}
+		case QUAL_IS_NOT:
+		{
+			return !is_interest;
+		}
+		default:
+		{
+			ERROR_RECOVERABLE("ConditionStateCheck error, the qual condition was not set properly")
+				break;
+		}
+	}
+
 	return false;
 }
 
@@ -776,7 +729,7 @@ String ConditionContextCheck::GetAsString() const
 	{
 	case CARD_LOCATION:
 	{
-		line = Stringf("if the location %s", m_cardName.c_str());
+		line = Stringf("if the location %s", GetScenario()->GetSymbolName(m_cardNameId).c_str());
 		switch (m_qualCondition)
 		{
 		case QUAL_IS:
@@ -794,7 +747,7 @@ String ConditionContextCheck::GetAsString() const
 	}
 	case CARD_CHARACTER:
 	{
-		line = Stringf("if the character %s", m_cardName.c_str());
+		line = Stringf("if the character %s", GetScenario()->GetSymbolName(m_cardNameId).c_str());
 		switch (m_qualCondition)
 		{
 		case QUAL_IS:
@@ -813,7 +766,7 @@ String ConditionContextCheck::GetAsString() const
 	}
 	case CARD_ITEM:
 	{
-		line = Stringf("if the item %s", m_cardName.c_str());
+		line = Stringf("if the item %s", GetScenario()->GetSymbolName(m_cardNameId).c_str());
 		switch (m_qualCondition)
 		{
 		case QUAL_IS:
@@ -837,4 +790,39 @@ String ConditionContextCheck::GetAsString() const
 }
 
 
+ConditionType ConditionContextCheck::GetType() const
+{
+	return CONDITION_CONTEXT;
+}
 
+
+void ConditionContextCheck::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(GetScenario()->GetSymbolName(m_cardNameId));
+	writer.WriteI32(m_cardType);
+	writer.WriteI32(m_qualCondition);
+}
+
+
+void ConditionContextCheck::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	m_cardIdx = GetScenario()->LinkCardReference(m_cardType, m_cardNameId, referrer, out_errors);
+}
+
+
+// The interest is read when the program runs, a qual condition that was not set keeps going through Test
+void ConditionContextCheck::CompileInto(IncidentProgram& program)
+{
+	if (m_cardIdx < 0)
+	{
+		program.EmitNeverPasses();
+		return;
+	}
+
+	switch (m_qualCondition)
+	{
+		case QUAL_IS:		program.EmitInterestTest(m_cardType, m_cardIdx, true);		break;
+		case QUAL_IS_NOT:	program.EmitInterestTest(m_cardType, m_cardIdx, false);	break;
+		default:			Condition::CompileInto(program);							break;
+	}
+}
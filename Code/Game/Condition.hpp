@@ -2,6 +2,7 @@
 #include "Game/GameCommon.hpp"
 
 class Scenario;
+class IncidentProgram;
 
 enum TimeRelativeTo
 {
@@ -34,6 +35,13 @@ public:
 
 	virtual bool Test();
 	virtual String GetAsString() const;
+	virtual ConditionType GetType() const;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const;
+	virtual void LinkReferences(const String& referrer, StringList& out_errors);
+	virtual void CompileInto(IncidentProgram& program);		// after the link pass, see IncidentProgram
+
+protected:
+	Scenario*	GetScenario() const;
 
 protected:
 	Trigger*	m_trigger = nullptr;
@@ -43,17 +51,19 @@ protected:
 	GameTime		m_timePassed;
 
 	//ConditionLocationCheck data
-	String	m_atLocationName = "unkown";
+	SymbolId	m_atLocationNameId = SYMBOL_EMPTY;
+	int			m_atLocationIdx = -1;
 	bool	m_playerPresence = true;
 
 	//ConditionStateCheck data
-	String			m_cardName = "unkown";
+	SymbolId		m_cardNameId = SYMBOL_EMPTY;
+	int				m_cardIdx = -1;
 	CardType		m_cardType = UNKNOWN_CARD_TYPE;
 	QualCondition	m_qualCondition = QUAL_IS;
-	String			m_cardStateName = "unkown";
+	SymbolId		m_cardStateId = SYMBOL_EMPTY;
 
 	//ConditionContextCheck data
-	//String		m_cardName = "unkown";
+	//SymbolId		m_cardNameId = SYMBOL_EMPTY;
 	//CardType		m_cardType = UNKNOWN_CARD_TYPE;
 	//QualCondition	m_qualCondition		= QUAL_IS;
 };
@@ -64,10 +74,14 @@ class ConditionTimePassed final : public Condition
 {
 public:
 	ConditionTimePassed(Trigger* event_trigger, const XmlElement* element);
+	ConditionTimePassed(Trigger* event_trigger, ScenarioImageReader& reader);
 	virtual ~ConditionTimePassed();
 
 	virtual bool Test() override;
 	virtual String GetAsString() const override;
+	virtual ConditionType GetType() const override;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const override;
+	virtual void CompileInto(IncidentProgram& program) override;
 };
 
 
@@ -76,11 +90,15 @@ class ConditionLocationCheck : public Condition
 {
 public:
 	ConditionLocationCheck(Trigger* event_trigger, const XmlElement* element);
+	ConditionLocationCheck(Trigger* event_trigger, ScenarioImageReader& reader);
 	virtual ~ConditionLocationCheck();
 
 	virtual bool Test() override;
 	virtual String GetAsString() const override;
-
+	virtual ConditionType GetType() const override;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const override;
+	virtual void LinkReferences(const String& referrer, StringList& out_errors) override;
+	virtual void CompileInto(IncidentProgram& program) override;
 };
 
 
@@ -89,11 +107,15 @@ class ConditionStateCheck : public Condition
 {
 public:
 	ConditionStateCheck(Trigger* event_trigger, const XmlElement* element);
+	ConditionStateCheck(Trigger* event_trigger, ScenarioImageReader& reader);
 	virtual ~ConditionStateCheck();
 
 	virtual bool Test() override;
 	virtual String GetAsString() const override;
-
+	virtual ConditionType GetType() const override;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const override;
+	virtual void LinkReferences(const String& referrer, StringList& out_errors) override;
+	virtual void CompileInto(IncidentProgram& program) override;
 };
 
 
@@ -102,10 +124,14 @@ class ConditionContextCheck : public Condition
 {
 public:
 	ConditionContextCheck(Trigger* event_trigger, const XmlElement* element);
+	ConditionContextCheck(Trigger* event_trigger, ScenarioImageReader& reader);
 	virtual ~ConditionContextCheck();
 
 	virtual bool Test() override;
 	virtual String GetAsString() const override;
-
+	virtual ConditionType GetType() const override;
+	virtual void WriteToImage(ScenarioImageWriter& writer) const override;
+	virtual void LinkReferences(const String& referrer, StringList& out_errors) override;
+	virtual void CompileInto(IncidentProgram& program) override;
 };
 
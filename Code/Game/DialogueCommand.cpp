@@ -0,0 +1,29 @@
+#include "Game/DialogueCommand.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+
+//------------------------------------------------------------
+void DialogueCommandTable::Subscribe(const ValidCommands verb, const DialogueCommandCallback callback)
+{
+	ASSERT_OR_DIE(verb > UNKNOWN_COMMAND && verb < NUM_COMMANDS, "Subscribing a dialogue handler to an unknown command");
+	m_callbacks[verb] = callback;
+}
+
+
+void DialogueCommandTable::Unsubscribe(const ValidCommands verb)
+{
+	ASSERT_OR_DIE(verb > UNKNOWN_COMMAND && verb < NUM_COMMANDS, "Unsubscribing a dialogue handler from an unknown command");
+	m_callbacks[verb] = nullptr;
+}
+
+
+bool DialogueCommandTable::Fire(const DialogueCommand& command) const
+{
+	if (command.m_verb <= UNKNOWN_COMMAND || command.m_verb >= NUM_COMMANDS || m_callbacks[command.m_verb] == nullptr)
+	{
+		return false;
+	}
+
+	return m_callbacks[command.m_verb](command);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <string_view>
+
+class Scenario;
+class DialogueSystem;
+
+// A line of player input already split up and handed straight to the handler of its verb, so handlers read their
+// inputs as fields instead of looking strings up in an EventArgs bag. The views point into the input line and the
+// command only lives for the handler call.
+
+struct DialogueCommand
+{
+	ValidCommands		m_verb = UNKNOWN_COMMAND;
+	std::string_view	m_line;					// everything after the verb
+	std::string_view	m_card;					// the name that fits the verb when one was found, otherwise the whole line
+	std::string_view	m_target;				// the name that fits the verb, empty when none was found
+	std::string_view	m_subject;				// a later name, the knife in "ask doyle about the knife"
+	Scenario*			m_scenario = nullptr;
+	DialogueSystem*		m_dialogueSystem = nullptr;
+};
+
+typedef bool (*DialogueCommandCallback)(const DialogueCommand& command);
+
+
+//------------------------------------------------------------
+// One handler per verb, found by the verb id
+class DialogueCommandTable
+{
+public:
+	void	Subscribe(ValidCommands verb, DialogueCommandCallback callback);
+	void	Unsubscribe(ValidCommands verb);
+	bool	Fire(const DialogueCommand& command) const;		// false when nothing handles the verb
+
+private:
+	DialogueCommandCallback		m_callbacks[NUM_COMMANDS] = {};
+};
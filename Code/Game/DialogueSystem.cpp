@@ -4,11 +4,44 @@
 #include "Engine/Core/StringUtils.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/CaseFold.hpp"
 #include "Game/DialogueSystem.hpp"
 #include "Game/Game.hpp"
 #include "Game/Scenario.hpp"
 #include "ThirdParty/imGUI/imgui_internal.h"
 
+#include <string_view>
+
+constexpr uint MAX_COMPLETIONS_SHOWN = 4;
+
+
+// The card lists each command takes a name from
+static uint GetCommandCardTypes(const ValidCommands command)
+{
+	switch (command)
+	{
+	case GOTO_LOCATION:		return 1u << CARD_LOCATION;
+	case TALK_TO_CHARACTER:	return 1u << CARD_CHARACTER;
+	case VIEW_ITEM:			return 1u << CARD_ITEM;
+	case ASK_CHARACTER:		return (1u << CARD_CHARACTER) | (1u << CARD_ITEM);
+	default:				return 0;
+	}
+}
+
+
+static ValidCommands FindCommand(const std::string_view command_name)
+{
+	for (int command_idx = 0; command_idx < NUM_COMMANDS; ++command_idx)
+	{
+		if (IsFoldedEqual(command_name, g_validCommands[command_idx]))
+		{
+			return static_cast<ValidCommands>(command_idx);
+		}
+	}
+
+	return UNKNOWN_COMMAND;
+}
+
 
 DialogueSystem::DialogueSystem(Game* owner) : m_theGame(owner)
 {
@@ -16,6 +49,12 @@ DialogueSystem::DialogueSystem(Game* owner) : m_theGame(owner)
 
 	m_items = std::vector<LogEntry*>();
 	memset(m_inputBuf, 0, sizeof(m_inputBuf));
+
+	for (const char* command : g_validCommands)
+	{
+		m_commandCompletions.Add(command);
+	}
+	m_commandCompletions.Sort();
 		
 
 	Vec2 frame_resolution = g_gameConfigBlackboard.GetValue(
@@ -248,12 +287,20 @@ void DialogueSystem::UpdateHistory()
 void DialogueSystem::UpdateInput()
 {
 	bool reclaim_focus = false;
+
+	const Scenario* scenario = m_theGame->GetCurrentScenario();
+	if (scenario != m_completionScenario || (scenario && scenario->GetNumLinks() != m_completionLinks))
+	{
+		RefreshCompletions();
+	}
 	
 	if (ImGui::InputText(
 			"Input",
 			m_inputBuf,
 			IM_ARRAYSIZE(m_inputBuf),
-			ImGuiInputTextFlags_EnterReturnsTrue
+			ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CallbackEdit | ImGuiInputTextFlags_CallbackCompletion,
+			InputTextCallback,
+			this
 			)
 		)
 	{
@@ -268,6 +315,9 @@ void DialogueSystem::UpdateInput()
 
 		strcpy_s(s, sizeof s, "");
 		reclaim_focus = true;
+
+		// the command may have put new cards in the journal
+		RefreshCompletions();
 	}
 
 	ImGui::SetItemDefaultFocus();
@@ -277,48 +327,222 @@ void DialogueSystem::UpdateInput()
 	{
 		ImGui::SetKeyboardFocusHere(-1);
 	}
+
+	if (!m_completionHint.empty())
+	{
+		ImGui::SameLine();
+		ImGui::TextDisabled("%s", m_completionHint.c_str());
+	}
 }
 
 
-void DialogueSystem::ExecuteCommand(const char* command_line)
+// The first name of a list the command takes is the target and the card, the last name after it is the subject:
+// "ask doyle about the knife" asks Doyle about the knife. Without any name the whole line stays the card, so a
+// misspelled name can still be matched by the handler.
+void DialogueSystem::SetMentions(DialogueCommand& command)
 {
-	AddLog(LOG_ECHO,Stringf("# %s\n", command_line));
+	command.m_card = command.m_line;
+	if (!command.m_scenario)
+	{
+		return;
+	}
 
-	EventArgs args;
-	std::vector<std::string> event_and_args = SplitStringOnDelimiter(command_line, ' ');
-	int num_args = static_cast<int>(event_and_args.size());
-	int num_functions_called = 0;
-	
-	const std::string event_name = StringToLower(event_and_args[0]);
+	command.m_scenario->FindNameMentions(command.m_line, m_mentions);
+	if (m_mentions.empty())
+	{
+		return;
+	}
 
-	if(num_args == 1)
+	const uint card_types = GetCommandCardTypes(command.m_verb);
+	size_t target_idx = 0;
+	while (card_types != 0 && target_idx < m_mentions.size() && (m_mentions[target_idx].m_kindMask & card_types) == 0)
 	{
-		num_functions_called  = g_theDialogueEventSystem->FireEvent(event_name, args);
+		target_idx++;
 	}
-	else
+	if (target_idx == m_mentions.size())
+	{
+		target_idx = 0;
+	}
+
+	const NameMention& target = m_mentions[target_idx];
+	command.m_target = command.m_line.substr(target.m_begin, target.m_length);
+	command.m_card = command.m_target;
+
+	if (target_idx + 1 < m_mentions.size())
+	{
+		const NameMention& subject = m_mentions.back();
+		command.m_subject = command.m_line.substr(subject.m_begin, subject.m_length);
+	}
+}
+
+
+// Only done when a command ran or the scenario changed, never per keystroke
+void DialogueSystem::RefreshCompletions()
+{
+	const Scenario* scenario = m_theGame->GetCurrentScenario();
+	m_completionScenario = scenario;
+	m_completionLinks = scenario ? scenario->GetNumLinks() : 0;
+
+	StringList known_names;
+	for (int type_idx = 0; type_idx < NUM_CARD_TYPES; ++type_idx)
 	{
-		String sub_string = "";
+		CompletionIndex& completions = m_cardCompletions[type_idx];
+		completions.Clear();
 
-		for(int str_idx = 1; str_idx < num_args; ++str_idx)
+		known_names.clear();
+		if (scenario)
 		{
-			if(str_idx != num_args - 1)
-			{
-				sub_string += event_and_args[str_idx] + " ";	
-			}
-			else
+			scenario->GetKnownCardNames(static_cast<CardType>(type_idx), known_names);
+		}
+
+		for (const String& name : known_names)
+		{
+			completions.Add(name);
+		}
+		completions.Sort();
+	}
+
+	UpdateCompletions(m_inputBuf);
+}
+
+
+// Each index keeps the ranges of what was typed before, so an edit only narrows or widens them
+void DialogueSystem::UpdateCompletions(const char* input_line)
+{
+	const std::string_view line = input_line;
+	const size_t command_end = line.find(' ');
+	m_completionHint.clear();
+
+	if (command_end == std::string_view::npos)
+	{
+		m_completionCommand = UNKNOWN_COMMAND;
+		if (line.empty())
+		{
+			return;
+		}
+
+		m_commandCompletions.SetPrefix(line);
+
+		const uint num_matches = m_commandCompletions.GetNumMatches();
+		for (uint match_idx = 0; match_idx < num_matches; ++match_idx)
+		{
+			m_completionHint += match_idx == 0 ? "Tab: " : " | ";
+			m_completionHint += m_commandCompletions.GetMatch(match_idx);
+		}
+		return;
+	}
+
+	m_completionCommand = FindCommand(line.substr(0, command_end));
+	const uint card_types = GetCommandCardTypes(m_completionCommand);
+
+	std::string_view card_name = line.substr(command_end);
+	while (!card_name.empty() && card_name.front() == ' ')
+	{
+		card_name.remove_prefix(1);
+	}
+
+	uint num_shown = 0;
+	uint num_matches = 0;
+	for (int type_idx = 0; type_idx < NUM_CARD_TYPES; ++type_idx)
+	{
+		if ((card_types & (1u << type_idx)) == 0)
+		{
+			continue;
+		}
+
+		CompletionIndex& completions = m_cardCompletions[type_idx];
+		completions.SetPrefix(card_name);
+
+		const uint num_type_matches = completions.GetNumMatches();
+		for (uint match_idx = 0; match_idx < num_type_matches && num_shown < MAX_COMPLETIONS_SHOWN; ++match_idx, ++num_shown)
+		{
+			m_completionHint += num_shown == 0 ? "Tab: " : " | ";
+			m_completionHint += completions.GetMatch(match_idx);
+		}
+		num_matches += num_type_matches;
+	}
+
+	if (num_matches > num_shown)
+	{
+		m_completionHint += Stringf(" (+%u)", num_matches - num_shown);
+	}
+}
+
+
+// Replaces the word being typed with the first suggestion
+void DialogueSystem::CompleteInput(ImGuiInputTextCallbackData* data)
+{
+	String completed_line;
+
+	if (m_completionCommand == UNKNOWN_COMMAND && strchr(data->Buf, ' ') == nullptr)
+	{
+		if (data->BufTextLen == 0 || m_commandCompletions.GetNumMatches() == 0)
+		{
+			return;
+		}
+
+		completed_line = m_commandCompletions.GetMatch(0) + " ";
+	}
+	else
+	{
+		const uint card_types = GetCommandCardTypes(m_completionCommand);
+		for (int type_idx = 0; type_idx < NUM_CARD_TYPES && completed_line.empty(); ++type_idx)
+		{
+			if ((card_types & (1u << type_idx)) != 0 && m_cardCompletions[type_idx].GetNumMatches() > 0)
 			{
-				sub_string += event_and_args[str_idx];
+				completed_line = Stringf("%s %s", g_validCommands[m_completionCommand], m_cardCompletions[type_idx].GetMatch(0).c_str());
 			}
 		}
 
-		//Setting up 
-		args.SetValue("card", sub_string); //comparing just the first word
-		args.SetValue("scenario", m_theGame->GetCurrentScenario());
-		args.SetValue("dialoguesystem", this);
-		num_functions_called = g_theDialogueEventSystem->FireEvent(event_name, args);
+		if (completed_line.empty())
+		{
+			return;
+		}
+	}
+
+	data->DeleteChars(0, data->BufTextLen);
+	data->InsertChars(0, completed_line.c_str());
+	UpdateCompletions(completed_line.c_str());
+}
+
+
+STATIC int DialogueSystem::InputTextCallback(ImGuiInputTextCallbackData* data)
+{
+	DialogueSystem* dialogue_system = static_cast<DialogueSystem*>(data->UserData);
+
+	if (data->EventFlag == ImGuiInputTextFlags_CallbackCompletion)
+	{
+		dialogue_system->CompleteInput(data);
+	}
+	else if (data->EventFlag == ImGuiInputTextFlags_CallbackEdit)
+	{
+		dialogue_system->UpdateCompletions(data->Buf);
+	}
+
+	return 0;
+}
+
+
+// The verb is everything up to the first space, the rest of the line is what the handler gets to look names up in
+void DialogueSystem::ExecuteCommand(const char* command_line)
+{
+	AddLog(LOG_ECHO,Stringf("# %s\n", command_line));
+
+	const std::string_view line = command_line;
+	const size_t verb_end = line.find(' ');
+
+	DialogueCommand command;
+	command.m_verb = FindCommand(line.substr(0, verb_end));
+	command.m_scenario = m_theGame->GetCurrentScenario();
+	command.m_dialogueSystem = this;
+
+	if (verb_end != std::string_view::npos)
+	{
+		command.m_line = line.substr(verb_end + 1);
+		SetMentions(command);
 	}
 
-	if (num_functions_called == 0)
+	if (!g_theDialogueCommands->Fire(command))
 	{
 		AddLog(LOG_ERROR, Stringf("Unknown command: '%s'\n", command_line));
 	}
@@ -1,7 +1,12 @@
 #pragma once
 #include "Game/GameCommon.hpp"
+#include "Game/CompletionIndex.hpp"
+#include "Game/DialogueCommand.hpp"
+#include "Game/NameMatcher.hpp"
 
 class Game;
+class Scenario;
+struct ImGuiInputTextCallbackData;
 
 struct LogEntry
 {
@@ -24,12 +29,20 @@ public:
 	void	EndFrame() const;
 	void	AddLog(LogType type, const String& log_message);
 	void	ClearLog();
+	void	SetMentions(DialogueCommand& command);		// the target and subject named in the command's line
 
 private:
 	void	UpdateHistory();
 	void	UpdateInput();
 	
 	void	AddCardTypeCommand(CardType type,  const char* command);
+
+	// Completion of the command and of the names the journal lists, Tab takes the first suggestion
+	void	RefreshCompletions();
+	void	UpdateCompletions(const char* input_line);
+	void	CompleteInput(ImGuiInputTextCallbackData* data);
+	static int InputTextCallback(ImGuiInputTextCallbackData* data);
+
 	void	ExecuteCommand(const char* command_line);
 	void	TextWrapped(const char* fmt, ...);
 	void	TextWrappedV(const char* fmt, va_list args);
@@ -53,4 +66,13 @@ private:
  	char	m_characterCommand[MAX_COMMAND_LENGTH];
  	char	m_itemCommand[MAX_COMMAND_LENGTH];
 
+	CompletionIndex		m_commandCompletions;
+	CompletionIndex		m_cardCompletions[NUM_CARD_TYPES];
+	const Scenario*		m_completionScenario = nullptr;		// rebuilt when the scenario or its names change
+	uint				m_completionLinks = 0;
+	ValidCommands		m_completionCommand = UNKNOWN_COMMAND;	// unknown while the command itself is typed
+	String				m_completionHint = "";
+
+	std::vector<NameMention>	m_mentions;		// kept so a command does not allocate them again
+
 }; 
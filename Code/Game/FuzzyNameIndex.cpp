@@ -0,0 +1,384 @@
+#include "Game/FuzzyNameIndex.hpp"
+#include "Game/CaseFold.hpp"
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+#include <random>
+
+constexpr size_t MAX_FUZZY_NAME_LENGTH = 64;
+constexpr uint FUZZY_BENCHMARK_QUERY_POOL = 1024;
+constexpr uint FUZZY_BENCHMARK_FULL_SCAN_QUERIES = 256;
+
+
+// FNV-1a over a folded name with one byte left out, skip_idx past the end leaves nothing out
+static uint64_t HashFoldedSkipping(const std::string_view folded_name, const size_t skip_idx)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	for (size_t char_idx = 0; char_idx < folded_name.size(); ++char_idx)
+	{
+		if (char_idx != skip_idx)
+		{
+			hash ^= static_cast<unsigned char>(folded_name[char_idx]);
+			hash *= 1099511628211ull;
+		}
+	}
+
+	return hash;
+}
+
+
+// Deleting either of two equal neighbours leaves the same string, only the first one needs a key
+static bool IsRepeatedDeletion(const std::string_view folded_name, const size_t skip_idx)
+{
+	return skip_idx > 0 && skip_idx < folded_name.size() && folded_name[skip_idx] == folded_name[skip_idx - 1];
+}
+
+
+//------------------------------------------------------------
+void FuzzyNameIndex::Build(const std::vector<CardIndexName>& names)
+{
+	Clear();
+	m_names.reserve(names.size());
+
+	for (const CardIndexName& entry : names)
+	{
+		if (entry.m_name.empty() || entry.m_name.size() > MAX_FUZZY_NAME_LENGTH)
+		{
+			continue;
+		}
+
+		const FoldedText folded(entry.m_name);
+		const std::string_view name = folded.GetView();
+
+		const uint32_t name_idx = static_cast<uint32_t>(m_names.size());
+
+		FuzzyName fuzzy_name;
+		fuzzy_name.m_keyOffset = static_cast<uint32_t>(m_keyData.size());
+		fuzzy_name.m_keyLength = static_cast<uint32_t>(name.size());
+		fuzzy_name.m_kind = entry.m_kind;
+		fuzzy_name.m_listIdx = entry.m_listIdx;
+		m_names.push_back(fuzzy_name);
+
+		m_keyData.append(name);
+
+		for (size_t skip_idx = 0; skip_idx <= name.size(); ++skip_idx)
+		{
+			if (!IsRepeatedDeletion(name, skip_idx))
+			{
+				m_keys.push_back({ HashFoldedSkipping(name, skip_idx), name_idx });
+			}
+		}
+	}
+
+	std::sort(m_keys.begin(), m_keys.end(), [](const DeleteKey& lhs, const DeleteKey& rhs)
+	{
+		return lhs.m_hash != rhs.m_hash ? lhs.m_hash < rhs.m_hash : lhs.m_nameIdx < rhs.m_nameIdx;
+	});
+}
+
+
+void FuzzyNameIndex::Clear()
+{
+	m_names.clear();
+	m_keys.clear();
+	m_keyData.clear();
+}
+
+
+bool FuzzyNameIndex::FindNearest(const uint kind_mask, const std::string_view query, CardIndexKind& out_kind, int& out_list_idx,
+	uint* out_num_candidates) const
+{
+	const uint max_distance = GetMaxDistance(query.size());
+	uint best_distance = max_distance + 1;
+	uint32_t best_name_idx = 0;
+	uint num_candidates = 0;
+
+	if (max_distance > 0 && query.size() <= MAX_FUZZY_NAME_LENGTH)
+	{
+		const FoldedText folded(query);
+		const std::string_view folded_query = folded.GetView();
+
+		for (size_t skip_idx = 0; skip_idx <= folded_query.size(); ++skip_idx)
+		{
+			if (IsRepeatedDeletion(folded_query, skip_idx))
+			{
+				continue;
+			}
+
+			DeleteKey query_key;
+			query_key.m_hash = HashFoldedSkipping(folded_query, skip_idx);
+
+			std::vector<DeleteKey>::const_iterator key_itr = std::lower_bound(m_keys.begin(), m_keys.end(), query_key,
+				[](const DeleteKey& lhs, const DeleteKey& rhs) { return lhs.m_hash < rhs.m_hash; });
+
+			for (; key_itr != m_keys.end() && key_itr->m_hash == query_key.m_hash; ++key_itr)
+			{
+				const uint32_t name_idx = key_itr->m_nameIdx;
+				if ((kind_mask & (1u << m_names[name_idx].m_kind)) == 0)
+				{
+					continue;
+				}
+
+				num_candidates++;
+				const uint distance = GetFoldedEditDistance(folded_query, GetName(name_idx), max_distance);
+				if (distance < best_distance || (distance == best_distance && name_idx < best_name_idx))
+				{
+					best_distance = distance;
+					best_name_idx = name_idx;
+				}
+			}
+		}
+	}
+
+	if (out_num_candidates)
+	{
+		*out_num_candidates = num_candidates;
+	}
+
+	if (best_distance > max_distance)
+	{
+		return false;
+	}
+
+	out_kind = m_names[best_name_idx].m_kind;
+	out_list_idx = m_names[best_name_idx].m_listIdx;
+	return true;
+}
+
+
+uint FuzzyNameIndex::GetNumNames() const
+{
+	return static_cast<uint>(m_names.size());
+}
+
+
+uint FuzzyNameIndex::GetNumKeys() const
+{
+	return static_cast<uint>(m_keys.size());
+}
+
+
+// Short words are one typo away from too many others to guess
+STATIC uint FuzzyNameIndex::GetMaxDistance(const size_t query_length)
+{
+	if (query_length < 4)
+	{
+		return 0;
+	}
+
+	return query_length < 8 ? 1 : 2;
+}
+
+
+STATIC uint FuzzyNameIndex::GetEditDistance(const std::string_view lhs, const std::string_view rhs, const uint max_distance)
+{
+	const FoldedText folded_lhs(lhs);
+	const FoldedText folded_rhs(rhs);
+	return GetFoldedEditDistance(folded_lhs.GetView(), folded_rhs.GetView(), max_distance);
+}
+
+
+std::string_view FuzzyNameIndex::GetName(const uint32_t name_idx) const
+{
+	const FuzzyName& fuzzy_name = m_names[name_idx];
+	return std::string_view(m_keyData.data() + fuzzy_name.m_keyOffset, fuzzy_name.m_keyLength);
+}
+
+
+// Optimal string alignment distance on folded bytes: insertions, deletions, substitutions and swaps of two
+// neighbours. Gives up once a whole row is past max_distance.
+STATIC uint FuzzyNameIndex::GetFoldedEditDistance(const std::string_view lhs, const std::string_view rhs, const uint max_distance)
+{
+	const size_t lhs_length = lhs.size();
+	const size_t rhs_length = rhs.size();
+	const size_t length_difference = lhs_length > rhs_length ? lhs_length - rhs_length : rhs_length - lhs_length;
+
+	if (length_difference > max_distance || lhs_length > MAX_FUZZY_NAME_LENGTH || rhs_length > MAX_FUZZY_NAME_LENGTH)
+	{
+		return max_distance + 1;
+	}
+
+	uint rows[3][MAX_FUZZY_NAME_LENGTH + 1];
+	uint* two_rows_up = rows[0];
+	uint* row_up = rows[1];
+	uint* row = rows[2];
+
+	for (size_t rhs_idx = 0; rhs_idx <= rhs_length; ++rhs_idx)
+	{
+		row_up[rhs_idx] = static_cast<uint>(rhs_idx);
+	}
+
+	for (size_t lhs_idx = 1; lhs_idx <= lhs_length; ++lhs_idx)
+	{
+		const char lhs_char = lhs[lhs_idx - 1];
+		row[0] = static_cast<uint>(lhs_idx);
+		uint row_min = row[0];
+
+		for (size_t rhs_idx = 1; rhs_idx <= rhs_length; ++rhs_idx)
+		{
+			const char rhs_char = rhs[rhs_idx - 1];
+			const uint substitution_cost = lhs_char == rhs_char ? 0 : 1;
+
+			uint distance = std::min(std::min(row_up[rhs_idx] + 1, row[rhs_idx - 1] + 1), row_up[rhs_idx - 1] + substitution_cost);
+
+			if (lhs_idx > 1 && rhs_idx > 1
+				&& lhs_char == rhs[rhs_idx - 2]
+				&& lhs[lhs_idx - 2] == rhs_char)
+			{
+				distance = std::min(distance, two_rows_up[rhs_idx - 2] + 1);
+			}
+
+			row[rhs_idx] = distance;
+			row_min = std::min(row_min, distance);
+		}
+
+		if (row_min > max_distance)
+		{
+			return max_distance + 1;
+		}
+
+		uint* const oldest_row = two_rows_up;
+		two_rows_up = row_up;
+		row_up = row;
+		row = oldest_row;
+	}
+
+	return std::min(row_up[rhs_length], max_distance + 1);
+}
+
+
+//------------------------------------------------------------
+// What typing in a hurry does to a name: a wrong, missing, extra or swapped letter, or something else entirely
+static String MakeTypo(const String& name, std::mt19937& rng)
+{
+	String typo = name;
+	const char letter = static_cast<char>('a' + rng() % 26);
+	const size_t char_idx = typo.empty() ? 0 : rng() % typo.size();
+
+	switch (rng() % 5)
+	{
+	case 0:	if (!typo.empty()) { typo[char_idx] = letter; }								break;
+	case 1:	if (!typo.empty()) { typo.erase(char_idx, 1); }								break;
+	case 2:	typo.insert(typo.begin() + char_idx, letter);								break;
+	case 3:	if (char_idx + 1 < typo.size()) { std::swap(typo[char_idx], typo[char_idx + 1]); }	break;
+	default:
+	{
+		typo.clear();
+		const uint length = 6 + rng() % 8;
+		for (uint letter_idx = 0; letter_idx < length; ++letter_idx)
+		{
+			typo.push_back(static_cast<char>('a' + rng() % 26));
+		}
+		break;
+	}
+	}
+
+	return typo;
+}
+
+
+static bool FindNearestByFullScan(const std::vector<CardIndexName>& names, const String& query, uint& out_distance)
+{
+	const uint max_distance = FuzzyNameIndex::GetMaxDistance(query.size());
+	out_distance = max_distance + 1;
+
+	if (max_distance == 0)
+	{
+		return false;
+	}
+
+	for (const CardIndexName& entry : names)
+	{
+		out_distance = std::min(out_distance, FuzzyNameIndex::GetEditDistance(query, entry.m_name, max_distance));
+	}
+
+	return out_distance <= max_distance;
+}
+
+
+void BenchmarkFuzzyNameIndex(const char* label, const std::vector<CardIndexName>& names, const uint num_queries)
+{
+	if (names.empty() || num_queries == 0)
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("%s: no names to match", label));
+		return;
+	}
+
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("%s: %u queries, one typo or a miss each", label, num_queries));
+
+	size_t last_num_names = 0;
+	for (const size_t divisor : { 100, 10, 1 })
+	{
+		const size_t num_names = names.size() / divisor;
+		if (num_names == 0 || num_names == last_num_names)
+		{
+			continue;
+		}
+		last_num_names = num_names;
+
+		const std::vector<CardIndexName> subset(names.begin(), names.begin() + num_names);
+
+		FuzzyNameIndex index;
+		const double build_start = GetCurrentTimeSeconds();
+		index.Build(subset);
+		const double build_seconds = GetCurrentTimeSeconds() - build_start;
+
+		std::mt19937 rng(1);
+		const uint num_distinct_queries = std::min(num_queries, FUZZY_BENCHMARK_QUERY_POOL);
+		StringList queries;
+		queries.reserve(num_distinct_queries);
+		for (uint query_idx = 0; query_idx < num_distinct_queries; ++query_idx)
+		{
+			queries.push_back(MakeTypo(subset[rng() % subset.size()].m_name, rng));
+		}
+
+		const uint all_kinds = (1u << NUM_CARD_INDEX_KINDS) - 1;
+		uint num_hits = 0;
+		uint64_t num_candidates = 0;
+		const double index_start = GetCurrentTimeSeconds();
+		for (uint query_idx = 0; query_idx < num_queries; ++query_idx)
+		{
+			CardIndexKind kind = CARD_INDEX_LOCATION;
+			int list_idx = -1;
+			uint query_candidates = 0;
+			if (index.FindNearest(all_kinds, queries[query_idx % num_distinct_queries], kind, list_idx, &query_candidates))
+			{
+				num_hits++;
+			}
+			num_candidates += query_candidates;
+		}
+		const double index_seconds = GetCurrentTimeSeconds() - index_start;
+
+		// the full scan is the reference for what is within reach. The index finds every match one typo away and the
+		// two typo matches its keys happen to meet
+		const uint num_scan_queries = std::min(num_distinct_queries, FUZZY_BENCHMARK_FULL_SCAN_QUERIES);
+		uint num_scan_hits = 0;
+		uint num_index_hits = 0;
+		double scan_seconds = 0.0;
+		for (uint query_idx = 0; query_idx < num_scan_queries; ++query_idx)
+		{
+			uint scan_distance = 0;
+			const double scan_start = GetCurrentTimeSeconds();
+			const bool is_scan_hit = FindNearestByFullScan(subset, queries[query_idx], scan_distance);
+			scan_seconds += GetCurrentTimeSeconds() - scan_start;
+
+			CardIndexKind kind = CARD_INDEX_LOCATION;
+			int list_idx = -1;
+			if (is_scan_hit)
+			{
+				num_scan_hits++;
+				num_index_hits += index.FindNearest(all_kinds, queries[query_idx], kind, list_idx) ? 1 : 0;
+			}
+		}
+
+		g_theDevConsole->PrintString(Rgba::GREEN, Stringf("\t %7u names  %8u keys  build %8.3f ms  index %8.1f ns/query  %5.1f checked  %u hits",
+			static_cast<uint>(num_names), index.GetNumKeys(), build_seconds * 1000.0, index_seconds * 1e9 / num_queries,
+			static_cast<double>(num_candidates) / num_queries, num_hits));
+		g_theDevConsole->PrintString(Rgba::GREEN, Stringf("\t %7s full scan  %10.1f ns/query  the index matched %u of the %u queries the scan matched",
+			"", scan_seconds * 1e9 / std::max(num_scan_queries, 1u), num_index_hits, num_scan_hits));
+	}
+}
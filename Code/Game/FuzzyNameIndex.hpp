@@ -0,0 +1,64 @@
+#pragma once
+#include "Game/CardIndex.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+// Resolves a misspelled card name to the closest name or nickname, SymSpell style. Every name is indexed under the
+// hash of itself and of each string left by deleting one of its characters, a query looks up the same keys for itself.
+// Two names meet when one deletion on each side makes them equal: every name within one typo (a missing, extra,
+// wrong or swapped character) and many within two. The candidates are then checked with a bounded edit distance.
+// A query costs one binary search per character of the query and a few distance checks, however many names there are.
+
+constexpr uint FUZZY_KIND_LOCATION = 1u << CARD_INDEX_LOCATION;
+constexpr uint FUZZY_KIND_CHARACTER = 1u << CARD_INDEX_CHARACTER;
+constexpr uint FUZZY_KIND_ITEM = 1u << CARD_INDEX_ITEM;
+constexpr uint FUZZY_KIND_INCIDENT = 1u << CARD_INDEX_INCIDENT;
+
+
+//------------------------------------------------------------
+class FuzzyNameIndex
+{
+public:
+	void	Build(const std::vector<CardIndexName>& names);
+	void	Clear();
+
+	// Closest name of any kind in the mask, ties go to the name added first. False when nothing is close enough
+	bool	FindNearest(uint kind_mask, std::string_view query, CardIndexKind& out_kind, int& out_list_idx,
+				uint* out_num_candidates = nullptr) const;
+
+	uint	GetNumNames() const;
+	uint	GetNumKeys() const;
+
+	static uint GetMaxDistance(size_t query_length);
+	static uint GetEditDistance(std::string_view lhs, std::string_view rhs, uint max_distance);	// max_distance + 1 when further
+
+private:
+	struct FuzzyName
+	{
+		uint32_t		m_keyOffset = 0;
+		uint32_t		m_keyLength = 0;
+		CardIndexKind	m_kind = CARD_INDEX_LOCATION;
+		int				m_listIdx = -1;
+	};
+
+	struct DeleteKey
+	{
+		uint64_t	m_hash = 0;
+		uint32_t	m_nameIdx = 0;
+	};
+
+	std::string_view GetName(uint32_t name_idx) const;
+
+	static uint GetFoldedEditDistance(std::string_view lhs, std::string_view rhs, uint max_distance);	// both already folded
+
+private:
+	std::vector<FuzzyName>	m_names;
+	std::vector<DeleteKey>	m_keys;				// sorted by hash
+	String					m_keyData;			// every folded name back to back
+};
+
+
+//------------------------------------------------------------
+// Times FindNearest against checking the edit distance to every name, on a tenth, a hundredth and all of the names
+void BenchmarkFuzzyNameIndex(const char* label, const std::vector<CardIndexName>& names, uint num_queries);
@@ -2,8 +2,18 @@
 #include "Game/App.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Scenario.hpp"
+#include "Game/ScenarioImage.hpp"
+#include "Game/ScenarioCatalog.hpp"
+#include "Game/ScenarioGenerator.hpp"
+#include "Game/CardImage.hpp"
 #include "Game/DialogueSystem.hpp"
+#include "Game/CompletionIndex.hpp"
+#include "Game/CaseFold.hpp"
 
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
 #include "Engine/Math/Matrix44.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 #include "Engine/Renderer/DebugRender.hpp"
@@ -11,6 +21,9 @@
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Renderer/ImGUISystem.hpp"
+#include <charconv>
+#include <filesystem>
+#include <fstream>
 #include <vector>
 
 UNITTEST("Is Test", nullptr, 0)
@@ -35,6 +48,363 @@ UNITTEST("Is false", nullptr, 2)
 }
 
 
+UNITTEST("Card images load lazily", "CardImage", 1)
+{
+	NullCardImageBackend* backend = new NullCardImageBackend();
+	CardImageLoader loader(backend);
+
+	CardImage* image = loader.CreateOrGetImage("woodcrate.jpg");
+	const bool shared_handle = loader.CreateOrGetImage("woodcrate.jpg") == image;
+	const bool deferred = image->GetStatus() == IMAGE_UNLOADED;
+
+	loader.RequestLoad(image);
+	loader.FinishAllLoads();
+
+	return shared_handle && deferred && image->IsReady() && backend->GetNumImagesCreated() == 1;
+}
+
+
+UNITTEST("Completions narrow as the player types", "Completion", 1)
+{
+	CompletionIndex completions;
+	completions.Add("Scotland Yard");
+	completions.Add("Station");
+	completions.Add("scotland yard");
+	completions.Add("Bridge Club");
+	completions.Sort();
+
+	completions.SetPrefix("S");
+	const bool both_s = completions.GetNumMatches() == 2;
+	completions.SetPrefix("sCo");
+	const bool one_sco = completions.GetNumMatches() == 1 && completions.GetMatch(0) == "Scotland Yard";
+	completions.SetPrefix("");
+
+	return both_s && one_sco && completions.GetNumMatches() == 3;
+}
+
+
+UNITTEST("Case folding keeps UTF-8 intact", "CaseFold", 1)
+{
+	String folded;
+	FoldCase("Inspector LESTRADE of Scotland Yard", folded);
+	const bool ascii_folded = folded == "inspector lestrade of scotland yard";
+
+	FoldCase(u8"Café DÉJÀ VU, Ёлка, ΣΟΦΙΑ", folded);
+	const bool utf8_folded = folded == u8"café déjà vu, ёлка, σοφια";
+
+	return ascii_folded && utf8_folded && IsFoldedEqual("NAME", "name") && !IsFoldedEqual("Names", "name");
+}
+
+
+static void WriteTestScenarioFile(const std::filesystem::path& folder, const char* file_name, const char* xml)
+{
+	std::ofstream file(folder / file_name, std::ios::binary);
+	file << xml;
+}
+
+
+UNITTEST("Accented card names link", "CaseFold", 1)
+{
+	// a fresh folder every run, so the scenario is read from the xml and not a cache left behind
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "AccentedCardNames";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+
+	WriteTestScenarioFile(folder, "Locations.xml", u8R"(<Locations>
+		<Location Name="Café Élan" StartingState="Open">
+			<States><State Name="Open" CanMoveHere="true" AddGameTime="true"/></States>
+		</Location>
+	</Locations>)");
+	WriteTestScenarioFile(folder, "Characters.xml", "<Characters/>");
+	WriteTestScenarioFile(folder, "Items.xml", R"(<Items>
+		<Item Name="Journal" StartingState="Not Found">
+			<States><State Name="Not Found" AddGameTime="true"/><State Name="Found" AddGameTime="true"/></States>
+		</Item>
+	</Items>)");
+	WriteTestScenarioFile(folder, "Settings.xml", u8R"(<ScenarioSettings Name="Accents" StartingLocation="Café Élan" StartingTimeInMilitary="09:00">
+		<TimeCostForActions MoveToLocation="20" InvestigateLocation="5" ExamineItem="5" InterrogateCharacter="5" UnknownCommand="5"/>
+	</ScenarioSettings>)");
+	WriteTestScenarioFile(folder, "Incidents.xml", u8R"(<Incidents>
+		<Incident name="Find the journal" type="OneShot" isEnabled="true">
+			<Trigger name="Is the cafe open?">
+				<Conditions><ObjectStateCheck object="Café Élan" type="location" operation="Is" State="Open"/></Conditions>
+				<Actions><SetCardState type="item" name="Journal" fromState="*" toState="Found"/></Actions>
+			</Trigger>
+		</Incident>
+	</Incidents>)");
+	WriteTestScenarioFile(folder, "VictoryConditions.xml", "<VictoryConditions/>");
+
+	Scenario scenario(nullptr);
+	scenario.LoadInScenarioFile(folder.string().c_str());
+
+	int loc_idx = -1;
+	const bool found_folded = scenario.IsLocationInLookupTable(loc_idx, u8"CAFÉ ÉLAN") && loc_idx == 0;
+	const bool is_starting_location = scenario.GetCurrentLocation() == scenario.GetLocationFromList(0);
+
+	// the incident only fires if its condition linked to the location
+	scenario.TestIncidents();
+	const bool condition_linked = scenario.GetItemFromList(0)->GetItemState().m_nameId == scenario.InternName("Found");
+
+	std::filesystem::remove_all(folder);
+	return found_folded && is_starting_location && condition_linked;
+}
+
+
+UNITTEST("Changing the interest tests the context checks again", "Incident", 1)
+{
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "InterestContextCheck";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+
+	WriteTestScenarioFile(folder, "Locations.xml", R"(<Locations>
+		<Location Name="Scotland Yard" StartingState="Open">
+			<States><State Name="Open" CanMoveHere="true" AddGameTime="true"/></States>
+		</Location>
+	</Locations>)");
+	WriteTestScenarioFile(folder, "Characters.xml", R"(<Characters>
+		<Character Name="Chief Officer Doyle" StartingState="At Work" StartLoc="Scotland Yard">
+			<States><State Name="At Work" AddGameTime="true" ContextMode="Interrogation"/></States>
+		</Character>
+	</Characters>)");
+	WriteTestScenarioFile(folder, "Items.xml", R"(<Items>
+		<Item Name="Journal" StartingState="Not Found">
+			<States><State Name="Not Found" AddGameTime="true"/><State Name="Found" AddGameTime="true"/></States>
+		</Item>
+	</Items>)");
+	WriteTestScenarioFile(folder, "Settings.xml", R"(<ScenarioSettings Name="Interest" StartingLocation="Scotland Yard" StartingTimeInMilitary="09:00">
+		<TimeCostForActions MoveToLocation="20" InvestigateLocation="5" ExamineItem="5" InterrogateCharacter="5" UnknownCommand="5"/>
+	</ScenarioSettings>)");
+	WriteTestScenarioFile(folder, "Incidents.xml", R"(<Incidents>
+		<Incident name="Doyle hands over the journal" type="OneShot" isEnabled="true">
+			<Trigger name="Talking to Doyle?">
+				<Conditions><ContextCheck object="Chief Officer Doyle" type="character" condition="Is"/></Conditions>
+				<Actions><SetCardState type="item" name="Journal" fromState="*" toState="Found"/></Actions>
+			</Trigger>
+		</Incident>
+	</Incidents>)");
+	WriteTestScenarioFile(folder, "VictoryConditions.xml", "<VictoryConditions/>");
+
+	Scenario scenario(nullptr);
+	scenario.LoadInScenarioFile(folder.string().c_str());
+	const SymbolId found_id = scenario.InternName("Found");
+
+	scenario.TestIncidents();
+	const bool waited_for_doyle = scenario.GetItemFromList(0)->GetItemState().m_nameId != found_id;
+
+	// nothing else changed, so only the interest can have marked the incident
+	scenario.SetInterest(scenario.GetCharacterFromList(0));
+	scenario.TestIncidents();
+	const bool fired_for_doyle = scenario.GetItemFromList(0)->GetItemState().m_nameId == found_id;
+
+	std::filesystem::remove_all(folder);
+	return waited_for_doyle && fired_for_doyle;
+}
+
+
+UNITTEST("An absolute time condition holds once its minute has passed", "Incident", 1)
+{
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "AbsoluteTimePassed";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+
+	WriteTestScenarioFile(folder, "Locations.xml", R"(<Locations>
+		<Location Name="Scotland Yard" StartingState="Open">
+			<States><State Name="Open" CanMoveHere="true" AddGameTime="true"/></States>
+		</Location>
+	</Locations>)");
+	WriteTestScenarioFile(folder, "Characters.xml", "<Characters/>");
+	WriteTestScenarioFile(folder, "Items.xml", R"(<Items>
+		<Item Name="Journal" StartingState="Not Found">
+			<States><State Name="Not Found" AddGameTime="true"/><State Name="Found" AddGameTime="true"/></States>
+		</Item>
+	</Items>)");
+	WriteTestScenarioFile(folder, "Settings.xml", R"(<ScenarioSettings Name="Time" StartingLocation="Scotland Yard" StartingTimeInMilitary="09:00">
+		<TimeCostForActions MoveToLocation="20" InvestigateLocation="5" ExamineItem="5" InterrogateCharacter="5" UnknownCommand="5"/>
+	</ScenarioSettings>)");
+	WriteTestScenarioFile(folder, "Incidents.xml", R"(<Incidents>
+		<Incident name="The journal turns up at half past nine" type="OneShot" isEnabled="true">
+			<Trigger name="Is it half past nine?">
+				<Conditions><TimePassed since="AbsoluteGameTime" daysPassed="0" hoursPassed="9" minutesPassed="30"/></Conditions>
+				<Actions><SetCardState type="item" name="Journal" fromState="*" toState="Found"/></Actions>
+			</Trigger>
+		</Incident>
+	</Incidents>)");
+	WriteTestScenarioFile(folder, "VictoryConditions.xml", "<VictoryConditions/>");
+
+	Scenario scenario(nullptr);
+	scenario.LoadInScenarioFile(folder.string().c_str());
+	const SymbolId found_id = scenario.InternName("Found");
+
+	scenario.TestIncidents();
+	const bool waited_for_the_time = scenario.GetItemFromList(0)->GetItemState().m_nameId != found_id;
+
+	// step past the minute, it used to only hold on the minute itself
+	scenario.AddGameTime(45, 0);
+	scenario.TestIncidents();
+	const bool fired_after_the_time = scenario.GetItemFromList(0)->GetItemState().m_nameId == found_id;
+
+	std::filesystem::remove_all(folder);
+	return waited_for_the_time && fired_after_the_time;
+}
+
+
+UNITTEST("Asking someone new about something charges once", "Scenario", 1)
+{
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "AskSomeoneNew";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+
+	WriteTestScenarioFile(folder, "Locations.xml", R"(<Locations>
+		<Location Name="Scotland Yard" StartingState="Open">
+			<States><State Name="Open" CanMoveHere="true" AddGameTime="true"/></States>
+			<IntroduceCharacter>
+				<Scan State="*" Character="*" CharacterState="*" Line="Nobody by that name works here."/>
+				<Scan State="*" Character="Chief Officer Doyle" CharacterState="*" Line="Doyle looks up from his desk."/>
+			</IntroduceCharacter>
+		</Location>
+	</Locations>)");
+	WriteTestScenarioFile(folder, "Characters.xml", R"(<Characters>
+		<Character Name="Chief Officer Doyle" StartingState="At Work" StartLoc="Scotland Yard">
+			<Nicknames List="Doyle"/>
+			<States><State Name="At Work" AddGameTime="true" ContextMode="Interrogation"/></States>
+			<CharDialogue><Scan State="*" Loc="*" LocState="*" Char="*" CharState="*" Line="Doyle: Never heard of them."/></CharDialogue>
+			<ItemDialogue><Scan State="*" Loc="*" LocState="*" Item="*" ItemState="*" Line="Doyle: Ask the laboratory."/></ItemDialogue>
+		</Character>
+	</Characters>)");
+	WriteTestScenarioFile(folder, "Items.xml", R"(<Items>
+		<Item Name="Knife" StartingState="Found"><States><State Name="Found" AddGameTime="true"/></States></Item>
+	</Items>)");
+	WriteTestScenarioFile(folder, "Settings.xml", R"(<ScenarioSettings Name="Ask" StartingLocation="Scotland Yard" StartingTimeInMilitary="09:00">
+		<TimeCostForActions MoveToLocation="20" InvestigateLocation="5" ExamineItem="5" InterrogateCharacter="5" UnknownCommand="5"/>
+	</ScenarioSettings>)");
+	WriteTestScenarioFile(folder, "Incidents.xml", "<Incidents/>");
+	WriteTestScenarioFile(folder, "VictoryConditions.xml", "<VictoryConditions/>");
+
+	Scenario scenario(nullptr);
+	scenario.LoadInScenarioFile(folder.string().c_str());
+	DialogueSystem ds(nullptr);
+
+	DialogueCommand command;
+	command.m_verb = ASK_CHARACTER;
+	command.m_line = "doyle about the knife";
+	command.m_card = "doyle";
+	command.m_target = "doyle";
+	command.m_subject = "knife";
+	command.m_scenario = &scenario;
+	command.m_dialogueSystem = &ds;
+
+	// the handler is the one the dialogue system fires, subscribed to a table of its own
+	DialogueCommandTable commands;
+	Scenario::SubscribeDialogueCommands(commands);
+
+	const int start_minutes = GetGameTimeInMinutes(scenario.GetCurrentTime());
+	commands.Fire(command);
+	const int minutes_spent = GetGameTimeInMinutes(scenario.GetCurrentTime()) - start_minutes;
+
+	const bool is_talking_to_doyle = scenario.GetCurrentInterest() == scenario.GetCharacterFromList(0);
+
+	std::filesystem::remove_all(folder);
+	return is_talking_to_doyle && minutes_spent == static_cast<int>(scenario.GetInterrogateChangeTime());
+}
+
+
+STATIC bool ListScenarios(EventArgs& args)
+{
+	UNUSED(args);
+
+	const ScenarioCatalog* catalog = g_theApp->GetTheGame()->GetScenarioCatalog();
+	const uint num_entries = catalog->GetNumEntries();
+
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("%u scenarios, scanned in %.3f ms (%u settings headers read)",
+		num_entries, catalog->GetLastScanSeconds() * 1000.0, catalog->GetNumHeadersReadOnLastScan()));
+
+	for (uint entry_idx = 0; entry_idx < num_entries; ++entry_idx)
+	{
+		const ScenarioCatalogEntry& entry = catalog->GetEntry(entry_idx);
+		g_theDevConsole->PrintString(Rgba::GREEN, Stringf("\t %u: %s (%s), starts at %s",
+			entry_idx, entry.m_name.c_str(), entry.m_folderName.c_str(), entry.m_startingLocation.c_str()));
+	}
+
+	return true;
+}
+
+
+STATIC bool LoadScenarioFromCatalog(EventArgs& args)
+{
+	Game* the_game = g_theApp->GetTheGame();
+	const String scenario_name = args.GetValue("scenario", String(""));
+	int catalog_idx = the_game->GetScenarioCatalog()->FindEntry(scenario_name);
+
+	// the index printed by list_scenarios works too, one too big to fit is no scenario either
+	if (catalog_idx < 0 && !scenario_name.empty())
+	{
+		const char* name_end = scenario_name.data() + scenario_name.size();
+		const std::from_chars_result parsed = std::from_chars(scenario_name.data(), name_end, catalog_idx);
+		if (parsed.ec != std::errc() || parsed.ptr != name_end)
+		{
+			catalog_idx = -1;
+		}
+	}
+
+	if (catalog_idx < 0 || catalog_idx >= static_cast<int>(the_game->GetScenarioCatalog()->GetNumEntries()))
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("No scenario called %s, try list_scenarios", scenario_name.c_str()));
+		return false;
+	}
+
+	the_game->RequestScenario(catalog_idx);
+	return true;
+}
+
+
+STATIC bool GenerateScenario(EventArgs& args)
+{
+	ScenarioGeneratorSettings settings;
+	settings.m_seed = static_cast<uint>(args.GetValue("seed", 1));
+
+	// counts given by name override the scaled ones
+	const int scale = args.GetValue("scale", 1);
+	settings.ScaleCounts(static_cast<uint>(scale > 0 ? scale : 1));
+
+	settings.m_numLocations = static_cast<uint>(args.GetValue("locations", static_cast<int>(settings.m_numLocations)));
+	settings.m_numCharacters = static_cast<uint>(args.GetValue("characters", static_cast<int>(settings.m_numCharacters)));
+	settings.m_numItems = static_cast<uint>(args.GetValue("items", static_cast<int>(settings.m_numItems)));
+	settings.m_statesPerCard = static_cast<uint>(args.GetValue("states", static_cast<int>(settings.m_statesPerCard)));
+	settings.m_scanRulesPerCard = static_cast<uint>(args.GetValue("rules", static_cast<int>(settings.m_scanRulesPerCard)));
+	settings.m_numIncidents = static_cast<uint>(args.GetValue("incidents", static_cast<int>(settings.m_numIncidents)));
+	settings.m_triggersPerIncident = static_cast<uint>(args.GetValue("triggers", static_cast<int>(settings.m_triggersPerIncident)));
+	settings.m_conditionsPerTrigger = static_cast<uint>(args.GetValue("conditions", static_cast<int>(settings.m_conditionsPerTrigger)));
+	settings.m_actionsPerTrigger = static_cast<uint>(args.GetValue("actions", static_cast<int>(settings.m_actionsPerTrigger)));
+
+	const String default_folder = Stringf("%s/Generated_%ix_seed%u", SCENARIO_ROOT_FOLDER, scale, settings.m_seed);
+	const String folder_dir = args.GetValue("folder", default_folder);
+
+	const double generate_start = GetCurrentTimeSeconds();
+	ScenarioGenerator generator(settings);
+	if (!generator.WriteScenarioFolder(folder_dir))
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("Failed to generate %s", folder_dir.c_str()));
+		return false;
+	}
+
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Generated %s in %.3f ms: %u locations, %u characters, %u items, %u incidents",
+		folder_dir.c_str(), (GetCurrentTimeSeconds() - generate_start) * 1000.0,
+		settings.m_numLocations, settings.m_numCharacters, settings.m_numItems, settings.m_numIncidents));
+
+	g_theApp->GetTheGame()->RescanScenarios();
+	return true;
+}
+
+
+STATIC bool ShowScenarioMenu(EventArgs& args)
+{
+	UNUSED(args);
+
+	g_theApp->GetTheGame()->ToggleScenarioMenu();
+	return true;
+}
+
+
 Game::Game() = default;
 Game::~Game() = default;
 
@@ -43,6 +413,11 @@ void Game::Startup()
 {	
 	InitCamera();
 	InitGameObjs();
+
+	g_theEventSystem->SubscribeEventCallbackFunction("list_scenarios", ListScenarios);
+	g_theEventSystem->SubscribeEventCallbackFunction("load_scenario", LoadScenarioFromCatalog);
+	g_theEventSystem->SubscribeEventCallbackFunction("scenario_menu", ShowScenarioMenu);
+	g_theEventSystem->SubscribeEventCallbackFunction("generate_scenario", GenerateScenario);
 }
 
 
@@ -53,6 +428,12 @@ void Game::Shutdown()
 	delete m_currentScenario;
 	m_currentScenario = nullptr;
 
+	delete m_scenarioCatalog;
+	m_scenarioCatalog = nullptr;
+
+	delete g_theCardImageLoader;
+	g_theCardImageLoader = nullptr;
+
 	delete m_quad;
 	m_quad = nullptr;
 	
@@ -79,8 +460,20 @@ void Game::Update(const double delta_seconds)
 	m_time += static_cast<float>(delta_seconds);
 	m_currentFrame++;
 
+	if (m_requestedScenarioIdx >= 0)
+	{
+		LoadScenario(m_requestedScenarioIdx);
+		m_requestedScenarioIdx = -1;
+	}
+
+	g_theCardImageLoader->Update();
 	m_currentScenario->Update(delta_seconds);
 	m_dialogueSystem->Update(delta_seconds);
+
+	if (m_showScenarioMenu)
+	{
+		UpdateScenarioMenu();
+	}
 }
 
 
@@ -183,6 +576,35 @@ DialogueSystem* Game::GetDialogueSystem() const
 }
 
 
+const ScenarioCatalog* Game::GetScenarioCatalog() const
+{
+	return m_scenarioCatalog;
+}
+
+
+void Game::RequestScenario(const int catalog_idx)
+{
+	m_requestedScenarioIdx = catalog_idx;
+}
+
+
+void Game::ToggleScenarioMenu()
+{
+	m_showScenarioMenu = !m_showScenarioMenu;
+}
+
+
+// Entries can move when folders are added, keep pointing at the scenario that is running
+void Game::RescanScenarios()
+{
+	const String current_folder = m_currentScenarioIdx >= 0 ? m_scenarioCatalog->GetEntry(m_currentScenarioIdx).m_folderName : "";
+
+	m_scenarioCatalog->Scan();
+	m_currentScenarioIdx = m_scenarioCatalog->FindEntry(current_folder);
+	m_requestedScenarioIdx = -1;
+}
+
+
 void Game::GarbageCollection() const
 {
 	// USED TO CLEAN UP UNUSED ENTITIES
@@ -211,11 +633,71 @@ void Game::InitGameObjs()
 	m_quad = new GPUMesh(g_theRenderer);
 	m_quad->CreateFromCPUMesh<Vertex_Lit>(quad_mesh); // we won't be updated this;
 
+	// Card images load on demand, without a renderer they are read but never uploaded
+	CardImageBackend* image_backend = nullptr;
+	if (g_theRenderer != nullptr)
+	{
+		image_backend = new RendererCardImageBackend();
+	}
+	else
+	{
+		image_backend = new NullCardImageBackend();
+	}
+	g_theCardImageLoader = new CardImageLoader(image_backend);
+
 	// Create the Game objects
 	m_dialogueSystem = new DialogueSystem(this);
-	m_currentScenario = new Scenario(this);
+
+	// only the settings headers are read here, the chosen scenario is loaded in full below
+	m_scenarioCatalog = new ScenarioCatalog();
+	m_scenarioCatalog->Scan();
+
+	const int default_idx = m_scenarioCatalog->GetDefaultEntryIndex();
+	ASSERT_OR_DIE(default_idx >= 0, Stringf("No scenarios found in %s", SCENARIO_ROOT_FOLDER));
 
 	//m_currentScenario->LoadInScenarioManually();
-	m_currentScenario->LoadInScenarioFile("Data/Scenarios/Tutorial");
+	LoadScenario(default_idx);
+}
+
+
+void Game::LoadScenario(const int catalog_idx)
+{
+	const ScenarioCatalogEntry& entry = m_scenarioCatalog->GetEntry(static_cast<uint>(catalog_idx));
+
+	if (m_currentScenario != nullptr)
+	{
+		m_currentScenario->Shutdown();
+		delete m_currentScenario;
+	}
+
+	m_currentScenario = new Scenario(this);
+
+	const String image_path = entry.m_folderDir + "/" + SCENARIO_IMAGE_FILE_NAME;
+	if (!m_currentScenario->LoadInScenarioImage(image_path.c_str()))
+	{
+		m_currentScenario->LoadInScenarioFileParallel(entry.m_folderDir.c_str());
+	}
 	m_currentScenario->Startup();
+	m_currentScenarioIdx = catalog_idx;
+}
+
+
+void Game::UpdateScenarioMenu()
+{
+	ImGui::Begin("Scenarios", &m_showScenarioMenu, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoSavedSettings);
+
+	const uint num_entries = m_scenarioCatalog->GetNumEntries();
+	for (uint entry_idx = 0; entry_idx < num_entries; ++entry_idx)
+	{
+		const ScenarioCatalogEntry& entry = m_scenarioCatalog->GetEntry(entry_idx);
+		const bool is_current = static_cast<int>(entry_idx) == m_currentScenarioIdx;
+
+		if (ImGui::Selectable(Stringf("%s##%s", entry.m_name.c_str(), entry.m_folderName.c_str()).c_str(), is_current) && !is_current)
+		{
+			RequestScenario(static_cast<int>(entry_idx));
+			m_showScenarioMenu = false;
+		}
+	}
+
+	ImGui::End();
 }
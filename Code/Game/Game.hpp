@@ -5,6 +5,7 @@
 class Camera;
 class DialogueSystem;
 class Scenario;
+class ScenarioCatalog;
 class Material;
 class Shader;
 class GPUMesh;
@@ -34,10 +35,17 @@ public:
 	Scenario*		GetCurrentScenario() const;
 	DialogueSystem* GetDialogueSystem() const;
 
+	const ScenarioCatalog*	GetScenarioCatalog() const;
+	void					RequestScenario(int catalog_idx);	// swapped in at the start of the next update
+	void					ToggleScenarioMenu();
+	void					RescanScenarios();
+
 private:
 	void GarbageCollection() const;
 	void InitCamera();
 	void InitGameObjs();
+	void LoadScenario(int catalog_idx);
+	void UpdateScenarioMenu();
 
 private:
 
@@ -53,6 +61,12 @@ private:
 	DialogueSystem* m_dialogueSystem = nullptr;
 	Scenario* m_currentScenario = nullptr;
 
+	// Scenario selection
+	ScenarioCatalog* m_scenarioCatalog = nullptr;
+	int m_currentScenarioIdx = -1;
+	int m_requestedScenarioIdx = -1;
+	bool m_showScenarioMenu = false;
+
 	// TODO: put in a Background obj
 	Material* m_woodMaterial = nullptr;
 	Shader* m_defaultShader = nullptr;
@@ -1,6 +1,6 @@
 #include "Game/GameCommon.hpp"
 
-EventSystem* g_theDialogueEventSystem = nullptr;
+DialogueCommandTable* g_theDialogueCommands = nullptr;
 
 int StringCompare(const char* str1, const char* str2)
 {
@@ -42,3 +42,24 @@ void StringTrim(char* str)
 
 	*str_end = 0;
 }
+
+
+uint HashBytes(const void* data, const size_t size, const uint seed)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint hash = seed;
+
+	for (size_t byte_idx = 0; byte_idx < size; ++byte_idx)
+	{
+		hash ^= bytes[byte_idx];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+
+int GetGameTimeInMinutes(const GameTime& time)
+{
+	return static_cast<int>(time.m_min) + 60 * static_cast<int>(time.m_hour) + 1440 * static_cast<int>(time.m_day);
+}
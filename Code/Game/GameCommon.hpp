@@ -14,10 +14,11 @@ class AudioSystem;
 //Game related globals
 //--------------------------------------------------
 class App;
+class DialogueCommandTable;
 
 // global game components
 extern App* g_theApp;
-extern EventSystem* g_theDialogueEventSystem;
+extern DialogueCommandTable* g_theDialogueCommands;
 
 // key codes
 constexpr int SHIFT_KEY = 16;
@@ -98,6 +99,7 @@ constexpr int	MAX_COMMAND_LENGTH = 16;
 int		StringCompare(const char* str1, const char* str2);
 int		StringNCompare(const char* str1, const char* str2, int first_n_chars);
 void	StringTrim(char* str);
+uint	HashBytes(const void* data, size_t size, uint seed = 2166136261u); // FNV-1a, pass a previous hash as the seed to chain
 
 //--------------------------------------------------
 //Scenario related globals
@@ -118,20 +120,17 @@ class Trigger;
 class Condition;
 class Action;
 class VictoryCondition;
+class ScenarioImageWriter;
+class ScenarioImageReader;
 
 
 typedef std::string							String;
 typedef std::vector<String>					StringList;
-typedef std::pair<String, int>				Lookup;
 typedef std::map<String, int>				LookupTable;
-typedef std::map<String, int>::iterator		LookupItr;
 typedef std::vector<Location>				LocationList;
 typedef std::vector<Item>					ItemList;
 typedef std::vector<Character>				CharacterList;
-typedef std::vector<LocationState>			LocStateList;
 typedef std::vector<IntroFromLocation>		Intros;
-typedef std::vector<CharacterState>			CharStateList;
-typedef std::vector<ItemState>				ItemStateList;
 typedef std::vector<Incident>				IncidentList;
 typedef std::vector<Trigger*>				TriggerList;
 typedef std::vector<Condition*>				ConditionList;
@@ -139,6 +138,12 @@ typedef std::vector<Action*>				ActionList;
 typedef std::vector<CharacterDialogue>		CharacterDialogueList;
 typedef std::vector<VictoryCondition>		VictoryConditions;
 
+// Interned, case folded names, see SymbolTable
+typedef uint								SymbolId;
+constexpr SymbolId SYMBOL_EMPTY = 0;			// ""
+constexpr SymbolId SYMBOL_WILDCARD = 1;			// "*"
+constexpr SymbolId INVALID_SYMBOL = 0xFFFFFFFFu;	// never interned, never matches
+
 inline char g_locationHeader[] = "Heading to: ";
 inline char g_characterHeader[] = "Interrogating: ";
 inline char g_itemHeader[] = "Found Item: ";
@@ -216,6 +221,17 @@ enum ConditionType
 	NUM_CONDITION_TYPES
 };
 
+enum ActionType
+{
+	ACTION_UNKNOWN = -1,
+
+	ACTION_DISPLAY_TEXT,
+	ACTION_CHANGE_CARD_STATE,
+	ACTION_INCIDENT_TOGGLE,
+
+	NUM_ACTION_TYPES
+};
+
 enum LocationSpecialAction
 {
 	LSA_NONE = -1,
@@ -282,3 +298,5 @@ struct GameTime
 	uint		m_day = 0; // 1 - inf
 };
 
+int		GetGameTimeInMinutes(const GameTime& time);
+
@@ -1,12 +1,20 @@
 //Incident.cpp
 #include "Game/Incident.hpp"
 #include "Game/Scenario.hpp"
+#include "Game/ScenarioImage.hpp"
+#include "Game/IncidentProgram.hpp"
 
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/DevConsole.hpp"
 
 Incident::Incident(Scenario* the_setup, const XmlElement* element) : m_theScenario(the_setup)
+{
+	ImportFromXml(element);
+}
+
+
+void Incident::ImportFromXml(const XmlElement* element)
 {
 	m_triggers = TriggerList();
 
@@ -61,7 +69,7 @@ Incident::Incident(Scenario* the_setup, const XmlElement* element) : m_theScenar
 
 		if (element_name == "trigger")
 		{
-			m_triggers.push_back(new Trigger(this, child_element));
+			m_triggers.push_back(m_theScenario->GetArena().Create<Trigger>(this, child_element));
 		}
 		else
 		{
@@ -71,14 +79,71 @@ Incident::Incident(Scenario* the_setup, const XmlElement* element) : m_theScenar
 }
 
 
+Incident::Incident(Scenario* the_setup, ScenarioImageReader& reader) : m_theScenario(the_setup)
+{
+	m_name = reader.ReadString();
+	m_type = static_cast<IncidentType>(reader.ReadI32());
+	m_isEnabled = reader.ReadBool();
+
+	if (m_isEnabled && m_theScenario != nullptr)
+	{
+		m_timeAtActive = m_theScenario->GetCurrentTime();
+	}
+
+	const uint num_triggers = reader.ReadU32();
+	m_triggers.reserve(num_triggers);
+	for (uint trigger_idx = 0; trigger_idx < num_triggers; ++trigger_idx)
+	{
+		m_triggers.push_back(m_theScenario->GetArena().Create<Trigger>(this, reader));
+	}
+}
+
+
+// the triggers belong to the scenario arena
 Incident::~Incident()
 {
+}
+
+
+// Rebuilds the triggers from the edited xml element, whether the incident is enabled is live state and is kept
+void Incident::ReloadFromXml(const XmlElement* element)
+{
+	const bool was_enabled = m_isEnabled;
+	const GameTime time_at_active = m_timeAtActive;
+
+	// the old triggers stay in the arena until the scenario is released, reloads are rare enough to not matter
+	m_triggers.clear();
+
+	ImportFromXml(element);
+
+	m_isEnabled = was_enabled;
+	m_timeAtActive = time_at_active;
+}
+
+
+void Incident::LinkReferences(StringList& out_errors)
+{
+	const String referrer = Stringf("Incident %s", m_name.c_str());
+
+	const uint num_triggers = static_cast<uint>(m_triggers.size());
+	for (uint trigger_idx = 0; trigger_idx < num_triggers; ++trigger_idx)
+	{
+		m_triggers[trigger_idx]->LinkReferences(referrer, out_errors);
+	}
+}
+
+
+void Incident::CompileInto(IncidentProgram& program, const int incident_idx) const
+{
+	program.BeginIncident(incident_idx);
+
 	const uint num_triggers = static_cast<uint>(m_triggers.size());
 	for (uint trigger_idx = 0; trigger_idx < num_triggers; ++trigger_idx)
 	{
-		delete m_triggers[trigger_idx];
-		m_triggers[trigger_idx] = nullptr;
+		m_triggers[trigger_idx]->CompileInto(program, static_cast<int>(trigger_idx));
 	}
+
+	program.EndIncident();
 }
 
 
@@ -87,36 +152,26 @@ void Incident::SetActive(const bool enable)
 	m_isEnabled = enable;
 
 	m_timeAtActive = m_theScenario->GetCurrentTime();
+	m_theScenario->OnIncidentChanged(this);
 }
 
 
-bool Incident::TestTriggers()
+void Incident::SetActiveSince(const bool enable, const GameTime& time_at_active)
 {
-	if (!m_isEnabled)
-	{
-		return false;
-	}
+	m_isEnabled = enable;
+	m_timeAtActive = time_at_active;
+	m_theScenario->OnIncidentChanged(this);
+}
 
-	const uint num_triggers = static_cast<uint>(m_triggers.size());
 
-	// A set of triggers in an Incident means using logical 'or'
-	for (uint trigger_idx = 0; trigger_idx < num_triggers; ++trigger_idx)
+void Incident::OnTriggerFired(const uint trigger_idx)
+{
+	if (m_type == INCIDENT_OCCUR_ONCE)
 	{
-		const bool triggered = m_triggers[trigger_idx]->Execute();
-
-		if (triggered)
-		{
-			if(m_type == INCIDENT_OCCUR_ONCE)
-			{
-				m_isEnabled = false;
-			}
-			
-			PrintToDevConsole(m_triggers[trigger_idx]);
-			return true;
-		}
+		m_isEnabled = false;
 	}
 
-	return false;
+	PrintToDevConsole(m_triggers[trigger_idx]);
 }
 
 
@@ -132,7 +187,7 @@ Scenario* Incident::GetOwner() const
 }
 
 
-String Incident::GetName() const
+const String& Incident::GetName() const
 {
 	return m_name;
 }
@@ -163,5 +218,20 @@ void Incident::PrintToDevConsole(const Trigger* trigger_triggered) const
 }
 
 
+void Incident::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(m_name);
+	writer.WriteI32(m_type);
+	writer.WriteBool(m_isEnabled);
+
+	const uint num_triggers = static_cast<uint>(m_triggers.size());
+	writer.WriteU32(num_triggers);
+	for (uint trigger_idx = 0; trigger_idx < num_triggers; ++trigger_idx)
+	{
+		m_triggers[trigger_idx]->WriteToImage(writer);
+	}
+}
+
+
 
 
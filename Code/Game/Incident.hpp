@@ -4,25 +4,35 @@
 #include "Game/Trigger.hpp"
 
 class Scenario;
+class IncidentProgram;
 
 class Incident
 {
 public:
 	explicit Incident(Scenario* the_setup, const XmlElement* element);
+	explicit Incident(Scenario* the_setup, ScenarioImageReader& reader);
 	~Incident();
 
 	//mutators
 	void		SetActive(bool enable);
-	bool		TestTriggers(); // for loop triggers, return true if at least one trigger activates, which will also perform accompany action(s).
+	void		SetActiveSince(bool enable, const GameTime& time_at_active);
+	void		ReloadFromXml(const XmlElement* element);
+	void		LinkReferences(StringList& out_errors);
+	void		CompileInto(IncidentProgram& program, int incident_idx) const;
+	void		OnTriggerFired(uint trigger_idx);	// the trigger passed and its actions ran
 
 	//accessors
 	bool				IsIncidentEnabled() const; // return isEnabled
 	Scenario*			GetOwner() const;
-	String				GetName() const;
+	const String&		GetName() const;
 	IncidentType		GetType() const;
 	const TriggerList*	GetTriggerList() const;
 	GameTime			GetActivatedTime() const;
 	void				PrintToDevConsole(const Trigger* trigger_triggered) const;
+	void				WriteToImage(ScenarioImageWriter& writer) const;
+
+private:
+	void ImportFromXml(const XmlElement* element);
 
 private:
 	Scenario*				m_theScenario = nullptr;
@@ -0,0 +1,668 @@
+#include "Game/IncidentProgram.hpp"
+#include "Game/Scenario.hpp"
+#include "Game/Location.hpp"
+#include "Game/Character.hpp"
+#include "Game/Item.hpp"
+#include "Game/Incident.hpp"
+#include "Game/Condition.hpp"
+#include "Game/Action.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+
+static constexpr uint PENDING_JUMP = 0xFFFFFFFFu;
+static constexpr uint INCIDENTS_PER_DIRTY_WORD = 64;
+
+
+static SymbolId GetCardStateId(Scenario& the_scenario, const CardType card_type, const int card_idx)
+{
+	switch (card_type)
+	{
+		case CARD_LOCATION:		return the_scenario.GetLocationFromList(card_idx)->GetLocationState().m_nameId;
+		case CARD_CHARACTER:	return the_scenario.GetCharacterFromList(card_idx)->GetCharacterState().m_nameId;
+		case CARD_ITEM:			return the_scenario.GetItemFromList(card_idx)->GetItemState().m_nameId;
+		default:				return INVALID_SYMBOL;
+	}
+}
+
+
+static const Card* GetCard(Scenario& the_scenario, const CardType card_type, const int card_idx)
+{
+	switch (card_type)
+	{
+		case CARD_LOCATION:		return the_scenario.GetLocationFromList(card_idx);
+		case CARD_CHARACTER:	return the_scenario.GetCharacterFromList(card_idx);
+		case CARD_ITEM:			return the_scenario.GetItemFromList(card_idx);
+		default:				return nullptr;
+	}
+}
+
+
+static uint GetLowestSetBit(const uint64_t word)
+{
+#if defined(_MSC_VER)
+	unsigned long bit_idx = 0;
+	_BitScanForward64(&bit_idx, word);
+	return static_cast<uint>(bit_idx);
+#else
+	return static_cast<uint>(__builtin_ctzll(word));
+#endif
+}
+
+
+static uint GetNumSetBits(uint64_t word)
+{
+	uint num_bits = 0;
+	for (; word != 0; word &= word - 1)
+	{
+		num_bits++;
+	}
+
+	return num_bits;
+}
+
+
+static void SetIncidentBit(std::vector<uint64_t>& bits, const uint incident_idx)
+{
+	bits[incident_idx / INCIDENTS_PER_DIRTY_WORD] |= 1ull << (incident_idx % INCIDENTS_PER_DIRTY_WORD);
+}
+
+
+static bool IsIncidentBitSet(const std::vector<uint64_t>& bits, const uint incident_idx)
+{
+	return (bits[incident_idx / INCIDENTS_PER_DIRTY_WORD] >> (incident_idx % INCIDENTS_PER_DIRTY_WORD)) & 1ull;
+}
+
+
+//------------------------------------------------------------
+// The indices the program holds are the ones bound by the link pass, so this has to run after it
+void IncidentProgram::Compile(Scenario& the_scenario)
+{
+	Clear();
+
+	const IncidentList& incidents = *the_scenario.GetIncidentList();
+
+	const uint num_incidents = static_cast<uint>(incidents.size());
+	m_alwaysDirty.assign((num_incidents + INCIDENTS_PER_DIRTY_WORD - 1) / INCIDENTS_PER_DIRTY_WORD, 0);
+	m_interestReaders.assign(m_alwaysDirty.size(), 0);
+
+	for (uint inc_idx = 0; inc_idx < num_incidents; ++inc_idx)
+	{
+		incidents[inc_idx].CompileInto(*this, static_cast<int>(inc_idx));
+		ScheduleSinceEnabled(static_cast<int>(inc_idx), GetGameTimeInMinutes(incidents[inc_idx].GetActivatedTime()));
+	}
+	m_incidentBegins.push_back(static_cast<uint>(m_instructions.size()));
+
+	const Location* current_location = the_scenario.GetCurrentLocation();
+	m_playerLocationIdx = current_location != nullptr ? the_scenario.GetLocationListIdx(current_location) : -1;
+
+	// the joins start from the state the scenario is in now
+	for (SharedCondition& shared : m_sharedConditions)
+	{
+		shared.m_isTrue = IsSharedConditionTrue(the_scenario, shared);
+		for (const SharedConditionUse& use : shared.m_uses)
+		{
+			if (shared.m_isTrue == use.m_negated)
+			{
+				m_triggerJoins[use.m_triggerJoin].m_numFalse++;
+			}
+		}
+	}
+
+	// nothing has been tested against it either
+	MarkAllDirty();
+}
+
+
+void IncidentProgram::Clear()
+{
+	m_instructions.clear();
+	m_conditions.clear();
+	m_actions.clear();
+	m_incidentBegins.clear();
+	m_triggerTests.clear();
+	m_incidentFires.clear();
+
+	m_sharedConditions.clear();
+	m_triggerJoins.clear();
+	for (std::vector<std::vector<uint>>& card_shared_conditions : m_cardSharedConditions)
+	{
+		card_shared_conditions.clear();
+	}
+	m_locationSharedConditions.clear();
+	m_playerLocationIdx = -1;
+	m_sinceEnabledMinutes.clear();
+	m_deadlines = {};
+
+	m_dirtyIncidents.clear();
+	m_alwaysDirty.clear();
+	m_interestReaders.clear();
+}
+
+
+uint IncidentProgram::Run(Scenario& the_scenario, const bool run_actions) const
+{
+	if (m_incidentBegins.empty())
+	{
+		return 0;
+	}
+
+	return Execute(the_scenario, 0, m_incidentBegins.back(), run_actions);
+}
+
+
+// Lowest index first like Run. An incident marked by an action while this runs is tested in this run when it comes
+// later in the list and in the next one otherwise, the same as a full pass would see the change.
+uint IncidentProgram::RunDirty(Scenario& the_scenario, const bool run_actions)
+{
+	uint num_fired = 0;
+
+	for (int inc_idx = FindNextDirty(0); inc_idx >= 0; inc_idx = FindNextDirty(static_cast<uint>(inc_idx) + 1))
+	{
+		m_dirtyIncidents[inc_idx / INCIDENTS_PER_DIRTY_WORD] &= ~(1ull << (inc_idx % INCIDENTS_PER_DIRTY_WORD));
+
+		const bool fired = Execute(the_scenario, m_incidentBegins[inc_idx], m_incidentBegins[inc_idx + 1], run_actions) > 0;
+		if (fired)
+		{
+			num_fired++;
+		}
+
+		// a multiple incident fires again every turn its conditions hold
+		const bool keep_dirty = IsIncidentBitSet(m_alwaysDirty, inc_idx)
+			|| (fired && the_scenario.GetIncidentFromList(inc_idx)->IsIncidentEnabled());
+		if (keep_dirty)
+		{
+			SetIncidentBit(m_dirtyIncidents, inc_idx);
+		}
+	}
+
+	return num_fired;
+}
+
+
+//------------------------------------------------------------
+// Out of range indices are a scenario still loading, the compile at the end of it reads every state
+void IncidentProgram::UpdateCardState(const CardType card_type, const int card_idx, const SymbolId state_id)
+{
+	if (card_type < 0 || card_type >= NUM_CARD_TYPES || card_idx < 0)
+	{
+		return;
+	}
+
+	const std::vector<std::vector<uint>>& card_shared_conditions = m_cardSharedConditions[card_type];
+	if (card_idx >= static_cast<int>(card_shared_conditions.size()))
+	{
+		return;
+	}
+
+	for (const uint shared_idx : card_shared_conditions[card_idx])
+	{
+		SetSharedCondition(shared_idx, m_sharedConditions[shared_idx].m_stateId == state_id);
+	}
+}
+
+
+void IncidentProgram::UpdatePlayerLocation(const int loc_idx)
+{
+	if (loc_idx == m_playerLocationIdx)
+	{
+		return;
+	}
+
+	const int num_locations = static_cast<int>(m_locationSharedConditions.size());
+	if (m_playerLocationIdx >= 0 && m_playerLocationIdx < num_locations && m_locationSharedConditions[m_playerLocationIdx] >= 0)
+	{
+		SetSharedCondition(static_cast<uint>(m_locationSharedConditions[m_playerLocationIdx]), false);
+	}
+
+	m_playerLocationIdx = loc_idx;
+	if (loc_idx >= 0 && loc_idx < num_locations && m_locationSharedConditions[loc_idx] >= 0)
+	{
+		SetSharedCondition(static_cast<uint>(m_locationSharedConditions[loc_idx]), true);
+	}
+}
+
+
+void IncidentProgram::AdvanceTime(const int now_minutes)
+{
+	while (!m_deadlines.empty() && m_deadlines.top().m_minute <= now_minutes)
+	{
+		SetIncidentBit(m_dirtyIncidents, static_cast<uint>(m_deadlines.top().m_incidentIdx));
+		m_deadlines.pop();
+	}
+}
+
+
+void IncidentProgram::MarkIncidentChanged(const int incident_idx, const int enabled_minutes)
+{
+	if (incident_idx >= 0 && incident_idx + 1 < static_cast<int>(m_incidentBegins.size()))
+	{
+		SetIncidentBit(m_dirtyIncidents, static_cast<uint>(incident_idx));
+		ScheduleSinceEnabled(incident_idx, enabled_minutes);
+	}
+}
+
+
+void IncidentProgram::MarkInterestChanged()
+{
+	const size_t num_words = std::min(m_dirtyIncidents.size(), m_interestReaders.size());
+	for (size_t word_idx = 0; word_idx < num_words; ++word_idx)
+	{
+		m_dirtyIncidents[word_idx] |= m_interestReaders[word_idx];
+	}
+}
+
+
+void IncidentProgram::MarkAllDirty()
+{
+	const uint num_incidents = m_incidentBegins.empty() ? 0 : static_cast<uint>(m_incidentBegins.size() - 1);
+	m_dirtyIncidents.assign((num_incidents + INCIDENTS_PER_DIRTY_WORD - 1) / INCIDENTS_PER_DIRTY_WORD, 0);
+
+	for (uint inc_idx = 0; inc_idx < num_incidents; ++inc_idx)
+	{
+		SetIncidentBit(m_dirtyIncidents, inc_idx);
+	}
+}
+
+
+//------------------------------------------------------------
+void IncidentProgram::BeginIncident(const int incident_idx)
+{
+	m_incidentBegins.push_back(Emit(INCIDENT_OP_BEGIN_INCIDENT, incident_idx, 0));
+	m_incidentFires.clear();
+}
+
+
+void IncidentProgram::EndIncident()
+{
+	const uint block_end = static_cast<uint>(m_instructions.size());
+
+	m_instructions[m_incidentBegins.back()].m_jumpTarget = block_end;
+	for (const uint fire_idx : m_incidentFires)
+	{
+		m_instructions[fire_idx].m_jumpTarget = block_end;
+	}
+	m_incidentFires.clear();
+}
+
+
+void IncidentProgram::BeginTrigger()
+{
+	m_triggerTests.clear();
+
+	TriggerJoin join;
+	join.m_incidentIdx = static_cast<int>(m_incidentBegins.size() - 1);
+	m_triggerJoins.push_back(join);
+}
+
+
+void IncidentProgram::EndTrigger(const int trigger_idx)
+{
+	m_incidentFires.push_back(Emit(INCIDENT_OP_FIRE_TRIGGER, -1, static_cast<uint>(trigger_idx)));
+
+	const uint next_trigger = static_cast<uint>(m_instructions.size());
+	for (const uint test_idx : m_triggerTests)
+	{
+		m_instructions[test_idx].m_jumpTarget = next_trigger;
+	}
+	m_triggerTests.clear();
+}
+
+
+void IncidentProgram::EmitTest(const IncidentOpcode op, const int operand, const uint value)
+{
+	m_triggerTests.push_back(Emit(op, operand, value));
+
+	switch (op)
+	{
+		case INCIDENT_OP_TEST_TIME_REACHED:
+		{
+			m_deadlines.push({ static_cast<int>(value), static_cast<int>(m_incidentBegins.size() - 1) });
+			break;
+		}
+		case INCIDENT_OP_TEST_TIME_SINCE_ENABLED:
+		{
+			const int incident_idx = static_cast<int>(m_incidentBegins.size() - 1);
+			if (incident_idx >= static_cast<int>(m_sinceEnabledMinutes.size()))
+			{
+				m_sinceEnabledMinutes.resize(incident_idx + 1);
+			}
+			m_sinceEnabledMinutes[incident_idx].push_back(static_cast<int>(value));
+			break;
+		}
+		case INCIDENT_OP_TEST_INTEREST:
+		case INCIDENT_OP_TEST_INTEREST_NOT:
+		{
+			SetIncidentBit(m_interestReaders, static_cast<uint>(m_incidentBegins.size() - 1));
+			break;
+		}
+		case INCIDENT_OP_TEST_CONDITION:
+		{
+			SetIncidentBit(m_alwaysDirty, static_cast<uint>(m_incidentBegins.size() - 1));
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+}
+
+
+// A card asks about only a few of its states, so finding the one already shared is a short scan
+void IncidentProgram::EmitCardStateTest(const CardType card_type, const int card_idx, const SymbolId state_id, const bool is_in_state)
+{
+	std::vector<std::vector<uint>>& card_shared_conditions = m_cardSharedConditions[card_type];
+	if (card_idx >= static_cast<int>(card_shared_conditions.size()))
+	{
+		card_shared_conditions.resize(card_idx + 1);
+	}
+
+	std::vector<uint>& state_shared_conditions = card_shared_conditions[card_idx];
+	for (const uint shared_idx : state_shared_conditions)
+	{
+		if (m_sharedConditions[shared_idx].m_stateId == state_id)
+		{
+			EmitShared(shared_idx, !is_in_state);
+			return;
+		}
+	}
+
+	SharedCondition shared;
+	shared.m_cardType = card_type;
+	shared.m_cardIdx = card_idx;
+	shared.m_stateId = state_id;
+	m_sharedConditions.push_back(shared);
+
+	const uint shared_idx = static_cast<uint>(m_sharedConditions.size() - 1);
+	state_shared_conditions.push_back(shared_idx);
+	EmitShared(shared_idx, !is_in_state);
+}
+
+
+void IncidentProgram::EmitPlayerAtTest(const int loc_idx, const bool is_at)
+{
+	if (loc_idx >= static_cast<int>(m_locationSharedConditions.size()))
+	{
+		m_locationSharedConditions.resize(loc_idx + 1, -1);
+	}
+
+	if (m_locationSharedConditions[loc_idx] < 0)
+	{
+		SharedCondition shared;
+		shared.m_cardIdx = loc_idx;
+		m_sharedConditions.push_back(shared);
+		m_locationSharedConditions[loc_idx] = static_cast<int>(m_sharedConditions.size() - 1);
+	}
+
+	EmitShared(static_cast<uint>(m_locationSharedConditions[loc_idx]), !is_at);
+}
+
+
+void IncidentProgram::EmitInterestTest(const CardType card_type, const int card_idx, const bool is_interest)
+{
+	EmitTest(is_interest ? INCIDENT_OP_TEST_INTEREST : INCIDENT_OP_TEST_INTEREST_NOT, card_idx, static_cast<uint>(card_type));
+}
+
+
+void IncidentProgram::EmitNeverPasses()
+{
+	EmitTest(INCIDENT_OP_NEVER_PASSES, -1, 0);
+}
+
+
+void IncidentProgram::EmitCondition(Condition* condition)
+{
+	EmitTest(INCIDENT_OP_TEST_CONDITION, static_cast<int>(m_conditions.size()), 0);
+	m_conditions.push_back(condition);
+}
+
+
+void IncidentProgram::EmitAction(Action* action)
+{
+	Emit(INCIDENT_OP_RUN_ACTION, static_cast<int>(m_actions.size()), 0);
+	m_actions.push_back(action);
+}
+
+
+uint IncidentProgram::GetNumInstructions() const
+{
+	return static_cast<uint>(m_instructions.size());
+}
+
+
+uint IncidentProgram::GetNumVirtualConditions() const
+{
+	return static_cast<uint>(m_conditions.size());
+}
+
+
+uint IncidentProgram::GetNumSharedConditions() const
+{
+	return static_cast<uint>(m_sharedConditions.size());
+}
+
+
+uint IncidentProgram::GetNumSharedUses() const
+{
+	uint num_uses = 0;
+	for (const SharedCondition& shared : m_sharedConditions)
+	{
+		num_uses += static_cast<uint>(shared.m_uses.size());
+	}
+
+	return num_uses;
+}
+
+
+uint IncidentProgram::GetNumDirty() const
+{
+	uint num_dirty = 0;
+	for (const uint64_t word : m_dirtyIncidents)
+	{
+		num_dirty += GetNumSetBits(word);
+	}
+
+	return num_dirty;
+}
+
+
+//------------------------------------------------------------
+// Same order and the same first trigger wins as Incident::TestTriggers. The time is read again after every action, an
+// action is the only thing that can change it mid run, and the shared conditions are updated by the action itself.
+uint IncidentProgram::Execute(Scenario& the_scenario, const uint begin_pc, const uint end_pc, const bool run_actions) const
+{
+	int now_minutes = GetGameTimeInMinutes(the_scenario.GetCurrentTime());
+
+	const IncidentInstruction* instructions = m_instructions.data();
+	Incident* incident = nullptr;
+	uint num_fired = 0;
+
+	for (uint pc = begin_pc; pc < end_pc;)
+	{
+		const IncidentInstruction& instruction = instructions[pc];
+		bool jump = false;
+
+		switch (instruction.m_op)
+		{
+			case INCIDENT_OP_BEGIN_INCIDENT:
+			{
+				incident = the_scenario.GetIncidentFromList(instruction.m_operand);
+				jump = !incident->IsIncidentEnabled();
+				break;
+			}
+			case INCIDENT_OP_NEVER_PASSES:
+			{
+				jump = true;
+				break;
+			}
+			case INCIDENT_OP_TEST_TIME_REACHED:
+			{
+				jump = now_minutes < static_cast<int>(instruction.m_value);
+				break;
+			}
+			case INCIDENT_OP_TEST_TIME_SINCE_ENABLED:
+			{
+				const int enabled_minutes = GetGameTimeInMinutes(incident->GetActivatedTime());
+				jump = now_minutes - enabled_minutes < static_cast<int>(instruction.m_value);
+				break;
+			}
+			case INCIDENT_OP_TEST_SHARED:
+			{
+				jump = !m_sharedConditions[instruction.m_operand].m_isTrue;
+				break;
+			}
+			case INCIDENT_OP_TEST_SHARED_NOT:
+			{
+				jump = m_sharedConditions[instruction.m_operand].m_isTrue;
+				break;
+			}
+			case INCIDENT_OP_TEST_INTEREST:
+			case INCIDENT_OP_TEST_INTEREST_NOT:
+			{
+				const Card* card = GetCard(the_scenario, static_cast<CardType>(instruction.m_value), instruction.m_operand);
+				const bool is_interest = card != nullptr && card == the_scenario.GetCurrentInterest();
+				jump = is_interest == (instruction.m_op == INCIDENT_OP_TEST_INTEREST_NOT);
+				break;
+			}
+			case INCIDENT_OP_TEST_CONDITION:
+			{
+				jump = !m_conditions[instruction.m_operand]->Test();
+				break;
+			}
+			case INCIDENT_OP_RUN_ACTION:
+			{
+				if (run_actions)
+				{
+					m_actions[instruction.m_operand]->Execute();
+					now_minutes = GetGameTimeInMinutes(the_scenario.GetCurrentTime());
+				}
+				break;
+			}
+			case INCIDENT_OP_FIRE_TRIGGER:
+			{
+				num_fired++;
+				if (run_actions)
+				{
+					incident->OnTriggerFired(instruction.m_value);
+				}
+				jump = true;
+				break;
+			}
+			default:
+			{
+				ERROR_AND_DIE(Stringf("Incident program has an unknown opcode %u at %u", static_cast<uint>(instruction.m_op), pc));
+			}
+		}
+
+		pc = jump ? instruction.m_jumpTarget : pc + 1;
+	}
+
+	return num_fired;
+}
+
+
+uint IncidentProgram::Emit(const IncidentOpcode op, const int operand, const uint value)
+{
+	IncidentInstruction instruction;
+	instruction.m_op = op;
+	instruction.m_operand = operand;
+	instruction.m_value = value;
+	instruction.m_jumpTarget = PENDING_JUMP;
+
+	m_instructions.push_back(instruction);
+	return static_cast<uint>(m_instructions.size() - 1);
+}
+
+
+void IncidentProgram::EmitShared(const uint shared_idx, const bool negated)
+{
+	SharedConditionUse use;
+	use.m_triggerJoin = static_cast<uint>(m_triggerJoins.size() - 1);
+	use.m_negated = negated;
+	m_sharedConditions[shared_idx].m_uses.push_back(use);
+
+	EmitTest(negated ? INCIDENT_OP_TEST_SHARED_NOT : INCIDENT_OP_TEST_SHARED, static_cast<int>(shared_idx), 0);
+}
+
+
+bool IncidentProgram::IsSharedConditionTrue(Scenario& the_scenario, const SharedCondition& shared) const
+{
+	if (shared.m_cardType == UNKNOWN_CARD_TYPE)
+	{
+		return shared.m_cardIdx == m_playerLocationIdx;
+	}
+
+	return GetCardStateId(the_scenario, shared.m_cardType, shared.m_cardIdx) == shared.m_stateId;
+}
+
+
+// Only an incident with a trigger left with nothing failing can fire where it could not before
+void IncidentProgram::SetSharedCondition(const uint shared_idx, const bool is_true)
+{
+	SharedCondition& shared = m_sharedConditions[shared_idx];
+	if (shared.m_isTrue == is_true)
+	{
+		return;
+	}
+	shared.m_isTrue = is_true;
+
+	for (const SharedConditionUse& use : shared.m_uses)
+	{
+		TriggerJoin& join = m_triggerJoins[use.m_triggerJoin];
+		if (is_true != use.m_negated)
+		{
+			if (--join.m_numFalse == 0)
+			{
+				SetIncidentBit(m_dirtyIncidents, static_cast<uint>(join.m_incidentIdx));
+			}
+		}
+		else
+		{
+			join.m_numFalse++;
+		}
+	}
+}
+
+
+// Incidents without a time since enabled test have nothing to schedule
+void IncidentProgram::ScheduleSinceEnabled(const int incident_idx, const int enabled_minutes)
+{
+	if (incident_idx >= static_cast<int>(m_sinceEnabledMinutes.size()))
+	{
+		return;
+	}
+
+	for (const int minutes : m_sinceEnabledMinutes[incident_idx])
+	{
+		m_deadlines.push({ enabled_minutes + minutes, incident_idx });
+	}
+}
+
+
+int IncidentProgram::FindNextDirty(const uint first_incident_idx) const
+{
+	uint word_idx = first_incident_idx / INCIDENTS_PER_DIRTY_WORD;
+	if (word_idx >= m_dirtyIncidents.size())
+	{
+		return -1;
+	}
+
+	uint64_t word = m_dirtyIncidents[word_idx] & (~0ull << (first_incident_idx % INCIDENTS_PER_DIRTY_WORD));
+	while (word == 0)
+	{
+		if (++word_idx >= m_dirtyIncidents.size())
+		{
+			return -1;
+		}
+		word = m_dirtyIncidents[word_idx];
+	}
+
+	return static_cast<int>(word_idx * INCIDENTS_PER_DIRTY_WORD + GetLowestSetBit(word));
+}
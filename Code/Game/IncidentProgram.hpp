@@ -0,0 +1,154 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+
+class Scenario;
+
+// Every incident lowered into one flat instruction stream, compiled again by every link pass. An incident is a block
+// that is jumped over while it is disabled, each of its triggers a run of tests that jump to the next trigger on the
+// first one failing, then the trigger's actions and a fire that leaves the block, the first trigger to pass wins.
+// The conditions the compiler knows become opcodes, anything else is called through its virtual Test, as are the
+// actions since they only run when a trigger fires.
+//
+// Card state and player location checks are shared, every incident asking whether a card is in a state reads the
+// one shared condition for it, and its truth is kept up to date as the scenario changes instead of tested. Each
+// trigger joins its shared conditions by counting how many are false right now, so a change walks the triggers using
+// it once and the incidents with a trigger whose count falls to zero are marked dirty. RunDirty tests only those.
+// An incident stays dirty while it keeps firing, or when it has a condition left virtual, since nothing says what
+// that one reads. The incidents testing the current interest are marked when it changes. Time only goes forward, so a time test can only change once, at the game minute it comes due.
+// Those minutes wait in a min heap, AdvanceTime pops the ones that have passed and marks their incidents dirty, and
+// RunDirty tests them in list order like any other change.
+
+enum IncidentOpcode : uint8_t
+{
+	INCIDENT_OP_BEGIN_INCIDENT,				// operand: incident idx, jumps past the block while it is disabled
+	INCIDENT_OP_NEVER_PASSES,				// a dangling condition
+	INCIDENT_OP_TEST_TIME_REACHED,			// value: game time in minutes
+	INCIDENT_OP_TEST_TIME_SINCE_ENABLED,	// value: minutes since the incident was enabled
+	INCIDENT_OP_TEST_SHARED,				// operand: shared condition idx
+	INCIDENT_OP_TEST_SHARED_NOT,
+	INCIDENT_OP_TEST_INTEREST,				// operand: card idx, value: card type, passes while it is the current interest
+	INCIDENT_OP_TEST_INTEREST_NOT,
+	INCIDENT_OP_TEST_CONDITION,				// operand: idx into the condition table
+	INCIDENT_OP_RUN_ACTION,					// operand: idx into the action table
+	INCIDENT_OP_FIRE_TRIGGER,				// value: trigger idx, jumps past the incident's block
+
+	NUM_INCIDENT_OPS
+};
+
+
+struct IncidentDeadline
+{
+	int		m_minute = 0;			// game time in minutes
+	int		m_incidentIdx = -1;
+
+	bool operator>(const IncidentDeadline& other) const { return m_minute > other.m_minute; }
+};
+
+
+struct IncidentInstruction
+{
+	IncidentOpcode	m_op = INCIDENT_OP_NEVER_PASSES;
+	int				m_operand = -1;
+	uint			m_value = 0;
+	uint			m_jumpTarget = 0;
+};
+
+
+//------------------------------------------------------------
+class IncidentProgram
+{
+public:
+	void	Compile(Scenario& the_scenario);
+	void	Clear();
+	uint	Run(Scenario& the_scenario, bool run_actions) const;		// every incident, returns how many triggers fired
+	uint	RunDirty(Scenario& the_scenario, bool run_actions);			// only the dirty incidents, in list order
+
+	void	UpdateCardState(CardType card_type, int card_idx, SymbolId state_id);
+	void	UpdatePlayerLocation(int loc_idx);								// -1 when the player is nowhere
+	void	AdvanceTime(int now_minutes);									// marks every deadline up to now
+	void	MarkIncidentChanged(int incident_idx, int enabled_minutes);		// enabled, disabled or its time restarted
+	void	MarkInterestChanged();
+	void	MarkAllDirty();
+
+	// Called by the incidents, triggers and conditions as they compile themselves
+	void	BeginIncident(int incident_idx);
+	void	EndIncident();
+	void	BeginTrigger();
+	void	EndTrigger(int trigger_idx);
+	void	EmitTest(IncidentOpcode op, int operand, uint value);
+	void	EmitCardStateTest(CardType card_type, int card_idx, SymbolId state_id, bool is_in_state);
+	void	EmitPlayerAtTest(int loc_idx, bool is_at);
+	void	EmitInterestTest(CardType card_type, int card_idx, bool is_interest);
+	void	EmitNeverPasses();
+	void	EmitCondition(Condition* condition);
+	void	EmitAction(Action* action);
+
+	uint	GetNumInstructions() const;
+	uint	GetNumVirtualConditions() const;
+	uint	GetNumSharedConditions() const;
+	uint	GetNumSharedUses() const;
+	uint	GetNumDirty() const;
+
+private:
+	// A trigger reading a shared condition, negated for "is not" and "not at"
+	struct SharedConditionUse
+	{
+		uint	m_triggerJoin = 0;
+		bool	m_negated = false;
+	};
+
+	struct SharedCondition
+	{
+		CardType	m_cardType = UNKNOWN_CARD_TYPE;		// unknown for where the player is
+		int			m_cardIdx = -1;						// the location for where the player is
+		SymbolId	m_stateId = INVALID_SYMBOL;
+		bool		m_isTrue = false;
+
+		std::vector<SharedConditionUse>	m_uses;
+	};
+
+	struct TriggerJoin
+	{
+		int		m_incidentIdx = -1;
+		uint	m_numFalse = 0;			// shared conditions of the trigger failing right now
+	};
+
+private:
+	uint	Execute(Scenario& the_scenario, uint begin_pc, uint end_pc, bool run_actions) const;
+	uint	Emit(IncidentOpcode op, int operand, uint value);
+	void	EmitShared(uint shared_idx, bool negated);
+	bool	IsSharedConditionTrue(Scenario& the_scenario, const SharedCondition& shared) const;
+	void	SetSharedCondition(uint shared_idx, bool is_true);
+	void	ScheduleSinceEnabled(int incident_idx, int enabled_minutes);
+	int		FindNextDirty(uint first_incident_idx) const;					// -1 when none is left
+
+private:
+	std::vector<IncidentInstruction>	m_instructions;
+	std::vector<Condition*>				m_conditions;		// the conditions without an opcode of their own
+	std::vector<Action*>				m_actions;
+
+	std::vector<uint>	m_incidentBegins;	// incident n is [m_incidentBegins[n], m_incidentBegins[n + 1]), the last is the end
+
+	// forward jumps patched once their target is emitted
+	std::vector<uint>	m_triggerTests;
+	std::vector<uint>	m_incidentFires;
+
+	std::vector<SharedCondition>	m_sharedConditions;
+	std::vector<TriggerJoin>		m_triggerJoins;
+	std::vector<std::vector<uint>>	m_cardSharedConditions[NUM_CARD_TYPES];	// by card idx, one per state asked about
+	std::vector<int>				m_locationSharedConditions;				// by location idx, -1 when never asked
+	int								m_playerLocationIdx = -1;
+
+	// minutes after being enabled each incident's tests wait for, by incident idx, and the deadlines not yet passed.
+	// Deadlines left behind by an incident enabled again only mark it once more, which costs a test and nothing else.
+	std::vector<std::vector<int>>	m_sinceEnabledMinutes;
+	std::priority_queue<IncidentDeadline, std::vector<IncidentDeadline>, std::greater<IncidentDeadline>>	m_deadlines;
+
+	std::vector<uint64_t>	m_dirtyIncidents;
+	std::vector<uint64_t>	m_alwaysDirty;
+	std::vector<uint64_t>	m_interestReaders;		// the incidents with a test of the current interest
+};
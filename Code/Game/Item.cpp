@@ -1,4 +1,6 @@
 #include "Game/Item.hpp"
+#include "Game/Scenario.hpp"
+#include "Game/ScenarioImage.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
@@ -13,7 +15,13 @@ Item::Item(Scenario* the_setup, const String& name, const StringList& list_of_ni
 
 Item::Item(Scenario* the_setup, const XmlElement* element) : Card(the_setup, CARD_ITEM)
 {
-	String current_state = "";
+	ImportFromXml(element);
+}
+
+
+void Item::ImportFromXml(const XmlElement* element)
+{
+	SymbolId current_state = SYMBOL_EMPTY;
 
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
@@ -25,31 +33,15 @@ Item::Item(Scenario* the_setup, const XmlElement* element) : Card(the_setup, CAR
 		if (attribute_name == "name")
 		{
 			m_name = attribute->Value();
+			m_nameId = m_theScenario->InternName(m_name);
 		}
 		else if (attribute_name == "startingstate")
 		{
-			current_state = StringToLower(String(attribute->Value()));
+			current_state = m_theScenario->InternName(attribute->Value());
 		}
 		else if (attribute_name == "imagedir")
 		{
-			String file_name = m_name + ".mat";
-			m_material = g_theRenderer->CreateOrGetMaterial(file_name, false);
-			m_material->SetShader("default_lit.hlsl");
-			m_material->m_shader->SetDepth(COMPARE_LESS_EQUAL, true);
-
-			std::string texture_src = attribute->Value();
-			TextureView* texture(reinterpret_cast<TextureView*>(g_theRenderer->CreateOrGetTextureView2D(texture_src)));
-			m_material->SetDiffuseMap(texture);
-
-			CPUMesh quad_mesh;
-			CpuMeshAddQuad(&quad_mesh,
-				AABB2(
-					-(ITEM_CARD_ASPECT_RATIO * ITEM_CARD_HEIGHT),
-					-ITEM_CARD_HEIGHT,
-					ITEM_CARD_ASPECT_RATIO * ITEM_CARD_HEIGHT,
-					ITEM_CARD_HEIGHT));
-			m_mesh = new GPUMesh(g_theRenderer);
-			m_mesh->CreateFromCPUMesh<Vertex_Lit>(quad_mesh); // we won't be updated this;
+			LoadCardImage(attribute->Value());
 		}
 		else
 		{
@@ -89,9 +81,54 @@ Item::Item(Scenario* the_setup, const XmlElement* element) : Card(the_setup, CAR
 }
 
 
+Item::Item(Scenario* the_setup, ScenarioImageReader& reader) : Card(the_setup, CARD_ITEM)
+{
+	ReadCardFromImage(reader);
+
+	const String image_dir = m_imageDir;
+	if (!image_dir.empty())
+	{
+		LoadCardImage(image_dir);
+	}
+
+	const SymbolId current_state = m_theScenario->InternName(reader.ReadString());
+
+	const uint num_states = reader.ReadU32();
+	m_states.Reserve(num_states);
+	for (uint state_idx = 0; state_idx < num_states; ++state_idx)
+	{
+		ItemState new_state;
+		new_state.m_nameId = m_theScenario->InternName(reader.ReadString());
+		new_state.m_addGameTime = reader.ReadBool();
+
+		m_states.Add(new_state);
+	}
+
+	m_modelMatrix = m_modelMatrix.MakeTranslation2D(Vec2(ENTITY_POS_X, ENTITY_POS_Y));
+	SetState(current_state);
+}
+
+
+// Rebuilds the item from its edited xml element, keeping the current state and discovery
+void Item::ReloadFromXml(const XmlElement* element)
+{
+	const SymbolId live_state = GetItemState().m_nameId;
+
+	ClearCardData();
+	m_states.Clear();
+
+	ImportFromXml(element);
+
+	if (HasState(live_state))
+	{
+		SetState(live_state);
+	}
+}
+
+
 const ItemState& Item::GetItemState() const
 {
-	return m_currentState;
+	return m_states.GetCurrent();
 }
 
 
@@ -102,7 +139,11 @@ String Item::GetAsString() const
 	const uint num_nicknames = static_cast<uint>(m_nickNames.size());
 	for (uint nn_idx = 0; nn_idx < num_nicknames; ++nn_idx)
 	{
-		m_line += nn_idx != num_nicknames - 1 ? (m_nickNames[nn_idx] + ", ") : (m_nickNames[nn_idx]);
+		m_line += m_nickNames[nn_idx];
+		if (nn_idx != num_nicknames - 1)
+		{
+			m_line += ", ";
+		}
 	}
 	m_line += ")";
 
@@ -110,19 +151,47 @@ String Item::GetAsString() const
 }
 
 
+bool Item::HasState(const String& state_name) const
+{
+	return HasState(m_theScenario->GetSymbolTable().Find(state_name));
+}
+
+
+bool Item::HasState(const SymbolId state_id) const
+{
+	return m_states.HasState(state_id);
+}
+
+
+int Item::FindStateIdx(const SymbolId state_id) const
+{
+	return m_states.FindStateIdx(state_id);
+}
+
+
 void Item::SetState(const String& starting_state)
 {
-	int num_states = static_cast<int>(m_states.size());
-	for (int state_idx = 0; state_idx < num_states; ++state_idx)
+	SetState(m_theScenario->GetSymbolTable().Find(starting_state));
+}
+
+
+void Item::SetState(const SymbolId state_id)
+{
+	const int state_idx = m_states.FindStateIdx(state_id);
+	if (state_idx < 0)
 	{
-		if (StringToLower(m_states[state_idx].m_name) == starting_state)
-		{
-			m_currentState = m_states[state_idx];
-			return;
-		}
+		ERROR_AND_DIE(Stringf("StartingState for Card '%s' was not found in the list of states", m_name.c_str()));
 	}
 
-	ERROR_AND_DIE(Stringf("StartingState for Card '%s' was not found in the list of states", m_name.c_str()));
+	m_states.SetCurrentIdx(state_idx);
+}
+
+
+// Only called while playing, loading sets the state by name and the compile after it tests every incident anyway
+void Item::SetStateIdx(const int state_idx)
+{
+	m_states.SetCurrentIdx(state_idx);
+	m_theScenario->OnCardStateChanged(CARD_ITEM, m_theScenario->GetItemListIdx(this));
 }
 
 
@@ -145,7 +214,7 @@ void Item::ImportItemStatesFromXml(const XmlElement* element)
 
 			if (atr_name == "name")
 			{
-				new_state.m_name = StringToLower(attribute->Value());
+				new_state.m_nameId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "addgametime")
 			{
@@ -153,7 +222,27 @@ void Item::ImportItemStatesFromXml(const XmlElement* element)
 			}
 		}
 
-		m_states.push_back(new_state);
+		m_states.Add(new_state);
 	}
 }
 
+
+void Item::WriteToImage(ScenarioImageWriter& writer) const
+{
+	WriteCardToImage(writer);
+	writer.WriteString(m_theScenario->GetSymbolName(GetItemState().m_nameId));
+
+	const uint num_states = m_states.GetNumStates();
+	writer.WriteU32(num_states);
+	for (uint state_idx = 0; state_idx < num_states; ++state_idx)
+	{
+		writer.WriteString(m_theScenario->GetSymbolName(m_states.GetState(state_idx).m_nameId));
+		writer.WriteBool(m_states.GetState(state_idx).m_addGameTime);
+	}
+}
+
+
+void Item::LoadCardImage(const String& image_dir)
+{
+	SetCardImage(image_dir, AABB2(-(ITEM_CARD_ASPECT_RATIO * ITEM_CARD_HEIGHT), -ITEM_CARD_HEIGHT, ITEM_CARD_ASPECT_RATIO * ITEM_CARD_HEIGHT, ITEM_CARD_HEIGHT));
+}
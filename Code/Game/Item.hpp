@@ -5,7 +5,7 @@
 struct ItemState
 {
 public:
-	String		m_name = "";
+	SymbolId	m_nameId = SYMBOL_EMPTY;
 	bool		m_addGameTime = false;
 	//showUI = ClueFound or none
 };
@@ -18,21 +18,31 @@ public:
 	explicit Item(Scenario* the_setup);
 	explicit Item(Scenario* the_setup, const std::string& name, const std::vector<std::string>& list_of_nicknames, const std::string& desc);
 	explicit Item(Scenario* the_setup, const XmlElement* element);
+	explicit Item(Scenario* the_setup, ScenarioImageReader& reader);
 	~Item() = default;
 
 	// ACCESSORS
 	const ItemState& GetItemState() const;
+	bool HasState(const String& state_name) const;
+	bool HasState(SymbolId state_id) const;
+	int FindStateIdx(SymbolId state_id) const;	// -1 when there is no such state
 	String GetAsString() const;
 
 	// MUTATORS
 	void SetState(const String& starting_state);
+	void SetState(SymbolId state_id);
+	void SetStateIdx(int state_idx);
+
+	void WriteToImage(ScenarioImageWriter& writer) const;
+	void ReloadFromXml(const XmlElement* element);
 
 private:
+	void ImportFromXml(const XmlElement* element);
 	void ImportItemStatesFromXml(const XmlElement* element);
+	void LoadCardImage(const String& image_dir);
 
 private:
-	ItemState			m_currentState;
-	ItemStateList		m_states;
+	CardStateTable<ItemState>	m_states;
 
 	const float ITEM_CARD_HEIGHT = 25.0f;
 	const float ITEM_CARD_ASPECT_RATIO = 0.6108597285067873f;
@@ -3,6 +3,9 @@
 #include "Game/Character.hpp"
 #include "Game/Item.hpp"
 #include "Game/Action.hpp"
+#include "Game/ScenarioImage.hpp"
+#include "Game/CardImage.hpp"
+#include "Game/CaseFold.hpp"
 
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -13,6 +16,8 @@
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 
+constexpr int CHARACTERS_PER_PRESENCE_WORD = 64;
+
 
 //------------------------------------------------------------
 IntroFromLocation::IntroFromLocation()
@@ -20,17 +25,9 @@ IntroFromLocation::IntroFromLocation()
 }
 
 
+// the actions belong to the scenario arena
 IntroFromLocation::~IntroFromLocation()
 {
-	uint num_actions = static_cast<uint>(m_actions.size());
-	for (uint action_idx = 0; action_idx < num_actions; ++action_idx)
-	{
-		if (m_actions[action_idx] != nullptr)
-		{
-			delete m_actions[action_idx];
-			m_actions[action_idx] = nullptr;
-		}
-	}
 }
 
 
@@ -38,17 +35,12 @@ IntroFromLocation::~IntroFromLocation()
 Location::Location()
 {
 	m_type = CARD_LOCATION;
-	m_charsInLoc = std::vector<const Character*>();
-	m_states = LocStateList();
 	m_presentingCharacterDialogue = Intros();
 	m_presentingItemDialogue = Intros();
 }
 
 
-Location::Location(Scenario* the_setup) : Card(the_setup, CARD_LOCATION)
-{
-	m_charsInLoc = std::vector<const Character*>();
-}
+Location::Location(Scenario* the_setup) : Card(the_setup, CARD_LOCATION) { }
 
 
 Location::Location(Scenario* the_setup, const String& name, const StringList& list_of_nicknames,
@@ -57,55 +49,39 @@ Location::Location(Scenario* the_setup, const String& name, const StringList& li
 
 Location::Location(Scenario* the_setup, const XmlElement* element) : Card(the_setup, CARD_LOCATION)
 {
-	String current_state = "";
+	ImportFromXml(element);
+}
+
+
+void Location::ImportFromXml(const XmlElement* element)
+{
+	SymbolId current_state = SYMBOL_EMPTY;
 
 	// Get all the attributes from the Location element
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "name")
 		{
 			m_name = attribute->Value();
+			m_nameId = m_theScenario->InternName(m_name);
 		}
 		else if (attribute_name == "startingstate")
 		{
-			current_state = StringToLower(String(attribute->Value()));
+			current_state = m_theScenario->InternName(attribute->Value());
 		}
 		else if (attribute_name == "imagedir")
 		{
-			String file_name = m_name + ".mat";
-			m_material = g_theRenderer->CreateOrGetMaterial(file_name, false);
-			m_material->SetShader("default_lit.hlsl");
-			m_material->m_shader->SetDepth(COMPARE_LESS_EQUAL, true);
-
-			std::string texture_src = attribute->Value();
-			TextureView* texture(reinterpret_cast<TextureView*>(g_theRenderer->CreateOrGetTextureView2D(texture_src)));
-			m_material->SetDiffuseMap(texture);
-
-			CPUMesh quad_mesh;
-			CpuMeshAddQuad(&quad_mesh,
-				AABB2(
-					-(LOC_CARD_ASPECT_RATIO * LOC_CARD_HEIGHT),
-					-LOC_CARD_HEIGHT,
-					LOC_CARD_ASPECT_RATIO * LOC_CARD_HEIGHT,
-					LOC_CARD_HEIGHT));
-			m_mesh = new GPUMesh(g_theRenderer);
-			m_mesh->CreateFromCPUMesh<Vertex_Lit>(quad_mesh); // we won't be updated this;
+			LoadCardImage(attribute->Value());
 		}
 		else if (attribute_name == "defaultroomdir")
 		{
-			String file_name = Stringf("%s_&s.mat", m_name.c_str(), attribute_name.c_str());
-			m_defaultRoomMaterial = g_theRenderer->CreateOrGetMaterial(file_name, false);
-			m_defaultRoomMaterial->SetShader("default_lit.hlsl");
-			m_defaultRoomMaterial->m_shader->SetDepth(COMPARE_LESS_EQUAL, true);
-
-			std::string texture_src = attribute->Value();
-			TextureView* texture(reinterpret_cast<TextureView*>(g_theRenderer->CreateOrGetTextureView2D(texture_src)));
-			m_defaultRoomMaterial->SetDiffuseMap(texture);
+			LoadDefaultRoomImage(attribute->Value());
 		}
 		else
 		{
@@ -114,12 +90,13 @@ Location::Location(Scenario* the_setup, const XmlElement* element) : Card(the_se
 	}
 
 	// Get all the children elements
+	String element_name;
 	for (const XmlElement* child_element = element->FirstChildElement();
 		child_element;
 		child_element = child_element->NextSiblingElement()
 		)
 	{
-		String element_name = StringToLower(child_element->Name());
+		FoldCase(child_element->Name(), element_name);
 
 		if (element_name == "nicknames")
 		{
@@ -153,31 +130,92 @@ Location::Location(Scenario* the_setup, const XmlElement* element) : Card(the_se
 }
 
 
+Location::Location(Scenario* the_setup, ScenarioImageReader& reader) : Card(the_setup, CARD_LOCATION)
+{
+	ReadCardFromImage(reader);
+
+	const String image_dir = m_imageDir;
+	if (!image_dir.empty())
+	{
+		LoadCardImage(image_dir);
+	}
+
+	const String default_room_dir = reader.ReadString();
+	if (!default_room_dir.empty())
+	{
+		LoadDefaultRoomImage(default_room_dir);
+	}
+
+	const SymbolId current_state = m_theScenario->InternName(reader.ReadString());
+
+	const uint num_states = reader.ReadU32();
+	m_states.Reserve(num_states);
+	for (uint state_idx = 0; state_idx < num_states; ++state_idx)
+	{
+		LocationState new_state;
+		new_state.m_nameId = m_theScenario->InternName(reader.ReadString());
+		new_state.m_canMoveHere = reader.ReadBool();
+		new_state.m_addGameTime = reader.ReadBool();
+		new_state.m_description = reader.ReadString();
+		new_state.m_specialAction = static_cast<LocationSpecialAction>(reader.ReadI32());
+
+		const String room_dir = reader.ReadString();
+		if (!room_dir.empty())
+		{
+			LoadStateRoomImage(new_state, room_dir);
+		}
+
+		m_states.Add(new_state);
+	}
+
+	ReadIntroductionsFromImage(reader, m_presentingCharacterDialogue, CARD_CHARACTER);
+	ReadIntroductionsFromImage(reader, m_presentingItemDialogue, CARD_ITEM);
+
+	SetState(current_state);
+}
+
+
 Location::~Location()
 {
 	
 }
 
+
+// Rebuilds the location from its edited xml element, keeping the current state, investigation and who is here
+void Location::ReloadFromXml(const XmlElement* element)
+{
+	const SymbolId live_state = GetLocationState().m_nameId;
+
+	ClearCardData();
+	m_states.Clear();
+	m_presentingCharacterDialogue.clear();
+	m_presentingItemDialogue.clear();
+	m_defaultRoomDir = "";
+	m_defaultRoomImage = nullptr;
+
+	ImportFromXml(element);
+
+	if (HasState(live_state))
+	{
+		SetState(live_state);
+	}
+}
+
 void Location::Render() const
 {
 	if (CanInvestigateLocation() && m_investigating)
 	{
-		if (m_currentState.m_roomMaterial != nullptr)
-		{
-			g_theRenderer->BindModelMatrix(m_modelMatrix);
-			g_theRenderer->BindMaterial(*m_currentState.m_roomMaterial);
-			g_theRenderer->DrawMesh(*m_mesh);
-		}
-		else if (m_defaultRoomMaterial != nullptr)
+		const CardImage* state_image = GetLocationState().m_roomImage;
+		const CardImage* room_image = state_image != nullptr ? state_image : m_defaultRoomImage;
+		ASSERT_OR_DIE(room_image != nullptr, "Cannot Investigate a room without a material or default material.");
+
+		// the room shows up once its image has finished loading
+		if (room_image->GetMaterial() != nullptr && m_mesh != nullptr)
 		{
 			g_theRenderer->BindModelMatrix(m_modelMatrix);
-			g_theRenderer->BindMaterial(*m_defaultRoomMaterial);
+			g_theRenderer->BindMaterial(*room_image->GetMaterial());
 			g_theRenderer->DrawMesh(*m_mesh);
 		}
-		else
-		{
-			ERROR_AND_DIE("Cannot Investigate a room without a material or default material.")
-		}
 	}
 	else if (m_material != nullptr && m_mesh != nullptr)
 	{
@@ -188,37 +226,53 @@ void Location::Render() const
 }
 
 
+void Location::UpdateCardImage()
+{
+	Card::UpdateCardImage();
+
+	// rooms are only needed once the location can be investigated
+	if (CanInvestigateLocation())
+	{
+		g_theCardImageLoader->RequestLoad(m_defaultRoomImage);
+		g_theCardImageLoader->RequestLoad(GetLocationState().m_roomImage);
+	}
+}
+
+
 bool Location::IsCharacterInLocation(const Character* character) const
 {
-	int num_char = static_cast<int>(m_charsInLoc.size());
-	for (int char_idx = 0; char_idx < num_char; ++char_idx)
+	return IsCharacterInLocation(m_theScenario->GetCharacterListIdx(character));
+}
+
+
+bool Location::IsCharacterInLocation(const int char_idx) const
+{
+	const size_t word_idx = static_cast<size_t>(char_idx) / CHARACTERS_PER_PRESENCE_WORD;
+	if (word_idx >= m_charactersHere.size())
 	{
-		if (m_charsInLoc[char_idx]->GetName() == character->GetName())
-		{
-			return true;
-		}
+		return false;
 	}
 
-	return false;
+	return (m_charactersHere[word_idx] >> (char_idx % CHARACTERS_PER_PRESENCE_WORD) & 1u) != 0;
 }
 
 bool Location::GetLocationDescription(String& out) const
 {
 	Location* cur_loc = m_theScenario->GetCurrentLocation();
 
-	if (cur_loc->GetName() == m_name)
+	if (cur_loc->GetNameId() == m_nameId)
 	{
 		out += g_sameLocationMessage;
 		return false;
 	}
-	else if (!m_currentState.m_canMoveHere)
+	else if (!GetLocationState().m_canMoveHere)
 	{
 		out += g_closedLocationMessage;
 		return false;
 	}
 	else
 	{
-		out += m_currentState.m_description;
+		out += GetLocationState().m_description;
 		return true;
 	}
 }
@@ -226,12 +280,12 @@ bool Location::GetLocationDescription(String& out) const
 
 bool Location::IntroduceCharacter(String& out, const Character* character)
 {
-	String loc_state = StringToLower(m_currentState.m_name);
-	String char_name = StringToLower(character->GetName());
-	String char_state = StringToLower(character->GetCharacterState().m_name);
+	const SymbolId loc_state = GetLocationState().m_nameId;
+	const SymbolId char_name = character->GetNameId();
+	const SymbolId char_state = character->GetCharacterState().m_nameId;
 
 
-	if (char_name == m_name)
+	if (char_name == m_nameId)
 	{
 		out += g_unknownCommandMessage;
 		return false;
@@ -249,31 +303,31 @@ bool Location::IntroduceCharacter(String& out, const Character* character)
 		int score = 0;
 
 		//testing location state
-		if (test_state.m_locationState == "*")
+		if (test_state.m_locationStateId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_locationState == loc_state)
+		else if (test_state.m_locationStateId == loc_state)
 		{
 			score += 5;
 		}
 
 		
 		//testing character name
-		if (test_state.m_cardName == "*")
+		if (test_state.m_cardNameId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_cardName == char_name)
+		else if (test_state.m_cardNameId == char_name)
 		{
 			score += 3;
 
 			//testing character state
-			if (test_state.m_cardState == "*")
+			if (test_state.m_cardStateId == SYMBOL_WILDCARD)
 			{
 				score += 1;
 			}
-			else if (test_state.m_cardState == char_state)
+			else if (test_state.m_cardStateId == char_state)
 			{
 				score += 5;
 			}
@@ -308,11 +362,11 @@ bool Location::IntroduceCharacter(String& out, const Character* character)
 
 bool Location::IntroduceItem(String& out, const Item* item)
 {
-	String loc_state = StringToLower(m_currentState.m_name);
-	String item_name = StringToLower(item->GetName());
-	String item_state = StringToLower(item->GetItemState().m_name);
+	const SymbolId loc_state = GetLocationState().m_nameId;
+	const SymbolId item_name = item->GetNameId();
+	const SymbolId item_state = item->GetItemState().m_nameId;
 
-	if (item_name == m_name)
+	if (item_name == m_nameId)
 	{
 		out += g_unknownCommandMessage;
 		return false;
@@ -330,30 +384,30 @@ bool Location::IntroduceItem(String& out, const Item* item)
 		int score = 0;
 
 		//testing location state
-		if (test_state.m_locationState == "*")
+		if (test_state.m_locationStateId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_locationState == loc_state)
+		else if (test_state.m_locationStateId == loc_state)
 		{
 			score += 3;
 		}
 
 		//testing item name
-		if (test_state.m_cardName == "*")
+		if (test_state.m_cardNameId == SYMBOL_WILDCARD)
 		{
 			score += 1;
 		}
-		else if (test_state.m_cardName == item_name)
+		else if (test_state.m_cardNameId == item_name)
 		{
 			score += 3;
 
 			//testing item state
-			if (test_state.m_cardState == "*")
+			if (test_state.m_cardStateId == SYMBOL_WILDCARD)
 			{
 				score += 1;
 			}
-			else if (test_state.m_cardState == item_state)
+			else if (test_state.m_cardStateId == item_state)
 			{
 				score += 5;
 			}
@@ -387,7 +441,7 @@ bool Location::IntroduceItem(String& out, const Item* item)
 
 bool Location::CanInvestigateLocation() const
 {
-	return m_currentState.m_specialAction == LSA_INVESTIGATE_LOC;
+	return GetLocationState().m_specialAction == LSA_INVESTIGATE_LOC;
 }
 
 
@@ -399,13 +453,13 @@ bool Location::IsPlayerInvestigatingRoom() const
 
 bool Location::CanSolveCaseHere() const
 {
-	return m_currentState.m_specialAction == LSA_FINISH_SCENARIO;
+	return GetLocationState().m_specialAction == LSA_FINISH_SCENARIO;
 }
 
 
 const LocationState& Location::GetLocationState() const
 {
-	return m_currentState;
+	return m_states.GetCurrent();
 }
 
 
@@ -416,7 +470,11 @@ String Location::GetAsString() const
 	const uint num_nicknames = static_cast<uint>(m_nickNames.size());
 	for(uint nn_idx = 0; nn_idx < num_nicknames; ++nn_idx)
 	{
-		m_line += nn_idx != num_nicknames - 1 ? (m_nickNames[nn_idx] + ", ") : (m_nickNames[nn_idx]);
+		m_line += m_nickNames[nn_idx];
+		if (nn_idx != num_nicknames - 1)
+		{
+			m_line += ", ";
+		}
 	}
 	m_line += ")";
 	
@@ -424,49 +482,90 @@ String Location::GetAsString() const
 }
 
 
-void Location::AddCharacterToLocation(const Character* character)
+// A character is in one place at a time, so adding them here takes them out of wherever they were
+void Location::AddCharacterToLocation(const int char_idx)
 {
-	int num_char = static_cast<int>(m_charsInLoc.size());
-	for (int char_idx = 0; char_idx < num_char; ++char_idx)
+	Location* old_loc = m_theScenario->GetCharacterLocation(char_idx);
+	if (old_loc != nullptr && old_loc != this)
 	{
-		if (m_charsInLoc[char_idx] == nullptr)
-		{
-			m_charsInLoc[char_idx] = character;
-			return;
-		}
+		old_loc->ClearCharacterBit(char_idx);
 	}
 
-	m_charsInLoc.push_back(character);
+	const size_t word_idx = static_cast<size_t>(char_idx) / CHARACTERS_PER_PRESENCE_WORD;
+	if (word_idx >= m_charactersHere.size())
+	{
+		m_charactersHere.resize(word_idx + 1, 0);
+	}
+
+	m_charactersHere[word_idx] |= uint64_t(1) << (char_idx % CHARACTERS_PER_PRESENCE_WORD);
+	m_theScenario->SetCharacterLocation(char_idx, m_theScenario->GetLocationListIdx(this));
 }
 
 
 void Location::RemoveCharacterFromLocation(const Character* character)
 {
-	int num_char = static_cast<int>(m_charsInLoc.size());
-	for (int char_idx = 0; char_idx < num_char; ++char_idx)
+	const int char_idx = m_theScenario->GetCharacterListIdx(character);
+	if (!IsCharacterInLocation(char_idx))
 	{
-		if (m_charsInLoc[num_char] == character)
-		{
-			m_charsInLoc[num_char] = nullptr;
-			return;
-		}
+		return;
+	}
+
+	ClearCharacterBit(char_idx);
+	m_theScenario->SetCharacterLocation(char_idx, -1);
+}
+
+
+void Location::ClearCharacterBit(const int char_idx)
+{
+	const size_t word_idx = static_cast<size_t>(char_idx) / CHARACTERS_PER_PRESENCE_WORD;
+	if (word_idx < m_charactersHere.size())
+	{
+		m_charactersHere[word_idx] &= ~(uint64_t(1) << (char_idx % CHARACTERS_PER_PRESENCE_WORD));
 	}
 }
 
 
 void Location::SetState(const String& starting_state)
 {
-	int num_states = static_cast<int>(m_states.size());
-	for (int state_idx = 0; state_idx < num_states; ++state_idx)
+	SetState(m_theScenario->GetSymbolTable().Find(starting_state));
+}
+
+
+void Location::SetState(const SymbolId state_id)
+{
+	const int state_idx = m_states.FindStateIdx(state_id);
+	if (state_idx < 0)
 	{
-		if (StringToLower(m_states[state_idx].m_name) == starting_state)
-		{
-			m_currentState = m_states[state_idx];
-			return;
-		}
+		ERROR_AND_DIE(Stringf("StartingState for Card '%s' was not found in the list of states", m_name.c_str()));
 	}
 
-	ERROR_AND_DIE(Stringf("StartingState for Card '%s' was not found in the list of states", m_name.c_str()));
+	m_states.SetCurrentIdx(state_idx);
+}
+
+
+// Only called while playing, loading sets the state by name and the compile after it tests every incident anyway
+void Location::SetStateIdx(const int state_idx)
+{
+	m_states.SetCurrentIdx(state_idx);
+	m_theScenario->OnCardStateChanged(CARD_LOCATION, m_theScenario->GetLocationListIdx(this));
+}
+
+
+bool Location::HasState(const String& state_name) const
+{
+	return HasState(m_theScenario->GetSymbolTable().Find(state_name));
+}
+
+
+bool Location::HasState(const SymbolId state_id) const
+{
+	return m_states.HasState(state_id);
+}
+
+
+int Location::FindStateIdx(const SymbolId state_id) const
+{
+	return m_states.FindStateIdx(state_id);
 }
 
 
@@ -478,24 +577,26 @@ void Location::SetInvestigation(const bool set)
 
 void Location::ImportLocationStatesFromXml(const XmlElement* element)
 {
+	String element_name;
 	for (const XmlElement* child_element = element->FirstChildElement();
 		child_element;
 		child_element = child_element->NextSiblingElement()
 		)
 	{
-		String element_name(StringToLower(child_element->Name()));
+		FoldCase(child_element->Name(), element_name);
 		ASSERT_OR_DIE(element_name == "state", Stringf("Could not get State for Card %s", m_name.c_str()));
 
 		LocationState new_state;
+		String atr_name;
 		for (const XmlAttribute* attribute = child_element->FirstAttribute();
 			attribute;
 			attribute = attribute->Next())
 		{
-			String atr_name(StringToLower(attribute->Name()));
+			FoldCase(attribute->Name(), atr_name);
 
 			if (atr_name == "name")
 			{
-				new_state.m_name = attribute->Value();
+				new_state.m_nameId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "canmovehere")
 			{
@@ -532,17 +633,11 @@ void Location::ImportLocationStatesFromXml(const XmlElement* element)
 			}
 			else if (atr_name == "roomdir")
 			{
-				ASSERT_OR_DIE(m_defaultRoomMaterial != nullptr, "Need to have a default room texture before setting the state room texture");
-				
-				String file_name = Stringf("%s_%s_&s.mat", m_name.c_str(), 
-					new_state.m_name.c_str(), atr_name.c_str());;
-				new_state.m_roomMaterial = g_theRenderer->CreateOrGetMaterial(file_name, false);
-				new_state.m_roomMaterial->SetShader("default_lit.hlsl");
-				new_state.m_roomMaterial->m_shader->SetDepth(COMPARE_LESS_EQUAL, true);
+				LoadStateRoomImage(new_state, attribute->Value());
 			}
 		}
 
-		m_states.push_back(new_state);
+		m_states.Add(new_state);
 	}
 }
 
@@ -572,12 +667,13 @@ void Location::ImportLocationIntroductions(const XmlElement* element, CardType t
 	}
 	}
 
+	String element_name;
 	for (const XmlElement* child_element = element->FirstChildElement();
 		child_element;
 		child_element = child_element->NextSiblingElement()
 		)
 	{
-		String element_name(StringToLower(child_element->Name()));
+		FoldCase(child_element->Name(), element_name);
 		ASSERT_OR_DIE(element_name == "scan", Stringf("Could not get character introduction for Card %s", m_name.c_str()));
 
 
@@ -600,23 +696,24 @@ void Location::ImportLocationIntroductions(const XmlElement* element, CardType t
 		}
 
 		new_presentation->m_cardType = type;
+		String atr_name;
 		for (const XmlAttribute* attribute = child_element->FirstAttribute();
 			attribute;
 			attribute = attribute->Next())
 		{
-			String atr_name(StringToLower(attribute->Name()));
+			FoldCase(attribute->Name(), atr_name);
 
 			if (atr_name == "state")
 			{
-				new_presentation->m_locationState = StringToLower(attribute->Value());
+				new_presentation->m_locationStateId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "character" || atr_name == "item")
 			{
-				new_presentation->m_cardName = StringToLower(attribute->Value());
+				new_presentation->m_cardNameId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "characterstate" || atr_name == "itemstate")
 			{
-				new_presentation->m_cardState = StringToLower(attribute->Value());
+				new_presentation->m_cardStateId = m_theScenario->InternName(attribute->Value());
 			}
 			else if (atr_name == "line")
 			{
@@ -627,12 +724,12 @@ void Location::ImportLocationIntroductions(const XmlElement* element, CardType t
 		const XmlElement* grand_child_element = child_element->FirstChildElement();
 		if (grand_child_element != nullptr)
 		{
-			element_name = StringToLower(grand_child_element->Name());
+			FoldCase(grand_child_element->Name(), element_name);
 
 			if (element_name == "setcardstate")
 			{
 				new_presentation->m_actions.push_back(
-					new ActionChangeCardState(m_theScenario, grand_child_element)
+					m_theScenario->GetArena().Create<ActionChangeCardState>(m_theScenario, grand_child_element)
 				);
 			}
 
@@ -642,3 +739,116 @@ void Location::ImportLocationIntroductions(const XmlElement* element, CardType t
 }
 
 
+void Location::WriteToImage(ScenarioImageWriter& writer) const
+{
+	WriteCardToImage(writer);
+	writer.WriteString(m_defaultRoomDir);
+	writer.WriteString(m_theScenario->GetSymbolName(GetLocationState().m_nameId));
+
+	const uint num_states = m_states.GetNumStates();
+	writer.WriteU32(num_states);
+	for (uint state_idx = 0; state_idx < num_states; ++state_idx)
+	{
+		const LocationState& state = m_states.GetState(state_idx);
+		writer.WriteString(m_theScenario->GetSymbolName(state.m_nameId));
+		writer.WriteBool(state.m_canMoveHere);
+		writer.WriteBool(state.m_addGameTime);
+		writer.WriteString(state.m_description);
+		writer.WriteI32(state.m_specialAction);
+		writer.WriteString(state.m_roomDir);
+	}
+
+	WriteIntroductionsToImage(writer, m_presentingCharacterDialogue);
+	WriteIntroductionsToImage(writer, m_presentingItemDialogue);
+}
+
+
+void Location::LoadCardImage(const String& image_dir)
+{
+	SetCardImage(image_dir, AABB2(-(LOC_CARD_ASPECT_RATIO * LOC_CARD_HEIGHT), -LOC_CARD_HEIGHT, LOC_CARD_ASPECT_RATIO * LOC_CARD_HEIGHT, LOC_CARD_HEIGHT));
+}
+
+
+void Location::LoadDefaultRoomImage(const String& room_dir)
+{
+	m_defaultRoomDir = room_dir;
+	m_defaultRoomImage = g_theCardImageLoader->CreateOrGetImage(room_dir);
+}
+
+
+void Location::LoadStateRoomImage(LocationState& state, const String& room_dir)
+{
+	ASSERT_OR_DIE(m_defaultRoomImage != nullptr, "Need to have a default room texture before setting the state room texture");
+
+	state.m_roomDir = room_dir;
+	state.m_roomImage = g_theCardImageLoader->CreateOrGetImage(room_dir);
+}
+
+
+void Location::WriteIntroductionsToImage(ScenarioImageWriter& writer, const Intros& intros) const
+{
+	const uint num_intros = static_cast<uint>(intros.size());
+	writer.WriteU32(num_intros);
+
+	for (uint intro_idx = 0; intro_idx < num_intros; ++intro_idx)
+	{
+		const IntroFromLocation& intro = intros[intro_idx];
+		writer.WriteString(m_theScenario->GetSymbolName(intro.m_locationStateId));
+		writer.WriteString(m_theScenario->GetSymbolName(intro.m_cardNameId));
+		writer.WriteString(m_theScenario->GetSymbolName(intro.m_cardStateId));
+		writer.WriteString(intro.m_line);
+		WriteActionListToImage(writer, intro.m_actions);
+	}
+}
+
+
+void Location::ReadIntroductionsFromImage(ScenarioImageReader& reader, Intros& out_intros, const CardType type)
+{
+	const uint num_intros = reader.ReadU32();
+	out_intros.reserve(num_intros);
+
+	for (uint intro_idx = 0; intro_idx < num_intros; ++intro_idx)
+	{
+		out_intros.emplace_back();
+		IntroFromLocation& intro = out_intros.back();
+
+		intro.m_cardType = type;
+		intro.m_locationStateId = m_theScenario->InternName(reader.ReadString());
+		intro.m_cardNameId = m_theScenario->InternName(reader.ReadString());
+		intro.m_cardStateId = m_theScenario->InternName(reader.ReadString());
+		intro.m_line = reader.ReadString();
+		ReadActionListFromImage(intro.m_actions, m_theScenario, reader);
+	}
+}
+
+
+void Location::LinkReferences(StringList& out_errors)
+{
+	LinkIntroductions(m_presentingCharacterDialogue, out_errors);
+	LinkIntroductions(m_presentingItemDialogue, out_errors);
+}
+
+
+// The match keys stay symbol ids, linking only checks that every one of them names something real
+void Location::LinkIntroductions(Intros& intros, StringList& out_errors)
+{
+	const uint num_intros = static_cast<uint>(intros.size());
+	for (uint intro_idx = 0; intro_idx < num_intros; ++intro_idx)
+	{
+		IntroFromLocation& intro = intros[intro_idx];
+		const String referrer = Stringf("Location %s, introduction %u", m_name.c_str(), intro_idx);
+
+		if (intro.m_locationStateId != SYMBOL_WILDCARD && !HasState(intro.m_locationStateId))
+		{
+			out_errors.push_back(Stringf("%s: the location has no state '%s'", referrer.c_str(), m_theScenario->GetSymbolName(intro.m_locationStateId).c_str()));
+		}
+
+		if (intro.m_cardNameId != SYMBOL_WILDCARD)
+		{
+			const int card_idx = m_theScenario->LinkCardReference(intro.m_cardType, intro.m_cardNameId, referrer, out_errors);
+			m_theScenario->LinkStateReference(intro.m_cardType, card_idx, intro.m_cardStateId, referrer, out_errors);
+		}
+
+		LinkActionListReferences(intro.m_actions, referrer, out_errors);
+	}
+}
@@ -4,13 +4,14 @@
 struct LocationState
 {
 public:
-	String	m_name = "";
+	SymbolId	m_nameId = SYMBOL_EMPTY;
 	bool	m_canMoveHere = false;
 	bool	m_addGameTime = false;
 	String	m_description = "";
 
 	LocationSpecialAction	m_specialAction = LSA_NONE;
-	Material*				m_roomMaterial = nullptr;
+	String					m_roomDir = "";
+	CardImage*				m_roomImage = nullptr;
 };
 
 
@@ -21,12 +22,12 @@ public:
 	~IntroFromLocation();
 
 public:
-	String m_locationState = "*";
+	SymbolId m_locationStateId = SYMBOL_WILDCARD;
 
 	// either a character or item
 	CardType m_cardType = UNKNOWN_CARD_TYPE;
-	String m_cardName = "*";
-	String m_cardState = "*";
+	SymbolId m_cardNameId = SYMBOL_WILDCARD;
+	SymbolId m_cardStateId = SYMBOL_WILDCARD;
 
 	String m_line = "default dialogue for any card";
 	ActionList m_actions = ActionList();
@@ -40,12 +41,15 @@ public:
 	explicit Location(Scenario* the_setup);
 	explicit Location(Scenario* the_setup, const String& name, const StringList& list_of_nicknames, const String& desc);
 	explicit Location(Scenario* the_setup, const XmlElement* element);
+	explicit Location(Scenario* the_setup, ScenarioImageReader& reader);
 	~Location();
 
 	void Render() const override;
+	void UpdateCardImage() override;
 
 	// ACCESSORS
 	bool					IsCharacterInLocation(const Character* character) const;
+	bool					IsCharacterInLocation(int char_idx) const;
 	bool					GetLocationDescription(String& out) const;
 	bool					IntroduceCharacter(String& out, const Character* character);
 	bool					IntroduceItem(String& out, const Item* item);
@@ -53,24 +57,43 @@ public:
 	bool					IsPlayerInvestigatingRoom() const;
 	bool					CanSolveCaseHere() const;
 	const LocationState&	GetLocationState() const;
+	bool					HasState(const String& state_name) const;
+	bool					HasState(SymbolId state_id) const;
+	int						FindStateIdx(SymbolId state_id) const;	// -1 when there is no such state
 	String					GetAsString() const;
 
 	// MUTATORS
-	void AddCharacterToLocation(const Character* character);
+	void AddCharacterToLocation(int char_idx);
 	void RemoveCharacterFromLocation(const Character* character);
 	void SetState(const String& starting_state);
+	void SetState(SymbolId state_id);
+	void SetStateIdx(int state_idx);
 	void SetInvestigation(bool set);
 
 	void ImportLocationStatesFromXml(const XmlElement* element);
 	void ImportLocationIntroductions(const XmlElement* element, CardType type);
 
+	void WriteToImage(ScenarioImageWriter& writer) const;
+	void ReloadFromXml(const XmlElement* element);
+	void LinkReferences(StringList& out_errors);
+
+private:
+	void ImportFromXml(const XmlElement* element);
+	void LoadCardImage(const String& image_dir);
+	void LoadDefaultRoomImage(const String& room_dir);
+	void LoadStateRoomImage(LocationState& state, const String& room_dir);
+
+	void WriteIntroductionsToImage(ScenarioImageWriter& writer, const Intros& intros) const;
+	void ReadIntroductionsFromImage(ScenarioImageReader& reader, Intros& out_intros, CardType type);
+	void LinkIntroductions(Intros& intros, StringList& out_errors);
+	void ClearCharacterBit(int char_idx);
+
 private:
-	std::vector<const Character*> m_charsInLoc;
+	std::vector<uint64_t> m_charactersHere;		// one bit per character list idx
 
 	bool m_investigating = false;
 
-	LocationState			m_currentState;
-	LocStateList			m_states;
+	CardStateTable<LocationState>	m_states;
 
 	Intros			m_presentingCharacterDialogue;
 	Intros			m_presentingItemDialogue;
@@ -78,6 +101,7 @@ private:
 	const float LOC_CARD_HEIGHT = 30.0f;
 	const float LOC_CARD_ASPECT_RATIO = 2.2572855953372189841798501248959f;
 
-	Material* m_defaultRoomMaterial = nullptr; //can investigate will just check if this is not null
+	String m_defaultRoomDir = "";
+	CardImage* m_defaultRoomImage = nullptr; //can investigate will just check if this is not null
 	GPUMesh* m_defaultRoomMesh = nullptr;
 };
\ No newline at end of file
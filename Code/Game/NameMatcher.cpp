@@ -0,0 +1,204 @@
+#include "Game/NameMatcher.hpp"
+#include "Game/CaseFold.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+
+
+// Every byte of a UTF-8 sequence counts as a letter, so a name never ends halfway through an accented one
+static bool IsWordChar(const char c)
+{
+	const unsigned char byte = static_cast<unsigned char>(c);
+	return byte >= 0x80 || isalnum(byte) != 0;
+}
+
+
+//------------------------------------------------------------
+// Incidents are never typed by the player, so only the card lists go in
+void NameMatcher::Build(const std::vector<CardIndexName>& names)
+{
+	Clear();
+
+	// the trie is grown with a map from (state, character) to the next state, then flattened
+	std::unordered_map<uint64_t, uint32_t> trie_edges;
+	m_nameLengths.push_back(0);
+	m_kindMasks.push_back(0);
+
+	for (const CardIndexName& entry : names)
+	{
+		if (entry.m_kind == CARD_INDEX_INCIDENT || entry.m_name.empty())
+		{
+			continue;
+		}
+
+		const FoldedText folded(entry.m_name);
+		uint32_t state = ROOT_STATE;
+		for (const char c : folded.GetView())
+		{
+			const uint64_t edge_key = (static_cast<uint64_t>(state) << 8) | static_cast<unsigned char>(c);
+			std::unordered_map<uint64_t, uint32_t>::const_iterator edge_itr = trie_edges.find(edge_key);
+
+			if (edge_itr != trie_edges.end())
+			{
+				state = edge_itr->second;
+				continue;
+			}
+
+			const uint32_t new_state = static_cast<uint32_t>(m_nameLengths.size());
+			m_nameLengths.push_back(0);
+			m_kindMasks.push_back(0);
+			trie_edges.emplace(edge_key, new_state);
+			state = new_state;
+		}
+
+		m_nameLengths[state] = static_cast<uint32_t>(entry.m_name.size());
+		m_kindMasks[state] |= 1u << entry.m_kind;
+	}
+
+	const uint32_t num_states = static_cast<uint32_t>(m_nameLengths.size());
+
+	std::vector<std::pair<uint64_t, uint32_t>> sorted_edges(trie_edges.begin(), trie_edges.end());
+	std::sort(sorted_edges.begin(), sorted_edges.end());
+
+	m_edgeStart.assign(num_states + 1, 0);
+	m_edgeChars.reserve(sorted_edges.size());
+	m_edgeTargets.reserve(sorted_edges.size());
+	for (const std::pair<uint64_t, uint32_t>& edge : sorted_edges)
+	{
+		m_edgeStart[static_cast<uint32_t>(edge.first >> 8) + 1]++;
+		m_edgeChars.push_back(static_cast<unsigned char>(edge.first & 0xFF));
+		m_edgeTargets.push_back(edge.second);
+	}
+	for (uint32_t state = 0; state < num_states; ++state)
+	{
+		m_edgeStart[state + 1] += m_edgeStart[state];
+	}
+
+	// fail links breadth first, every shorter suffix is done before the states that need it
+	m_failStates.assign(num_states, ROOT_STATE);
+	m_outputStates.assign(num_states, NO_STATE);
+
+	std::vector<uint32_t> state_queue;
+	state_queue.reserve(num_states);
+	state_queue.push_back(ROOT_STATE);
+
+	for (size_t queue_idx = 0; queue_idx < state_queue.size(); ++queue_idx)
+	{
+		const uint32_t state = state_queue[queue_idx];
+
+		for (uint32_t edge_idx = m_edgeStart[state]; edge_idx < m_edgeStart[state + 1]; ++edge_idx)
+		{
+			const unsigned char folded_char = m_edgeChars[edge_idx];
+			const uint32_t child = m_edgeTargets[edge_idx];
+
+			uint32_t fail_state = m_failStates[state];
+			while (fail_state != ROOT_STATE && GetNextState(fail_state, folded_char) == NO_STATE)
+			{
+				fail_state = m_failStates[fail_state];
+			}
+
+			const uint32_t suffix_state = GetNextState(fail_state, folded_char);
+			m_failStates[child] = (suffix_state != NO_STATE && suffix_state != child) ? suffix_state : ROOT_STATE;
+
+			const uint32_t child_fail = m_failStates[child];
+			m_outputStates[child] = m_nameLengths[child_fail] > 0 ? child_fail : m_outputStates[child_fail];
+
+			state_queue.push_back(child);
+		}
+	}
+}
+
+
+void NameMatcher::Clear()
+{
+	m_edgeStart.clear();
+	m_edgeChars.clear();
+	m_edgeTargets.clear();
+	m_failStates.clear();
+	m_outputStates.clear();
+	m_nameLengths.clear();
+	m_kindMasks.clear();
+}
+
+
+// One step per character of the text, then the mentions found are sorted and the overlapping ones dropped
+void NameMatcher::FindMentions(const std::string_view text, std::vector<NameMention>& out_mentions) const
+{
+	out_mentions.clear();
+	if (m_nameLengths.empty())
+	{
+		return;
+	}
+
+	const FoldedText folded(text);
+	const std::string_view folded_text = folded.GetView();
+
+	uint32_t state = ROOT_STATE;
+	for (size_t char_idx = 0; char_idx < folded_text.size(); ++char_idx)
+	{
+		const unsigned char folded_char = static_cast<unsigned char>(folded_text[char_idx]);
+
+		uint32_t next_state = GetNextState(state, folded_char);
+		while (next_state == NO_STATE && state != ROOT_STATE)
+		{
+			state = m_failStates[state];
+			next_state = GetNextState(state, folded_char);
+		}
+		state = next_state == NO_STATE ? ROOT_STATE : next_state;
+
+		const size_t mention_end = char_idx + 1;
+		if (mention_end < text.size() && IsWordChar(text[mention_end]))
+		{
+			continue;
+		}
+
+		uint32_t name_state = m_nameLengths[state] > 0 ? state : m_outputStates[state];
+		for (; name_state != NO_STATE; name_state = m_outputStates[name_state])
+		{
+			const size_t mention_begin = mention_end - m_nameLengths[name_state];
+			if (mention_begin == 0 || !IsWordChar(text[mention_begin - 1]))
+			{
+				out_mentions.push_back({ static_cast<uint32_t>(mention_begin), m_nameLengths[name_state], m_kindMasks[name_state] });
+			}
+		}
+	}
+
+	std::sort(out_mentions.begin(), out_mentions.end(), [](const NameMention& lhs, const NameMention& rhs)
+	{
+		return lhs.m_begin != rhs.m_begin ? lhs.m_begin < rhs.m_begin : lhs.m_length > rhs.m_length;
+	});
+
+	size_t num_kept = 0;
+	uint32_t covered_end = 0;
+	for (const NameMention& mention : out_mentions)
+	{
+		if (num_kept == 0 || mention.m_begin >= covered_end)
+		{
+			out_mentions[num_kept++] = mention;
+			covered_end = mention.m_begin + mention.m_length;
+		}
+	}
+	out_mentions.resize(num_kept);
+}
+
+
+uint NameMatcher::GetNumStates() const
+{
+	return static_cast<uint>(m_nameLengths.size());
+}
+
+
+uint32_t NameMatcher::GetNextState(const uint32_t state, const unsigned char folded_char) const
+{
+	const unsigned char* first_char = m_edgeChars.data() + m_edgeStart[state];
+	const unsigned char* end_char = m_edgeChars.data() + m_edgeStart[state + 1];
+	const unsigned char* edge_char = std::lower_bound(first_char, end_char, folded_char);
+
+	if (edge_char == end_char || *edge_char != folded_char)
+	{
+		return NO_STATE;
+	}
+
+	return m_edgeTargets[edge_char - m_edgeChars.data()];
+}
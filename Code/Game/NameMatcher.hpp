@@ -0,0 +1,47 @@
+#pragma once
+#include "Game/CardIndex.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+// Finds every card name and nickname mentioned in a line of player input in one pass, Aho-Corasick over the case
+// folded names. The trie edges of each state are stored together and sorted, so the automaton stays a few flat arrays
+// however many names there are. Mentions have to start and end on word boundaries, and where they overlap the one
+// starting first wins, then the longest, so "ask doyle about the bridge club" finds "doyle" and "bridge club".
+
+struct NameMention
+{
+	uint32_t	m_begin = 0;
+	uint32_t	m_length = 0;
+	uint		m_kindMask = 0;			// 1 << CardIndexKind of every list the name is in
+};
+
+
+//------------------------------------------------------------
+class NameMatcher
+{
+public:
+	void	Build(const std::vector<CardIndexName>& names);
+	void	Clear();
+
+	void	FindMentions(std::string_view text, std::vector<NameMention>& out_mentions) const;
+
+	uint	GetNumStates() const;
+
+private:
+	static constexpr uint32_t ROOT_STATE = 0;
+	static constexpr uint32_t NO_STATE = 0xFFFFFFFFu;
+
+	uint32_t	GetNextState(uint32_t state, unsigned char folded_char) const;	// NO_STATE when the trie has no edge
+
+private:
+	// edges of state n are m_edgeChars/m_edgeTargets[m_edgeStart[n], m_edgeStart[n + 1]), sorted by character
+	std::vector<uint32_t>		m_edgeStart;
+	std::vector<unsigned char>	m_edgeChars;
+	std::vector<uint32_t>		m_edgeTargets;
+
+	std::vector<uint32_t>		m_failStates;		// longest proper suffix that is also in the trie
+	std::vector<uint32_t>		m_outputStates;		// nearest suffix state that ends a name, NO_STATE when none
+	std::vector<uint32_t>		m_nameLengths;		// length of the name ending at the state, 0 when none does
+	std::vector<uint>			m_kindMasks;
+};
@@ -11,12 +11,123 @@
 #include "Game/Condition.hpp"
 #include "Game/Action.hpp"
 #include "Game/VictoryCondition.hpp"
+#include "Game/ScenarioImage.hpp"
+#include "Game/ScenarioBenchmarks.hpp"
+#include "Game/CompletionIndex.hpp"
+#include "Game/CaseFold.hpp"
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Memory/Mem.hpp"
 #include "Engine/Renderer/ImGUISystem.hpp"
 
+#include <future>
+
+
+static const char* s_scenarioFileNames[NUM_SCENARIO_FILES] =
+{
+	"Locations.xml",
+	"Characters.xml",
+	"Items.xml",
+	"Settings.xml",
+	"Incidents.xml",
+	"VictoryConditions.xml"
+};
+
+
+static const char* s_cardTypeNames[NUM_CARD_TYPES] =
+{
+	"location",
+	"character",
+	"item"
+};
+
+
+static String GetElementName(const XmlElement* element)
+{
+	for (const XmlAttribute* attribute = element->FirstAttribute();
+		attribute;
+		attribute = attribute->Next()
+		)
+	{
+		if (IsFoldedEqual(attribute->Name(), "name"))
+		{
+			String folded_name;
+			FoldCase(attribute->Value(), folded_name);
+			return folded_name;
+		}
+	}
+
+	return "";
+}
+
+
+static uint HashElement(const XmlElement* element)
+{
+	tinyxml2::XMLPrinter printer(nullptr, true);
+	element->Accept(&printer);
+
+	return HashBytes(printer.CStr(), static_cast<size_t>(printer.CStrSize()));
+}
+
+
+static std::filesystem::file_time_type GetFileWriteTime(const String& file_path)
+{
+	std::error_code error;
+	const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(file_path, error);
+
+	return error ? std::filesystem::file_time_type::min() : write_time;
+}
+
+
+// Only parses the document, errors are reported by Scenario::ValidateXmlFile on the main thread
+static void LoadXmlFile(tinyxml2::XMLDocument* out, const String& file_path)
+{
+	out->LoadFile(file_path.c_str());
+}
+
+
+// Hashes the bytes of all the scenario files along with the loader and image versions, 0 if a file can't be read
+static uint HashScenarioFolder(const char* folder_dir)
+{
+	uint hash = HashBytes(&SCENARIO_LOADER_VERSION, sizeof(SCENARIO_LOADER_VERSION));
+	hash = HashBytes(&SCENARIO_IMAGE_VERSION, sizeof(SCENARIO_IMAGE_VERSION), hash);
+
+	std::vector<unsigned char> file_bytes;
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		const String file_path = String(folder_dir) + "/" + s_scenarioFileNames[file_idx];
+
+		FILE* file = fopen(file_path.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return 0;
+		}
+
+		fseek(file, 0, SEEK_END);
+		const long file_size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		file_bytes.resize(file_size > 0 ? static_cast<size_t>(file_size) : 0);
+		const size_t bytes_read = fread(file_bytes.data(), 1, file_bytes.size(), file);
+		fclose(file);
+
+		if (bytes_read != file_bytes.size())
+		{
+			return 0;
+		}
+
+		// the size keeps bytes moving from one file to the next from hashing the same
+		const uint32_t size_marker = static_cast<uint32_t>(bytes_read);
+		hash = HashBytes(&size_marker, sizeof(size_marker), hash);
+		hash = HashBytes(file_bytes.data(), file_bytes.size(), hash);
+	}
+
+	return hash;
+}
+
 // Debugging ------------------------------------------------------------
 
 
@@ -31,10 +142,10 @@ STATIC bool DumpLocations(EventArgs& args)
 	g_theDevConsole->PrintString(Rgba::GREEN, "Locations:");
 	for (int loc_idx = 0; loc_idx < num_locs; ++loc_idx)
 	{
-		const String loc_name = locations->at(loc_idx).GetName();
+		const String& loc_name = locations->at(loc_idx).GetName();
 		String line = loc_name;
 
-		StringList nn_list = locations->at(loc_idx).GetListOfNicknames();
+		const StringList& nn_list = locations->at(loc_idx).GetListOfNicknames();
 		const int num_nn = static_cast<int>(nn_list.size());
 		for (int nn_idx = 0; nn_idx < num_nn; ++nn_idx)
 		{
@@ -60,10 +171,10 @@ STATIC bool DumpCharacter(EventArgs& args)
 	g_theDevConsole->PrintString(Rgba::GREEN, "Characters:");
 	for (int char_idx = 0; char_idx < num_char; ++char_idx)
 	{
-		const String char_name = characters->at(char_idx).GetName();
+		const String& char_name = characters->at(char_idx).GetName();
 		String line = char_name;
 
-		StringList nn_list = characters->at(char_idx).GetListOfNicknames();
+		const StringList& nn_list = characters->at(char_idx).GetListOfNicknames();
 		const int num_nn = static_cast<int>(nn_list.size());
 		for (int nn_idx = 0; nn_idx < num_nn; ++nn_idx)
 		{
@@ -89,10 +200,10 @@ STATIC bool DumpItems(EventArgs& args)
 	g_theDevConsole->PrintString(Rgba::GREEN, "Items:");
 	for (int item_idx = 0; item_idx < num_items; ++item_idx)
 	{
-		String item_name = items->at(item_idx).GetName();
+		const String& item_name = items->at(item_idx).GetName();
 		String line = item_name.c_str();
 
-		StringList nn_list = items->at(item_idx).GetListOfNicknames();
+		const StringList& nn_list = items->at(item_idx).GetListOfNicknames();
 		const int num_nn = static_cast<int>(nn_list.size());
 		for (int nn_idx = 0; nn_idx < num_nn; ++nn_idx)
 		{
@@ -117,7 +228,7 @@ STATIC bool DumpIncident(EventArgs& args)
 	g_theDevConsole->PrintString(Rgba::GREEN, "Incidences:");
 	for (int incident_idx = 0; incident_idx < num_incidences; ++incident_idx)
 	{
-		String event_name = incidences->at(incident_idx).GetName();
+		const String& event_name = incidences->at(incident_idx).GetName();
 		IncidentType event_type = incidences->at(incident_idx).GetType();
 		bool is_enabled = incidences->at(incident_idx).IsIncidentEnabled();
 
@@ -158,7 +269,7 @@ STATIC bool DumpIncident(EventArgs& args)
 		for (int trigger_idx = 0; trigger_idx < num_triggers; ++trigger_idx)
 		{
 			String new_line = "\n                              ";
-			String trigger_name = triggers->at(trigger_idx)->GetName();
+			const String& trigger_name = triggers->at(trigger_idx)->GetName();
 
 			const ConditionList* conditions = triggers->at(trigger_idx)->GetConditionList();
 			const ActionList* actions = triggers->at(trigger_idx)->GetActionList();
@@ -194,25 +305,140 @@ STATIC bool DumpIncident(EventArgs& args)
 }
 
 
-// Game Actions ---------------------------------------------------------
-STATIC bool TravelToLocation(EventArgs& args)
+STATIC bool CompileScenario(EventArgs& args)
+{
+	const String folder_dir = args.GetValue("folder", String("Data/Scenarios/Tutorial"));
+	const String image_path = folder_dir + "/" + SCENARIO_IMAGE_FILE_NAME;
+
+	// loading the settings overwrites the global messages of the running scenario
+	const String intro_message = g_introMessage;
+	const String closed_location_message = g_closedLocationMessage;
+	const String same_location_message = g_sameLocationMessage;
+	const String unknown_command_message = g_unknownCommandMessage;
+
+	Scenario* scenario_to_compile = new Scenario(nullptr);
+	scenario_to_compile->LoadInScenarioFile(folder_dir.c_str());
+	const bool saved = scenario_to_compile->SaveScenarioImage(image_path.c_str());
+	delete scenario_to_compile;
+
+	g_introMessage = intro_message;
+	g_closedLocationMessage = closed_location_message;
+	g_sameLocationMessage = same_location_message;
+	g_unknownCommandMessage = unknown_command_message;
+
+	if (saved)
+	{
+		g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Compiled %s into %s", folder_dir.c_str(), image_path.c_str()));
+	}
+	else
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("Failed to compile %s", folder_dir.c_str()));
+	}
+
+	return true;
+}
+
+
+STATIC bool ReloadScenario(EventArgs& args)
 {
-	// args will be card = "item name"
+	UNUSED(args);
+
 	Scenario* current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	current_scenario->ReloadScenarioFiles(true);
+
+	return true;
+}
+
+
+STATIC bool BenchmarkLookup(EventArgs& args)
+{
+	const int num_names = args.GetValue("names", 100000);
+	const int num_queries = args.GetValue("queries", 1000000);
+
+	const Scenario* current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
+	BenchmarkScenarioCardLookup(*current_scenario, static_cast<uint>(num_names), static_cast<uint>(num_queries));
+
+	return true;
+}
+
+
+STATIC bool BenchmarkTurn(EventArgs& args)
+{
+	const int num_turns = args.GetValue("turns", 10000);
+
+	Game* the_game = g_theApp->GetTheGame();
+	BenchmarkScenarioTurns(*the_game->GetCurrentScenario(), *the_game->GetDialogueSystem(), static_cast<uint>(num_turns));
+
+	return true;
+}
+
+
+STATIC bool BenchmarkIncidents(EventArgs& args)
+{
+	const int num_passes = args.GetValue("passes", 100);
+
+	Scenario* current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
+	BenchmarkScenarioIncidentTests(*current_scenario, static_cast<uint>(num_passes));
+
+	return true;
+}
+
+
+STATIC bool BenchmarkFuzzy(EventArgs& args)
+{
+	const int num_names = args.GetValue("names", 30000);
+	const int num_queries = args.GetValue("queries", 100000);
+
+	const Scenario* current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
+	BenchmarkScenarioFuzzyMatch(*current_scenario, static_cast<uint>(num_names), static_cast<uint>(num_queries));
+
+	return true;
+}
+
+
+STATIC bool BenchmarkComplete(EventArgs& args)
+{
+	const int num_names = args.GetValue("names", 100000);
+
+	const Scenario* current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
+	BenchmarkScenarioCompletion(*current_scenario, static_cast<uint>(num_names));
+
+	return true;
+}
+
+
+STATIC bool PrintScenarioArena(EventArgs& args)
+{
+	UNUSED(args);
+
+	const Scenario* current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
+	current_scenario->PrintArenaStats();
+
+	return true;
+}
+
+
+// Game Actions ---------------------------------------------------------
+STATIC bool TravelToLocation(const DialogueCommand& command)
+{
+	// the card is the location name
+	Scenario* current_scenario = command.m_scenario;
+	DialogueSystem* ds = command.m_dialogueSystem;
 
 	Location* cur_loc = current_scenario->GetCurrentLocation();
 	cur_loc->SetInvestigation(false);
 	
 	//find the location in case the player uses a nick name
-	LookupItr loc_itr;
+	int loc_idx = -1;
 	String log;
-	String loc_name = args.GetValue("card", String("something and nothing"));
-	const bool is_in_list = current_scenario->IsLocationInLookupTable(loc_itr, String(loc_name));
+	const std::string_view loc_name = command.m_card;
+	CardIndexKind near_kind = CARD_INDEX_LOCATION;
+	const bool is_in_list = current_scenario->IsLocationInLookupTable(loc_idx, loc_name)
+		|| current_scenario->IsCardNearLookupTable(loc_idx, near_kind, FUZZY_KIND_LOCATION, loc_name);
 
 	if (is_in_list)
 	{
-		Location* new_loc = current_scenario->GetLocationFromList(loc_itr->second);
+		Location* new_loc = current_scenario->GetLocationFromList(loc_idx);
 		const bool valid_transition = new_loc->GetLocationDescription(log);
 
 		if (valid_transition)
@@ -245,29 +471,41 @@ STATIC bool TravelToLocation(EventArgs& args)
 }
 
 
-STATIC bool AskLocationForCharacter(EventArgs& args)
+// Brings the character up at the current location and makes them the interest when they are there. Charges no time
+// and tests nothing, that is left to the command
+static bool IntroduceCharacterHere(Scenario* current_scenario, Character* character, String& log)
 {
-	String		char_name = args.GetValue("card", String("something and nothing"));
-	Scenario*	current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	const bool is_here = current_scenario->GetCurrentLocation()->IntroduceCharacter(log, character);
+	character->SetPosition(Vec2(ENTITY_POS_X, ENTITY_POS_Y));
+
+	if (is_here)
+	{
+		current_scenario->SetInterest(character);
+	}
+
+	return is_here;
+}
+
+
+STATIC bool AskLocationForCharacter(const DialogueCommand& command)
+{
+	const std::string_view	char_name = command.m_card;
+	Scenario*	current_scenario = command.m_scenario;
+	DialogueSystem* ds = command.m_dialogueSystem;
 
 	//find the character in case the player is uses a nick name
-	LookupItr char_itr;
-	const bool is_char_in_list = current_scenario->IsCharacterInLookupTable(char_itr, String(char_name));
+	int char_idx = -1;
+	CardIndexKind near_kind = CARD_INDEX_CHARACTER;
+	const bool is_char_in_list = current_scenario->IsCharacterInLookupTable(char_idx, char_name)
+		|| current_scenario->IsCardNearLookupTable(char_idx, near_kind, FUZZY_KIND_CHARACTER, char_name);
 
 	String log;
 	if (is_char_in_list)
 	{
-		Location* cur_loc = current_scenario->GetCurrentLocation();
-		Character* char_subject = current_scenario->GetCharacterFromList(char_itr->second);
+		Character* char_subject = current_scenario->GetCharacterFromList(char_idx);
 
-		const bool is_subject_here = cur_loc->IntroduceCharacter(log, char_subject);
-		char_subject->SetPosition(Vec2(ENTITY_POS_X, ENTITY_POS_Y));
-		
-		if (is_subject_here)
+		if (IntroduceCharacterHere(current_scenario, char_subject, log))
 		{
-			current_scenario->SetInterest(char_subject);
-
 			if(char_subject->GetCharacterState().m_addGameTime)
 			{
 				current_scenario->AddGameTime(current_scenario->GetInterrogateChangeTime(), 0);
@@ -292,21 +530,23 @@ STATIC bool AskLocationForCharacter(EventArgs& args)
 }
 
 
-STATIC bool AskLocationForItem(EventArgs& args)
+STATIC bool AskLocationForItem(const DialogueCommand& command)
 {
-	String		char_name = args.GetValue("card", String("something and nothing"));
-	Scenario*	current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	const std::string_view	char_name = command.m_card;
+	Scenario*	current_scenario = command.m_scenario;
+	DialogueSystem* ds = command.m_dialogueSystem;
 
 	//find the item in case the player is uses a nickname
-	LookupItr item_itr;
-	const bool is_item_in_list = current_scenario->IsItemInLookupTable(item_itr, String(char_name));
+	int item_idx = -1;
+	CardIndexKind near_kind = CARD_INDEX_ITEM;
+	const bool is_item_in_list = current_scenario->IsItemInLookupTable(item_idx, char_name)
+		|| current_scenario->IsCardNearLookupTable(item_idx, near_kind, FUZZY_KIND_ITEM, char_name);
 
 	String log;
 	if (is_item_in_list)
 	{
 		Location* cur_loc = current_scenario->GetCurrentLocation();
-		Item* item_subject = current_scenario->GetItemFromList(item_itr->second);
+		Item* item_subject = current_scenario->GetItemFromList(item_idx);
 
 		const bool is_subject_here = cur_loc->IntroduceItem(log, item_subject);
 		item_subject->SetPosition(Vec2(ENTITY_POS_X, ENTITY_POS_Y));
@@ -340,15 +580,39 @@ STATIC bool AskLocationForItem(EventArgs& args)
 }
 
 
-STATIC bool InterrogateCharacter(EventArgs& args)
+STATIC bool InterrogateCharacter(const DialogueCommand& command)
 {
-	// args will be card = "character name"
-	String		name = args.GetValue("card", String("something and nothing"));
-	Scenario*	current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	// the card is the character or item asked about, or the target is who is asked and the subject what about
+	std::string_view	name = command.m_card;
+	Scenario*	current_scenario = command.m_scenario;
+	DialogueSystem* ds = command.m_dialogueSystem;
 
 	String log;
 
+	if (!command.m_subject.empty())
+	{
+		// asking someone who is not the current interest talks to them first, only the question is charged
+		int target_idx = -1;
+
+		if (current_scenario->IsCharacterInLookupTable(target_idx, command.m_target)
+			&& current_scenario->GetCurrentInterest() != current_scenario->GetCharacterFromList(target_idx))
+		{
+			const bool is_target_here = IntroduceCharacterHere(current_scenario, current_scenario->GetCharacterFromList(target_idx), log);
+			ds->AddLog(LOG_CHARACTER, log);
+			log.clear();
+
+			if (!is_target_here)
+			{
+				current_scenario->AddGameTime(current_scenario->GetWastingTime(), 0);
+				current_scenario->TestIncidents();
+				current_scenario->TestVictoryConditions();
+				return true;
+			}
+		}
+
+		name = command.m_subject;
+	}
+
 	current_scenario->SetSubject(nullptr);
 	
 	Card* current_interest = current_scenario->GetCurrentInterest();
@@ -369,10 +633,10 @@ STATIC bool InterrogateCharacter(EventArgs& args)
 		}
 		else
 		{
-			LookupItr interrogatee_itr;
-			current_scenario->IsCharacterInLookupTable(interrogatee_itr, current_interest->GetName());
-			Character* interrogatee = current_scenario->GetCharacterFromList(interrogatee_itr->second);
-			CharacterState interrogatee_state = interrogatee->GetCharacterState();
+			int interrogatee_idx = -1;
+			current_scenario->IsCharacterInLookupTable(interrogatee_idx, current_interest->GetName());
+			Character* interrogatee = current_scenario->GetCharacterFromList(interrogatee_idx);
+			const CharacterState& interrogatee_state = interrogatee->GetCharacterState();
 			
 			if(interrogatee_state.m_contextMode == CONTEXT_NONE)
 			{
@@ -383,12 +647,20 @@ STATIC bool InterrogateCharacter(EventArgs& args)
 			{
 				Location* cur_loc = current_scenario->GetCurrentLocation();
 
-				LookupItr card_itr;
-				const bool is_char = current_scenario->IsCharacterInLookupTable(card_itr, String(name));
+				int card_idx = -1;
+				bool is_char = current_scenario->IsCharacterInLookupTable(card_idx, name);
+				bool is_item = !is_char && current_scenario->IsItemInLookupTable(card_idx, name);
+
+				CardIndexKind near_kind = CARD_INDEX_CHARACTER;
+				if (!is_char && !is_item && current_scenario->IsCardNearLookupTable(card_idx, near_kind, FUZZY_KIND_CHARACTER | FUZZY_KIND_ITEM, name))
+				{
+					is_char = near_kind == CARD_INDEX_CHARACTER;
+					is_item = near_kind == CARD_INDEX_ITEM;
+				}
 
 				if(is_char)
 				{
-					Character* about_char = current_scenario->GetCharacterFromList(card_itr->second);
+					Character* about_char = current_scenario->GetCharacterFromList(card_idx);
 					current_scenario->SetSubject(about_char);
 					interrogatee->AskAboutCharacter(log, cur_loc, about_char);
 
@@ -397,27 +669,22 @@ STATIC bool InterrogateCharacter(EventArgs& args)
 						current_scenario->AddGameTime(current_scenario->GetInterrogateChangeTime(), 0);
 					}
 				}
-				else 
+				else if(is_item)
 				{
-					const bool is_item = current_scenario->IsItemInLookupTable(card_itr, String(name));
+					Item* about_item = current_scenario->GetItemFromList(card_idx);
+					current_scenario->SetSubject(about_item);
+					interrogatee->AskAboutItem(log, cur_loc, about_item);
 
-					if(is_item)
-					{
-						Item* about_item = current_scenario->GetItemFromList(card_itr->second);
-						current_scenario->SetSubject(about_item);
-						interrogatee->AskAboutItem(log, cur_loc, about_item);
-
-						if (interrogatee->GetCharacterState().m_addGameTime)
-						{
-							current_scenario->AddGameTime(current_scenario->GetInterrogateChangeTime(), 0);
-						}
-					}
-					else
+					if (interrogatee->GetCharacterState().m_addGameTime)
 					{
-						log += "> Asking about an unknown item or card.";
-						current_scenario->AddGameTime(current_scenario->GetWastingTime(), 0);
+						current_scenario->AddGameTime(current_scenario->GetInterrogateChangeTime(), 0);
 					}
 				}
+				else
+				{
+					log += "> Asking about an unknown item or card.";
+					current_scenario->AddGameTime(current_scenario->GetWastingTime(), 0);
+				}
 			}
 		}
 	}
@@ -430,10 +697,9 @@ STATIC bool InterrogateCharacter(EventArgs& args)
 }
 
 
-STATIC bool SayGoodbyToCharacter(EventArgs& args)
+STATIC bool SayGoodbyToCharacter(const DialogueCommand& command)
 {
-	String		name = args.GetValue("card", String("something and nothing"));
-	Scenario*	current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
+	Scenario*	current_scenario = command.m_scenario;
 
 	current_scenario->SetInterest(nullptr);
 	current_scenario->SetSubject(nullptr);
@@ -446,11 +712,11 @@ STATIC bool SayGoodbyToCharacter(EventArgs& args)
 
 
 
-STATIC bool InvestigateRoom(EventArgs& args)
+STATIC bool InvestigateRoom(const DialogueCommand& command)
 {
-	UNUSED(args);
-	Scenario*	current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	UNUSED(command);
+	Scenario*	current_scenario = command.m_scenario;
+	DialogueSystem* ds = command.m_dialogueSystem;
 
 	Location* cur_location = current_scenario->GetCurrentLocation();
 
@@ -472,11 +738,11 @@ STATIC bool InvestigateRoom(EventArgs& args)
 }
 
 
-STATIC bool LeaveRoom(EventArgs& args)
+STATIC bool LeaveRoom(const DialogueCommand& command)
 {
-	UNUSED(args);
-	Scenario*	current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	UNUSED(command);
+	Scenario*	current_scenario = command.m_scenario;
+	DialogueSystem* ds = command.m_dialogueSystem;
 
 	Location* cur_location = current_scenario->GetCurrentLocation();
 
@@ -493,11 +759,11 @@ STATIC bool LeaveRoom(EventArgs& args)
 }
 
 
-STATIC bool SolveScenario(EventArgs& args)
+STATIC bool SolveScenario(const DialogueCommand& command)
 {
-	UNUSED(args);
-	Scenario*	current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	UNUSED(command);
+	Scenario*	current_scenario = command.m_scenario;
+	DialogueSystem* ds = command.m_dialogueSystem;
 
 	Location* cur_location = current_scenario->GetCurrentLocation();
 
@@ -527,12 +793,12 @@ STATIC bool SolveScenario(EventArgs& args)
 }
 
 
-STATIC bool ListEvidence(EventArgs& args)
+STATIC bool ListEvidence(const DialogueCommand& command)
 {
-	const String		name = args.GetValue("card", String("something and nothing"));
-	const String		name_lower = StringToLower(name);
-	Scenario*	current_scenario = g_theApp->GetTheGame()->GetCurrentScenario();
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	String name_lower;
+	FoldCase(command.m_card, name_lower);
+	Scenario*	current_scenario = command.m_scenario;
+	DialogueSystem* ds = command.m_dialogueSystem;
 
 	String result;
 
@@ -609,20 +875,20 @@ STATIC bool ListEvidence(EventArgs& args)
 }
 
 
-STATIC bool ClearCommandDs(EventArgs& args)
+STATIC bool ClearCommandDs(const DialogueCommand& command)
 {
-	UNUSED(args);
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	UNUSED(command);
+	DialogueSystem* ds = command.m_dialogueSystem;
 	ds->ClearLog();
 
 	return true;
 }
 
 
-STATIC bool HelpCommandDs(EventArgs& args)
+STATIC bool HelpCommandDs(const DialogueCommand& command)
 {
-	UNUSED(args);
-	DialogueSystem* ds = g_theApp->GetTheGame()->GetDialogueSystem();
+	UNUSED(command);
+	DialogueSystem* ds = command.m_dialogueSystem;
 	StringList event_names;
 
 	String log = "Valid Commands: \n";
@@ -648,30 +914,18 @@ void Scenario::Startup()
 	g_theEventSystem->SubscribeEventCallbackFunction("dump_chars", DumpCharacter);
 	g_theEventSystem->SubscribeEventCallbackFunction("dump_items", DumpItems);
 	g_theEventSystem->SubscribeEventCallbackFunction("dump_events", DumpIncident);
+	g_theEventSystem->SubscribeEventCallbackFunction("compile_scenario", CompileScenario);
+	g_theEventSystem->SubscribeEventCallbackFunction("reload_scenario", ReloadScenario);
+	g_theEventSystem->SubscribeEventCallbackFunction("scenario_arena", PrintScenarioArena);
+	g_theEventSystem->SubscribeEventCallbackFunction("bench_lookup", BenchmarkLookup);
+	g_theEventSystem->SubscribeEventCallbackFunction("bench_fuzzy", BenchmarkFuzzy);
+	g_theEventSystem->SubscribeEventCallbackFunction("bench_complete", BenchmarkComplete);
+	g_theEventSystem->SubscribeEventCallbackFunction("bench_turn", BenchmarkTurn);
+	g_theEventSystem->SubscribeEventCallbackFunction("bench_incidents", BenchmarkIncidents);
 
 
-	g_theDialogueEventSystem = new EventSystem();
-
-	// when the player is interacting with a location
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[GOTO_LOCATION], TravelToLocation);
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[TALK_TO_CHARACTER], AskLocationForCharacter);
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[VIEW_ITEM], AskLocationForItem);
-
-	// when the player is interacting with a character
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[ASK_CHARACTER], InterrogateCharacter);
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[SAY_GOODBYE], SayGoodbyToCharacter);
-
-	// Investigating a room
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[INVESTIGATE_ROOM], InvestigateRoom);
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[LEAVE_ROOM], LeaveRoom);
-
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[SOLVE_SCENARIO], SolveScenario);
-
-	
-	// Dialogue System helper functions	
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[LOOK_OVER_NOTES], ListEvidence);
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[CLEAR_CONSOLE], ClearCommandDs);
-	g_theDialogueEventSystem->SubscribeEventCallbackFunction(g_validCommands[CONSOLE_HELP], HelpCommandDs);
+	g_theDialogueCommands = new DialogueCommandTable();
+	SubscribeDialogueCommands(*g_theDialogueCommands);
 
 
 	Vec2 frame_resolution = g_gameConfigBlackboard.GetValue(
@@ -694,14 +948,59 @@ void Scenario::Startup()
 
 void Scenario::Shutdown()
 {
-	delete g_theDialogueEventSystem;
-	g_theDialogueEventSystem = nullptr;
+	// the game can swap scenarios, the next one subscribes these again
+	g_theEventSystem->UnsubscribeEventCallbackFunction("dump_locs", DumpLocations);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("dump_chars", DumpCharacter);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("dump_items", DumpItems);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("dump_events", DumpIncident);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("compile_scenario", CompileScenario);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("reload_scenario", ReloadScenario);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("scenario_arena", PrintScenarioArena);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("bench_lookup", BenchmarkLookup);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("bench_fuzzy", BenchmarkFuzzy);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("bench_complete", BenchmarkComplete);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("bench_turn", BenchmarkTurn);
+	g_theEventSystem->UnsubscribeEventCallbackFunction("bench_incidents", BenchmarkIncidents);
+
+	delete g_theDialogueCommands;
+	g_theDialogueCommands = nullptr;
+}
+
+
+STATIC void Scenario::SubscribeDialogueCommands(DialogueCommandTable& commands)
+{
+	// when the player is interacting with a location
+	commands.Subscribe(GOTO_LOCATION, TravelToLocation);
+	commands.Subscribe(TALK_TO_CHARACTER, AskLocationForCharacter);
+	commands.Subscribe(VIEW_ITEM, AskLocationForItem);
+
+	// when the player is interacting with a character
+	commands.Subscribe(ASK_CHARACTER, InterrogateCharacter);
+	commands.Subscribe(SAY_GOODBYE, SayGoodbyToCharacter);
+
+	// Investigating a room
+	commands.Subscribe(INVESTIGATE_ROOM, InvestigateRoom);
+	commands.Subscribe(LEAVE_ROOM, LeaveRoom);
+
+	commands.Subscribe(SOLVE_SCENARIO, SolveScenario);
+
+	// Dialogue System helper functions	
+	commands.Subscribe(LOOK_OVER_NOTES, ListEvidence);
+	commands.Subscribe(CLEAR_CONSOLE, ClearCommandDs);
+	commands.Subscribe(CONSOLE_HELP, HelpCommandDs);
 }
 
 
 void Scenario::Update(const double delta_seconds)
 {
-	UNUSED(delta_seconds);
+	CheckForScenarioChanges(delta_seconds);
+
+	// only the cards on screen need their images
+	m_currentLocation->UpdateCardImage();
+	if (m_currentInterest != nullptr)
+	{
+		m_currentInterest->UpdateCardImage();
+	}
 
 	m_imguiError = ImGui::Begin(
 		"Game State",
@@ -791,136 +1090,542 @@ void Scenario::LoadInScenarioManually()
 	SetupItemLookupTable();
 
 	ManuallySetScenarioSettings();
+
+	LinkScenario();
+}
+
+
+STATIC const char* Scenario::GetScenarioFileName(const ScenarioFile file)
+{
+	return s_scenarioFileNames[file];
 }
 
 
 void Scenario::LoadInScenarioFile(const char* folder_dir)
 {
-	const String location_file = String(folder_dir) + "/Locations.xml";
-	ReadLocationsXml(location_file);
+	const uint source_hash = HashScenarioFolder(folder_dir);
+	if (LoadInScenarioCache(folder_dir, source_hash))
+	{
+		return;
+	}
+
+	tinyxml2::XMLDocument docs[NUM_SCENARIO_FILES];
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		OpenXmlFile(&docs[file_idx], String(folder_dir) + "/" + s_scenarioFileNames[file_idx]);
+	}
+
+	ReadLocationsXml(docs[SCENARIO_FILE_LOCATIONS].RootElement());
 	SetupLocationLookupTable();
 
-	const String characters_file = String(folder_dir) + "/Characters.xml";
-	ReadCharactersXml(characters_file);
+	ReadCharactersXml(docs[SCENARIO_FILE_CHARACTERS].RootElement());
 	SetupCharacterLookupTable();
 
-	const String item_file = String(folder_dir) + "/Items.xml";
-	ReadItemsXml(item_file);
+	ReadItemsXml(docs[SCENARIO_FILE_ITEMS].RootElement());
 	SetupItemLookupTable();
 
-	const String settings_file = String(folder_dir) + "/Settings.xml";
-	ReadSettingsXml(settings_file);
-	
-	const String incidents_file = String(folder_dir) + "/Incidents.xml";
-	ReadIncidentsXml(incidents_file);
-	SetupIncidentLookupTable();
-
-	const String victory_conditions_file = String(folder_dir) + "/VictoryConditions.xml";
-	ReadVictoryConditionsXml(victory_conditions_file);
-}
+	ReadSettingsXml(docs[SCENARIO_FILE_SETTINGS].RootElement());
 
+	ReadIncidentsXml(docs[SCENARIO_FILE_INCIDENTS].RootElement());
+	SetupIncidentLookupTable();
 
+	ReadVictoryConditionsXml(docs[SCENARIO_FILE_VICTORY_CONDITIONS].RootElement());
 
-bool Scenario::IsLocationInLookupTable(LookupItr& out, const String& name)
-{
-	const String name_to_lower = StringToLower(name);
-	out = m_locationLookup.find(name_to_lower);
+	LinkScenario();
 
-	if (out != m_locationLookup.end())
+	WatchScenarioFolder(folder_dir);
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
 	{
-		return true;
+		RecordElementHashes(static_cast<ScenarioFile>(file_idx), docs[file_idx].RootElement());
 	}
 
-	return false;
+	SaveScenarioCache(folder_dir, source_hash);
 }
 
 
-bool Scenario::IsCharacterInLookupTable(LookupItr& out, const String& name)
+// Parses all the xml files on worker threads at once, then builds the entities in stages on the main thread.
+// Entity construction stays on the main thread because it creates textures through the renderer.
+//	stage 1: locations, items				no dependencies
+//	stage 2: characters, settings			need the location lookup for StartLoc and the starting location
+//	stage 3: incidents, victory conditions	need the starting time from the settings
+void Scenario::LoadInScenarioFileParallel(const char* folder_dir)
 {
-	const String name_to_lower = StringToLower(name);
-	out = m_characterLookup.find(name_to_lower);
+	const double load_start = GetCurrentTimeSeconds();
 
-	if (out != m_characterLookup.end())
+	const uint source_hash = HashScenarioFolder(folder_dir);
+	if (LoadInScenarioCache(folder_dir, source_hash))
 	{
-		return true;
+		PrintLoadStageTime("restored from cache", load_start);
+		return;
 	}
+	PrintLoadStageTime("hash xml", load_start);
 
-	return false;
-}
-
+	String file_paths[NUM_SCENARIO_FILES];
+	tinyxml2::XMLDocument docs[NUM_SCENARIO_FILES];
+	std::future<void> parse_jobs[NUM_SCENARIO_FILES];
 
-bool Scenario::IsItemInLookupTable(LookupItr& out, const String& name)
-{
-	const String name_to_lower = StringToLower(name);
-	out = m_itemLookup.find(name_to_lower);
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		file_paths[file_idx] = String(folder_dir) + "/" + s_scenarioFileNames[file_idx];
+		parse_jobs[file_idx] = std::async(std::launch::async, LoadXmlFile, &docs[file_idx], file_paths[file_idx]);
+	}
 
-	if (out != m_itemLookup.end())
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
 	{
-		return true;
+		parse_jobs[file_idx].get();
+		ValidateXmlFile(&docs[file_idx], file_paths[file_idx]);
 	}
+	PrintLoadStageTime("parse xml", load_start);
 
-	return false;
-}
+	double stage_start = GetCurrentTimeSeconds();
+	ReadLocationsXml(docs[SCENARIO_FILE_LOCATIONS].RootElement());
+	SetupLocationLookupTable();
+	ReadItemsXml(docs[SCENARIO_FILE_ITEMS].RootElement());
+	SetupItemLookupTable();
+	PrintLoadStageTime("locations, items", stage_start);
 
+	stage_start = GetCurrentTimeSeconds();
+	ReadCharactersXml(docs[SCENARIO_FILE_CHARACTERS].RootElement());
+	SetupCharacterLookupTable();
+	ReadSettingsXml(docs[SCENARIO_FILE_SETTINGS].RootElement());
+	PrintLoadStageTime("characters, settings", stage_start);
 
-bool Scenario::IsIncidentInLookupTable(LookupItr& out, const String& name)
-{
-	const String name_to_lower = StringToLower(name);
-	out = m_incidentLookup.find(name_to_lower);
+	stage_start = GetCurrentTimeSeconds();
+	ReadIncidentsXml(docs[SCENARIO_FILE_INCIDENTS].RootElement());
+	SetupIncidentLookupTable();
+	ReadVictoryConditionsXml(docs[SCENARIO_FILE_VICTORY_CONDITIONS].RootElement());
+	PrintLoadStageTime("incidents, victory conditions", stage_start);
 
-	if (out != m_incidentLookup.end())
+	stage_start = GetCurrentTimeSeconds();
+	LinkScenario();
+	PrintLoadStageTime("link", stage_start);
+
+	WatchScenarioFolder(folder_dir);
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
 	{
-		return true;
+		RecordElementHashes(static_cast<ScenarioFile>(file_idx), docs[file_idx].RootElement());
 	}
 
-	return false;
+	stage_start = GetCurrentTimeSeconds();
+	SaveScenarioCache(folder_dir, source_hash);
+	PrintLoadStageTime("write cache", stage_start);
+
+	PrintLoadStageTime("total", load_start);
 }
 
 
-bool Scenario::IsCardInLookupTable(LookupItr& out_itr, CardType& out_type, const String& name)
+bool Scenario::LoadInScenarioImage(const char* image_path)
 {
-	const String name_to_lower = StringToLower(name);
-	
-	out_itr = m_locationLookup.find(name_to_lower);
-	if (out_itr != m_locationLookup.end())
+	ScenarioImageReader reader;
+	if (!reader.OpenFile(image_path))
 	{
-		out_type = CARD_LOCATION;
-		return true;
-	}
-	
-	out_itr = m_characterLookup.find(name_to_lower);
-	if (out_itr != m_characterLookup.end())
-	{
-		out_type = CARD_CHARACTER;
-		return true;
+		return false;
 	}
 
-	out_itr = m_itemLookup.find(name_to_lower);
-	if (out_itr != m_itemLookup.end())
+	ReadScenarioFromImage(reader);
+	ASSERT_OR_DIE(reader.IsValid(), Stringf("Scenario image %s ended before all the records were read", image_path));
+
+	LinkScenario();
+
+	// keep watching the xml the image was compiled from, the first edit rebuilds everything since there are no element hashes
+	const String image_path_string(image_path);
+	const size_t folder_end = image_path_string.find_last_of("/\\");
+	if (folder_end != String::npos)
 	{
-		out_type = CARD_ITEM;
-		return true;
+		WatchScenarioFolder(image_path_string.substr(0, folder_end).c_str());
 	}
 
-	return false;
+	return true;
 }
 
 
-Location* Scenario::GetLocationFromList(const int idx)
+// Rebuilds only what changed in the scenario folder and keeps the live game state.
+// When every entity file still has the same entities in the same order, the edited entities are rebuilt in place so
+// every pointer into the lists stays valid. Adding, removing or reordering entities rebuilds the whole scenario and
+// restores the state by name.
+void Scenario::ReloadScenarioFiles(const bool force_all)
 {
-	return &(m_locations[idx]);
-}
+	if (m_folderDir.empty())
+	{
+		g_theDevConsole->PrintString(Rgba::RED, "Scenario was not loaded from a folder, nothing to reload");
+		return;
+	}
 
+	const double reload_start = GetCurrentTimeSeconds();
 
-Character* Scenario::GetCharacterFromList(const int idx)
-{
-	return &(m_characters[idx]);
-}
+	String file_paths[NUM_SCENARIO_FILES];
+	std::filesystem::file_time_type write_times[NUM_SCENARIO_FILES];
+	bool changed_files[NUM_SCENARIO_FILES];
+	bool any_changed = false;
 
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		file_paths[file_idx] = m_folderDir + "/" + s_scenarioFileNames[file_idx];
 
-Item* Scenario::GetItemFromList(const int idx)
-{
-	return &(m_items[idx]);
+		write_times[file_idx] = GetFileWriteTime(file_paths[file_idx]);
+		changed_files[file_idx] = force_all || write_times[file_idx] != m_fileWriteTimes[file_idx];
+		any_changed = any_changed || changed_files[file_idx];
+	}
+
+	if (!any_changed)
+	{
+		return;
+	}
+
+	// a file can be caught half written, keep the current scenario until it parses, the write times stay as they
+	// were so the next check tries it again
+	tinyxml2::XMLDocument docs[NUM_SCENARIO_FILES];
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		if (!changed_files[file_idx])
+		{
+			continue;
+		}
+
+		LoadXmlFile(&docs[file_idx], file_paths[file_idx]);
+		if (docs[file_idx].ErrorID() != tinyxml2::XML_SUCCESS || docs[file_idx].RootElement() == nullptr)
+		{
+			g_theDevConsole->PrintString(Rgba::RED, Stringf("Hot reload skipped, %s line %i: %s", file_paths[file_idx].c_str(),
+				docs[file_idx].ErrorLineNum(), docs[file_idx].ErrorName()));
+			return;
+		}
+	}
+
+	// any entity added, removed, renamed or moved needs the whole scenario rebuilt
+	const ScenarioFile entity_files[] = { SCENARIO_FILE_LOCATIONS, SCENARIO_FILE_CHARACTERS, SCENARIO_FILE_ITEMS, SCENARIO_FILE_INCIDENTS };
+	bool same_layout = true;
+
+	for (const ScenarioFile file : entity_files)
+	{
+		if (!changed_files[file])
+		{
+			continue;
+		}
+
+		const std::vector<ScenarioElementHash>& old_hashes = m_elementHashes[file];
+		const XmlElement* root = docs[file].RootElement();
+		size_t element_idx = 0;
+
+		for (const XmlElement* child = root->FirstChildElement();
+			child && same_layout;
+			child = child->NextSiblingElement())
+		{
+			same_layout = element_idx < old_hashes.size() && old_hashes[element_idx].m_name == GetElementName(child);
+			element_idx++;
+		}
+
+		same_layout = same_layout && element_idx == old_hashes.size();
+	}
+
+	// the load records the write times of the files it read
+	if (!same_layout)
+	{
+		RebuildScenarioKeepingState();
+		g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Rebuilt scenario %s in %.3f ms",
+			m_name.c_str(), (GetCurrentTimeSeconds() - reload_start) * 1000.0));
+		return;
+	}
+
+	// locations first, characters find their start location by name when they are rebuilt
+	int num_rebuilt = 0;
+	for (const ScenarioFile file : entity_files)
+	{
+		if (changed_files[file])
+		{
+			ReloadChangedElements(file, docs[file].RootElement(), num_rebuilt);
+		}
+	}
+
+	if (changed_files[SCENARIO_FILE_SETTINGS])
+	{
+		ReloadSettingsKeepingState(docs[SCENARIO_FILE_SETTINGS].RootElement());
+		RecordElementHashes(SCENARIO_FILE_SETTINGS, docs[SCENARIO_FILE_SETTINGS].RootElement());
+	}
+
+	if (changed_files[SCENARIO_FILE_VICTORY_CONDITIONS])
+	{
+		m_victoryConditions.clear();
+		ReadVictoryConditionsXml(docs[SCENARIO_FILE_VICTORY_CONDITIONS].RootElement());
+		RecordElementHashes(SCENARIO_FILE_VICTORY_CONDITIONS, docs[SCENARIO_FILE_VICTORY_CONDITIONS].RootElement());
+	}
+
+	// the rebuilt entities come back with fresh actions and conditions
+	LinkScenario();
+
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		m_fileWriteTimes[file_idx] = write_times[file_idx];
+	}
+
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Hot reloaded %i entities in %.3f ms",
+		num_rebuilt, (GetCurrentTimeSeconds() - reload_start) * 1000.0));
+}
+
+
+bool Scenario::SaveScenarioImage(const char* image_path) const
+{
+	ScenarioImageWriter writer;
+	WriteScenarioToImage(writer);
+
+	return writer.SaveToFile(image_path);
+}
+
+
+// Entity records in load order, shared by compiled images and the scenario cache
+void Scenario::ReadScenarioFromImage(ScenarioImageReader& reader)
+{
+	// locations first so characters and items can be placed in their starting location
+	const uint num_locations = reader.ReadU32();
+	m_locations.reserve(num_locations);
+	for (uint loc_idx = 0; loc_idx < num_locations; ++loc_idx)
+	{
+		m_locations.emplace_back(this, reader);
+	}
+	SetupLocationLookupTable();
+
+	const uint num_characters = reader.ReadU32();
+	m_characters.reserve(num_characters);
+	for (uint char_idx = 0; char_idx < num_characters; ++char_idx)
+	{
+		m_characters.emplace_back(this, reader);
+		m_characters.back().PlaceInStartLocation(static_cast<int>(char_idx));
+	}
+	SetupCharacterLookupTable();
+
+	const uint num_items = reader.ReadU32();
+	m_items.reserve(num_items);
+	for (uint item_idx = 0; item_idx < num_items; ++item_idx)
+	{
+		m_items.emplace_back(this, reader);
+	}
+	SetupItemLookupTable();
+
+	ReadSettingsFromImage(reader);
+
+	const uint num_incidents = reader.ReadU32();
+	m_incidents.reserve(num_incidents);
+	for (uint inc_idx = 0; inc_idx < num_incidents; ++inc_idx)
+	{
+		m_incidents.emplace_back(this, reader);
+	}
+	SetupIncidentLookupTable();
+
+	const uint num_conditions = reader.ReadU32();
+	m_victoryConditions.reserve(num_conditions);
+	for (uint cond_idx = 0; cond_idx < num_conditions; ++cond_idx)
+	{
+		m_victoryConditions.emplace_back(this, reader);
+	}
+}
+
+
+void Scenario::WriteScenarioToImage(ScenarioImageWriter& writer) const
+{
+	const uint num_locations = static_cast<uint>(m_locations.size());
+	writer.WriteU32(num_locations);
+	for (uint loc_idx = 0; loc_idx < num_locations; ++loc_idx)
+	{
+		m_locations[loc_idx].WriteToImage(writer);
+	}
+
+	const uint num_characters = static_cast<uint>(m_characters.size());
+	writer.WriteU32(num_characters);
+	for (uint char_idx = 0; char_idx < num_characters; ++char_idx)
+	{
+		m_characters[char_idx].WriteToImage(writer);
+	}
+
+	const uint num_items = static_cast<uint>(m_items.size());
+	writer.WriteU32(num_items);
+	for (uint item_idx = 0; item_idx < num_items; ++item_idx)
+	{
+		m_items[item_idx].WriteToImage(writer);
+	}
+
+	WriteSettingsToImage(writer);
+
+	const uint num_incidents = static_cast<uint>(m_incidents.size());
+	writer.WriteU32(num_incidents);
+	for (uint inc_idx = 0; inc_idx < num_incidents; ++inc_idx)
+	{
+		m_incidents[inc_idx].WriteToImage(writer);
+	}
+
+	const uint num_conditions = static_cast<uint>(m_victoryConditions.size());
+	writer.WriteU32(num_conditions);
+	for (uint cond_idx = 0; cond_idx < num_conditions; ++cond_idx)
+	{
+		m_victoryConditions[cond_idx].WriteToImage(writer);
+	}
+}
+
+
+// The cache is a scenario image followed by the element hashes hot reload compares against
+bool Scenario::LoadInScenarioCache(const char* folder_dir, const uint source_hash)
+{
+	const String cache_path = String(folder_dir) + "/" + SCENARIO_CACHE_FILE_NAME;
+
+	uint32_t cached_hash = 0;
+	if (source_hash == 0 || !ScenarioImageReader::ReadSourceHash(cache_path, cached_hash) || cached_hash != source_hash)
+	{
+		return false;
+	}
+
+	ScenarioImageReader reader;
+	if (!reader.OpenFile(cache_path))
+	{
+		return false;
+	}
+
+	ReadScenarioFromImage(reader);
+
+	WatchScenarioFolder(folder_dir);
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		std::vector<ScenarioElementHash>& hashes = m_elementHashes[file_idx];
+		hashes.resize(reader.ReadU32());
+
+		for (ScenarioElementHash& element_hash : hashes)
+		{
+			element_hash.m_name = reader.ReadString();
+			element_hash.m_hash = reader.ReadU32();
+		}
+	}
+
+	ASSERT_OR_DIE(reader.IsValid(), Stringf("Scenario cache %s ended before all the records were read", cache_path.c_str()));
+
+	LinkScenario();
+	return true;
+}
+
+
+void Scenario::SaveScenarioCache(const char* folder_dir, const uint source_hash) const
+{
+	if (source_hash == 0)
+	{
+		return;
+	}
+
+	ScenarioImageWriter writer;
+	WriteScenarioToImage(writer);
+
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		const std::vector<ScenarioElementHash>& hashes = m_elementHashes[file_idx];
+		writer.WriteU32(static_cast<uint32_t>(hashes.size()));
+
+		for (const ScenarioElementHash& element_hash : hashes)
+		{
+			writer.WriteString(element_hash.m_name);
+			writer.WriteU32(element_hash.m_hash);
+		}
+	}
+
+	// a read only folder still plays, it just parses the xml again next time
+	const String cache_path = String(folder_dir) + "/" + SCENARIO_CACHE_FILE_NAME;
+	if (!writer.SaveToFile(cache_path, source_hash))
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("Could not write the scenario cache %s", cache_path.c_str()));
+	}
+}
+
+
+
+bool Scenario::IsLocationInLookupTable(int& out_idx, const std::string_view name) const
+{
+	out_idx = m_cardIndex.Find(CARD_INDEX_LOCATION, name);
+	return out_idx >= 0;
+}
+
+
+bool Scenario::IsCharacterInLookupTable(int& out_idx, const std::string_view name) const
+{
+	out_idx = m_cardIndex.Find(CARD_INDEX_CHARACTER, name);
+	return out_idx >= 0;
+}
+
+
+bool Scenario::IsItemInLookupTable(int& out_idx, const std::string_view name) const
+{
+	out_idx = m_cardIndex.Find(CARD_INDEX_ITEM, name);
+	return out_idx >= 0;
+}
+
+
+bool Scenario::IsIncidentInLookupTable(int& out_idx, const std::string_view name) const
+{
+	out_idx = m_cardIndex.Find(CARD_INDEX_INCIDENT, name);
+	return out_idx >= 0;
+}
+
+
+bool Scenario::IsCardInLookupTable(int& out_idx, CardType& out_type, const std::string_view name) const
+{
+	return m_cardIndex.FindCard(name, out_type, out_idx);
+}
+
+
+// Misspelled names resolve to the closest name of the kinds asked for, see FuzzyNameIndex for how close is close enough
+bool Scenario::IsCardNearLookupTable(int& out_idx, CardIndexKind& out_kind, const uint kind_mask, const std::string_view name) const
+{
+	return m_fuzzyIndex.FindNearest(kind_mask, name, out_kind, out_idx);
+}
+
+
+void Scenario::FindNameMentions(const std::string_view text, std::vector<NameMention>& out_mentions) const
+{
+	m_nameMatcher.FindMentions(text, out_mentions);
+}
+
+
+// Every name and nickname in the order of the lists, the same entries the card index is built from
+void Scenario::GetCardNames(std::vector<CardIndexName>& out_names) const
+{
+	const auto add_card_names = [&out_names](const CardIndexKind kind, const Card& card, const int list_idx)
+	{
+		out_names.push_back({ kind, card.GetName(), list_idx });
+
+		const StringList& nicknames = card.GetListOfNicknames();
+		for (const String& nickname : nicknames)
+		{
+			out_names.push_back({ kind, nickname, list_idx });
+		}
+	};
+
+	for (int loc_idx = 0; loc_idx < static_cast<int>(m_locations.size()); ++loc_idx)
+	{
+		add_card_names(CARD_INDEX_LOCATION, m_locations[loc_idx], loc_idx);
+	}
+	for (int char_idx = 0; char_idx < static_cast<int>(m_characters.size()); ++char_idx)
+	{
+		add_card_names(CARD_INDEX_CHARACTER, m_characters[char_idx], char_idx);
+	}
+	for (int item_idx = 0; item_idx < static_cast<int>(m_items.size()); ++item_idx)
+	{
+		add_card_names(CARD_INDEX_ITEM, m_items[item_idx], item_idx);
+	}
+	for (int inc_idx = 0; inc_idx < static_cast<int>(m_incidents.size()); ++inc_idx)
+	{
+		out_names.push_back({ CARD_INDEX_INCIDENT, m_incidents[inc_idx].GetName(), inc_idx });
+	}
+}
+
+
+Location* Scenario::GetLocationFromList(const int idx)
+{
+	return &(m_locations[idx]);
+}
+
+
+Character* Scenario::GetCharacterFromList(const int idx)
+{
+	return &(m_characters[idx]);
+}
+
+
+Item* Scenario::GetItemFromList(const int idx)
+{
+	return &(m_items[idx]);
 }
 
 
@@ -930,6 +1635,190 @@ Incident* Scenario::GetIncidentFromList(const int idx)
 }
 
 
+int Scenario::GetLocationListIdx(const Location* loc) const
+{
+	const int loc_idx = static_cast<int>(loc - m_locations.data());
+	ASSERT_OR_DIE(loc_idx >= 0 && loc_idx < static_cast<int>(m_locations.capacity()), "Location is not in the scenario's list");
+	return loc_idx;
+}
+
+
+int Scenario::GetCharacterListIdx(const Character* character) const
+{
+	const int char_idx = static_cast<int>(character - m_characters.data());
+	ASSERT_OR_DIE(char_idx >= 0 && char_idx < static_cast<int>(m_characters.size()), "Character is not in the scenario's list");
+	return char_idx;
+}
+
+
+int Scenario::GetItemListIdx(const Item* item) const
+{
+	const int item_idx = static_cast<int>(item - m_items.data());
+	ASSERT_OR_DIE(item_idx >= 0 && item_idx < static_cast<int>(m_items.capacity()), "Item is not in the scenario's list");
+	return item_idx;
+}
+
+
+int Scenario::GetIncidentListIdx(const Incident* incident) const
+{
+	const int inc_idx = static_cast<int>(incident - m_incidents.data());
+	ASSERT_OR_DIE(inc_idx >= 0 && inc_idx < static_cast<int>(m_incidents.capacity()), "Incident is not in the scenario's list");
+	return inc_idx;
+}
+
+
+Location* Scenario::GetCharacterLocation(const int char_idx)
+{
+	if (char_idx < 0 || char_idx >= static_cast<int>(m_characterLocations.size()) || m_characterLocations[char_idx] < 0)
+	{
+		return nullptr;
+	}
+
+	return &m_locations[m_characterLocations[char_idx]];
+}
+
+
+void Scenario::SetCharacterLocation(const int char_idx, const int loc_idx)
+{
+	if (char_idx >= static_cast<int>(m_characterLocations.size()))
+	{
+		m_characterLocations.resize(char_idx + 1, -1);
+	}
+
+	m_characterLocations[char_idx] = loc_idx;
+}
+
+
+SymbolTable& Scenario::GetSymbolTable()
+{
+	return m_symbols;
+}
+
+
+ScenarioArena& Scenario::GetArena()
+{
+	return m_arena;
+}
+
+
+IncidentProgram& Scenario::GetIncidentProgram()
+{
+	return m_incidentProgram;
+}
+
+
+SymbolId Scenario::InternName(const String& name)
+{
+	return m_symbols.Intern(name);
+}
+
+
+const String& Scenario::GetSymbolName(const SymbolId id) const
+{
+	return m_symbols.GetString(id);
+}
+
+
+int Scenario::LinkCardReference(const CardType type, const SymbolId name_id, const String& referrer, StringList& out_errors)
+{
+	const String& name = GetSymbolName(name_id);
+	int card_idx = -1;
+	bool in_scenario = false;
+
+	switch (type)
+	{
+	case CARD_LOCATION:
+	{
+		in_scenario = IsLocationInLookupTable(card_idx, name);
+		break;
+	}
+	case CARD_CHARACTER:
+	{
+		in_scenario = IsCharacterInLookupTable(card_idx, name);
+		break;
+	}
+	case CARD_ITEM:
+	{
+		in_scenario = IsItemInLookupTable(card_idx, name);
+		break;
+	}
+	default:
+	{
+		out_errors.push_back(Stringf("%s: the card type for '%s' was not set", referrer.c_str(), name.c_str()));
+		return -1;
+	}
+	}
+
+	if (!in_scenario)
+	{
+		out_errors.push_back(Stringf("%s: there is no %s named '%s'", referrer.c_str(), s_cardTypeNames[type], name.c_str()));
+		return -1;
+	}
+
+	return card_idx;
+}
+
+
+int Scenario::LinkStateReference(const CardType type, const int card_idx, const SymbolId state_id, const String& referrer, StringList& out_errors)
+{
+	// the card itself has already been reported
+	if (card_idx < 0 || state_id == SYMBOL_WILDCARD)
+	{
+		return -1;
+	}
+
+	const Card* card = nullptr;
+	int state_idx = -1;
+
+	switch (type)
+	{
+	case CARD_LOCATION:
+	{
+		card = &m_locations[card_idx];
+		state_idx = m_locations[card_idx].FindStateIdx(state_id);
+		break;
+	}
+	case CARD_CHARACTER:
+	{
+		card = &m_characters[card_idx];
+		state_idx = m_characters[card_idx].FindStateIdx(state_id);
+		break;
+	}
+	case CARD_ITEM:
+	{
+		card = &m_items[card_idx];
+		state_idx = m_items[card_idx].FindStateIdx(state_id);
+		break;
+	}
+	default:
+	{
+		return -1;
+	}
+	}
+
+	if (state_idx < 0)
+	{
+		out_errors.push_back(Stringf("%s: the %s '%s' has no state '%s'", referrer.c_str(), s_cardTypeNames[type],
+			card->GetName().c_str(), GetSymbolName(state_id).c_str()));
+	}
+
+	return state_idx;
+}
+
+
+int Scenario::LinkIncidentReference(const String& incident_name, const String& referrer, StringList& out_errors)
+{
+	int inc_idx = -1;
+	if (!IsIncidentInLookupTable(inc_idx, incident_name))
+	{
+		out_errors.push_back(Stringf("%s: there is no incident named '%s'", referrer.c_str(), incident_name.c_str()));
+		return -1;
+	}
+
+	return inc_idx;
+}
+
+
 String& Scenario::GetUnknownLocation()
 {
 	const int random_dialog_idx = g_randomNumberGenerator.GetRandomIntInRange(0, 2);
@@ -979,7 +1868,7 @@ StringList Scenario::GetListOfKnownLocations()
 	const uint num_locs = static_cast<uint>(m_locations.size());
 	for(uint loc_idx = 0; loc_idx < num_locs; ++loc_idx)
 	{
-		if(!m_locations[loc_idx].GetLocationState().m_canMoveHere)
+		if(!IsLocationKnown(m_locations[loc_idx]))
 		{
 			continue;
 		}
@@ -995,11 +1884,12 @@ StringList Scenario::GetListOfKnownLocations()
 StringList Scenario::GetListOfKnownItems()
 {
 	StringList list_of_items;
+	const SymbolId found_state = m_symbols.Find("found");
 
 	const uint num_items = static_cast<uint>(m_items.size());
 	for (uint item_idx = 0; item_idx < num_items; ++item_idx)
 	{
-		if (m_items[item_idx].GetItemState().m_name != "found")
+		if (!IsItemKnown(m_items[item_idx], found_state))
 		{
 			continue;
 		}
@@ -1016,11 +1906,12 @@ StringList Scenario::GetListOfKnownItems()
 StringList Scenario::GetListOfKnownCharacters()
 {
 	StringList list_of_characters;
+	const SymbolId not_found_state = m_symbols.Find("not found");
 
 	const uint num_chars = static_cast<uint>(m_characters.size());
 	for (uint char_idx = 0; char_idx < num_chars; ++char_idx)
 	{
-		if (m_characters[char_idx].GetCharacterState().m_name == "not found")
+		if (!IsCharacterKnown(m_characters[char_idx], not_found_state))
 		{
 			continue;
 		}
@@ -1030,7 +1921,70 @@ StringList Scenario::GetListOfKnownCharacters()
 		list_of_characters.push_back(line);
 	}
 
-	return list_of_characters;
+	return list_of_characters;
+}
+
+
+void Scenario::GetKnownCardNames(const CardType type, StringList& out_names) const
+{
+	const auto add_card_names = [&out_names](const Card& card)
+	{
+		out_names.push_back(card.GetName());
+
+		const StringList& nicknames = card.GetListOfNicknames();
+		out_names.insert(out_names.end(), nicknames.begin(), nicknames.end());
+	};
+
+	switch (type)
+	{
+	case CARD_LOCATION:
+	{
+		for (const Location& loc : m_locations)
+		{
+			if (IsLocationKnown(loc))
+			{
+				add_card_names(loc);
+			}
+		}
+		break;
+	}
+	case CARD_CHARACTER:
+	{
+		const SymbolId not_found_state = m_symbols.Find("not found");
+		for (const Character& character : m_characters)
+		{
+			if (IsCharacterKnown(character, not_found_state))
+			{
+				add_card_names(character);
+			}
+		}
+		break;
+	}
+	case CARD_ITEM:
+	{
+		const SymbolId found_state = m_symbols.Find("found");
+		for (const Item& item : m_items)
+		{
+			if (IsItemKnown(item, found_state))
+			{
+				add_card_names(item);
+			}
+		}
+		break;
+	}
+	}
+}
+
+
+uint Scenario::GetNumLinks() const
+{
+	return m_numLinks;
+}
+
+
+const String& Scenario::GetName() const
+{
+	return m_name;
 }
 
 
@@ -1048,12 +2002,22 @@ Card* Scenario::GetCurrentInterest()
 
 void Scenario::SetLocation(Location* loc)
 {
+	if (loc != m_currentLocation)
+	{
+		m_incidentProgram.UpdatePlayerLocation(loc != nullptr ? GetLocationListIdx(loc) : -1);
+	}
+
 	m_currentLocation = loc;
 }
 
 
 void Scenario::SetInterest(Card* card)
 {
+	if (card != m_currentInterest)
+	{
+		m_incidentProgram.MarkInterestChanged();
+	}
+
 	m_currentInterest = card;
 }
 
@@ -1085,6 +2049,8 @@ void Scenario::AddGameTime(const uint mins, const uint hours)
 		m_gameTime.m_hour -= 24;
 		m_gameTime.m_day += 1;
 	}
+
+	m_incidentProgram.AdvanceTime(GetGameTimeInMinutes(m_gameTime));
 }
 
 
@@ -1120,12 +2086,33 @@ uint Scenario::GetWastingTime() const
 
 void Scenario::TestIncidents()
 {
-	const uint num_incidents = static_cast<uint>(m_incidents.size());
+	m_incidentProgram.RunDirty(*this, true);
+}
+
+
+void Scenario::OnCardStateChanged(const CardType type, const int card_idx)
+{
+	if (card_idx < 0)
+	{
+		return;
+	}
 
-	for(uint inc_idx = 0; inc_idx < num_incidents; ++inc_idx)
+	SymbolId state_id = INVALID_SYMBOL;
+	switch (type)
 	{
-		m_incidents[inc_idx].TestTriggers();
+		case CARD_LOCATION:		state_id = m_locations[card_idx].GetLocationState().m_nameId;			break;
+		case CARD_CHARACTER:	state_id = m_characters[card_idx].GetCharacterState().m_nameId;		break;
+		case CARD_ITEM:			state_id = m_items[card_idx].GetItemState().m_nameId;					break;
+		default:				return;
 	}
+
+	m_incidentProgram.UpdateCardState(type, card_idx, state_id);
+}
+
+
+void Scenario::OnIncidentChanged(const Incident* incident)
+{
+	m_incidentProgram.MarkIncidentChanged(GetIncidentListIdx(incident), GetGameTimeInMinutes(incident->GetActivatedTime()));
 }
 
 
@@ -1170,11 +2157,11 @@ void Scenario::ManuallySetScenarioSettings()
 
 	//AddGameTime(68, 50);
 
-	LookupItr loc_itr;
-	bool home = IsLocationInLookupTable(loc_itr, "Scotland Yard");
+	int loc_idx = -1;
+	bool home = IsLocationInLookupTable(loc_idx, "Scotland Yard");
 	if (home)
 	{
-		m_currentLocation = &m_locations[loc_itr->second];
+		m_currentLocation = &m_locations[loc_idx];
 	}
 
 	ASSERT_OR_DIE(home, "Need to have a valid starting position");
@@ -1220,6 +2207,8 @@ const IncidentList* Scenario::GetIncidentList() const
 
 void Scenario::ManuallySetLocations()
 {
+	m_locations.reserve(3);
+
 	// Home location 
 	StringList home_nicknames;
 	home_nicknames.emplace_back("Scotland Yard");
@@ -1246,8 +2235,12 @@ void Scenario::ManuallySetLocations()
 }
 
 
+// Reserved like the xml path. None of these start anywhere, the locations only get their presence bits when a
+// character is placed after it is in the list
 void Scenario::ManuallySetCharacters()
 {
+	m_characters.reserve(3);
+
 	StringList cally_nicknames;
 	cally_nicknames.emplace_back("Cally");
 	cally_nicknames.emplace_back("Rivera");
@@ -1270,6 +2263,8 @@ void Scenario::ManuallySetCharacters()
 
 void Scenario::ManuallySetItems()
 {
+	m_items.reserve(2);
+
 	// Items used in the game
 	StringList money_nicknames;
 	money_nicknames.emplace_back("cash");
@@ -1285,11 +2280,8 @@ void Scenario::ManuallySetItems()
 }
 
 
-void Scenario::ReadLocationsXml(const String& file_path)
+void Scenario::ReadLocationsXml(const XmlElement* root_loc)
 {
-	tinyxml2::XMLDocument loc_doc;
-	OpenXmlFile(&loc_doc, file_path);
-	XmlElement* root_loc = loc_doc.RootElement();
 	uint loc_count = 0;
 
 	for (const XmlElement* child = root_loc->FirstChildElement();
@@ -1300,7 +2292,6 @@ void Scenario::ReadLocationsXml(const String& file_path)
 	}
 
 	m_locations.reserve(loc_count);
-	root_loc = loc_doc.RootElement();
 
 	for (const XmlElement* loc_element = root_loc->FirstChildElement();
 		loc_element;
@@ -1313,11 +2304,8 @@ void Scenario::ReadLocationsXml(const String& file_path)
 }
 
 
-void Scenario::ReadCharactersXml(const String& file_path)
+void Scenario::ReadCharactersXml(const XmlElement* root_characters)
 {
-	tinyxml2::XMLDocument characters_doc;
-	OpenXmlFile(&characters_doc, file_path);
-	XmlElement* root_characters = characters_doc.RootElement();
 	uint char_count = 0;
 
 	for (const XmlElement* child = root_characters->FirstChildElement();
@@ -1335,15 +2323,13 @@ void Scenario::ReadCharactersXml(const String& file_path)
 		)
 	{
 		m_characters.emplace_back(this, character_element);
+		m_characters.back().PlaceInStartLocation(static_cast<int>(m_characters.size()) - 1);
 	}
 }
 
 
-void Scenario::ReadItemsXml(const String& file_path)
+void Scenario::ReadItemsXml(const XmlElement* root_items)
 {
-	tinyxml2::XMLDocument items_doc;
-	OpenXmlFile(&items_doc, file_path);
-	XmlElement* root_items = items_doc.RootElement();
 	uint item_count = 0;
 
 	for (const XmlElement* child = root_items->FirstChildElement();
@@ -1365,21 +2351,19 @@ void Scenario::ReadItemsXml(const String& file_path)
 }
 
 
-void Scenario::ReadSettingsXml(const String& file_path)
+void Scenario::ReadSettingsXml(const XmlElement* root_setup)
 {
-	tinyxml2::XMLDocument setup_doc;
-	OpenXmlFile(&setup_doc, file_path);
-	XmlElement* root_setup = setup_doc.RootElement();
 
 	ReadScenarioSettingsAttributes(root_setup);
 
 	// Get the children elements
+	String element_name;
 	for (const XmlElement* setup_element = root_setup->FirstChildElement();
 		setup_element;
 		setup_element = setup_element->NextSiblingElement()
 		)
 	{
-		String element_name = StringToLower(setup_element->Name());
+		FoldCase(setup_element->Name(), element_name);
 
 		if (element_name == "timecostforactions")
 		{
@@ -1394,11 +2378,8 @@ void Scenario::ReadSettingsXml(const String& file_path)
 }
 
 
-void Scenario::ReadIncidentsXml(const String& file_path)
+void Scenario::ReadIncidentsXml(const XmlElement* root_incidents)
 {
-	tinyxml2::XMLDocument incidents_doc;
-	OpenXmlFile(&incidents_doc, file_path);
-	XmlElement* root_incidents = incidents_doc.RootElement();
 	uint incident_count = 0;
 
 	for (const XmlElement* child = root_incidents->FirstChildElement();
@@ -1420,14 +2401,11 @@ void Scenario::ReadIncidentsXml(const String& file_path)
 }
 
 
-void Scenario::ReadVictoryConditionsXml(const String& file_path)
+void Scenario::ReadVictoryConditionsXml(const XmlElement* root_conditions)
 {
-	tinyxml2::XMLDocument incidents_doc;
-	OpenXmlFile(&incidents_doc, file_path);
-	XmlElement* root_incidents = incidents_doc.RootElement();
 	uint conditions_count = 0;
 
-	for (const XmlElement* child = root_incidents->FirstChildElement();
+	for (const XmlElement* child = root_conditions->FirstChildElement();
 		child;
 		child = child->NextSiblingElement())
 	{
@@ -1436,7 +2414,7 @@ void Scenario::ReadVictoryConditionsXml(const String& file_path)
 
 	m_victoryConditions.reserve(conditions_count);
 
-	for (const XmlElement* condition_element = root_incidents->FirstChildElement();
+	for (const XmlElement* condition_element = root_conditions->FirstChildElement();
 		condition_element;
 		condition_element = condition_element->NextSiblingElement()
 		)
@@ -1449,12 +2427,13 @@ void Scenario::ReadVictoryConditionsXml(const String& file_path)
 void Scenario::ReadScenarioSettingsAttributes(const XmlElement* element)
 {
 	// Get all the attributes from the ScenarioSettings element
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "name")
 		{
@@ -1478,13 +2457,13 @@ void Scenario::ReadScenarioSettingsAttributes(const XmlElement* element)
 		}
 		else if (attribute_name == "startinglocation")
 		{
-			LookupItr loc_itr;
+			int loc_idx = -1;
 			String starting_location_name = attribute->Value();
 
-			bool home = IsLocationInLookupTable(loc_itr, starting_location_name);
+			bool home = IsLocationInLookupTable(loc_idx, starting_location_name);
 			if (home)
 			{
-				m_currentLocation = &m_locations[loc_itr->second];
+				m_currentLocation = &m_locations[loc_idx];
 			}
 
 			ASSERT_OR_DIE(home, "Need to have a valid starting position");
@@ -1508,28 +2487,19 @@ void Scenario::ReadScenarioSettingsAttributes(const XmlElement* element)
 	}
 
 	//will need to change the unknown lines
-	m_unknownLocationLine.emplace_back("Where is that again?");
-	m_unknownLocationLine.emplace_back("...I think I'm lost...");
-	m_unknownLocationLine.emplace_back("What city are we in again?");
-
-	m_unknownCharacterLine.emplace_back("Sorry, give me a minute");
-	m_unknownCharacterLine.emplace_back("I'm at a lost for words");
-	m_unknownCharacterLine.emplace_back("............");
-
-	m_unknownItemLine.emplace_back("oh, where did I put it...");
-	m_unknownItemLine.emplace_back("I know it is here somewhere.");
-	m_unknownItemLine.emplace_back("what was I looking for again?");
+	SetDefaultUnknownLines();
 }
 
 
 void Scenario::ReadScenarioTimeCostForActions(const XmlElement* element)
 {
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "movetolocation")
 		{
@@ -1557,12 +2527,13 @@ void Scenario::ReadScenarioTimeCostForActions(const XmlElement* element)
 
 void Scenario::ReadScenarioDefaultEnding(const XmlElement* element)
 {
+	String attribute_name;
 	for (const XmlAttribute* attribute = element->FirstAttribute();
 		attribute;
 		attribute = attribute->Next()
 		)
 	{
-		String attribute_name = StringToLower(attribute->Name());
+		FoldCase(attribute->Name(), attribute_name);
 
 		if (attribute_name == "congratulations")
 		{
@@ -1585,6 +2556,455 @@ void Scenario::ReadScenarioDefaultEnding(const XmlElement* element)
 }
 
 
+// Binds every card, state and incident reference to its index so nothing is looked up by name while playing.
+// Everything that does not resolve is reported at once instead of one ERROR_RECOVERABLE at a time mid game.
+void Scenario::LinkScenario()
+{
+	m_numLinks++;
+
+	// the names only change again on a reload, which links again
+	if (!m_cardIndex.BuildPerfectHash())
+	{
+		g_theDevConsole->PrintString(Rgba::RED, Stringf("Scenario %s: no perfect hash for its %u names, lookups keep probing",
+			m_name.c_str(), m_cardIndex.GetNumNames()));
+	}
+
+	std::vector<CardIndexName> card_names;
+	GetCardNames(card_names);
+	m_fuzzyIndex.Build(card_names);
+	m_nameMatcher.Build(card_names);
+
+	StringList dangling_references;
+
+	for (Location& loc : m_locations)
+	{
+		loc.LinkReferences(dangling_references);
+	}
+
+	for (Character& character : m_characters)
+	{
+		character.LinkReferences(dangling_references);
+	}
+
+	for (Incident& incident : m_incidents)
+	{
+		incident.LinkReferences(dangling_references);
+	}
+	m_incidentProgram.Compile(*this);
+
+	const uint num_conditions = static_cast<uint>(m_victoryConditions.size());
+	for (uint cond_idx = 0; cond_idx < num_conditions; ++cond_idx)
+	{
+		m_victoryConditions[cond_idx].LinkReferences(Stringf("victory condition %u", cond_idx), dangling_references);
+	}
+
+	if (dangling_references.empty())
+	{
+		return;
+	}
+
+	const uint num_dangling = static_cast<uint>(dangling_references.size());
+	for (uint ref_idx = 0; ref_idx < num_dangling; ++ref_idx)
+	{
+		g_theDevConsole->PrintString(Rgba::RED, dangling_references[ref_idx]);
+	}
+
+	ERROR_RECOVERABLE(Stringf("Scenario %s has %u dangling references, they are listed in the dev console", m_name.c_str(), num_dangling));
+}
+
+
+bool Scenario::IsLocationKnown(const Location& loc) const
+{
+	return loc.GetLocationState().m_canMoveHere;
+}
+
+
+bool Scenario::IsCharacterKnown(const Character& character, const SymbolId not_found_state) const
+{
+	return character.GetCharacterState().m_nameId != not_found_state;
+}
+
+
+bool Scenario::IsItemKnown(const Item& item, const SymbolId found_state) const
+{
+	return item.GetItemState().m_nameId == found_state;
+}
+
+
+// Each arena block is one allocator call, compare with ShowMemAlloc for the rest of the game
+void Scenario::PrintArenaStats() const
+{
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Scenario arena: %u objects in %u blocks, %u of %u KiB used",
+		m_arena.GetNumObjects(), m_arena.GetNumBlocks(),
+		static_cast<uint>(m_arena.GetBytesUsed() / 1024), static_cast<uint>(m_arena.GetBytesReserved() / 1024)));
+
+	DevConPrintMemTrack();
+}
+
+
+void Scenario::SetDefaultUnknownLines()
+{
+	m_unknownLocationLine.emplace_back("Where is that again?");
+	m_unknownLocationLine.emplace_back("...I think I'm lost...");
+	m_unknownLocationLine.emplace_back("What city are we in again?");
+
+	m_unknownCharacterLine.emplace_back("Sorry, give me a minute");
+	m_unknownCharacterLine.emplace_back("I'm at a lost for words");
+	m_unknownCharacterLine.emplace_back("............");
+
+	m_unknownItemLine.emplace_back("oh, where did I put it...");
+	m_unknownItemLine.emplace_back("I know it is here somewhere.");
+	m_unknownItemLine.emplace_back("what was I looking for again?");
+}
+
+
+void Scenario::ReadSettingsFromImage(ScenarioImageReader& reader)
+{
+	m_name = reader.ReadString();
+	g_introMessage = reader.ReadString();
+	g_closedLocationMessage = reader.ReadString();
+	g_sameLocationMessage = reader.ReadString();
+	g_unknownCommandMessage = reader.ReadString();
+
+	int loc_idx = -1;
+	const String starting_location_name = reader.ReadString();
+	const bool home = IsLocationInLookupTable(loc_idx, starting_location_name);
+	if (home)
+	{
+		m_currentLocation = &m_locations[loc_idx];
+	}
+
+	ASSERT_OR_DIE(home, "Need to have a valid starting position");
+
+	m_gameTime = reader.ReadGameTime();
+
+	m_costToMoveToLocation = reader.ReadU32();
+	m_costToInvestigateLocation = reader.ReadU32();
+	m_costToExamineItem = reader.ReadU32();
+	m_costToInterrogateCharacter = reader.ReadU32();
+	m_costForUnknownCommand = reader.ReadU32();
+
+	m_congratulations = reader.ReadString();
+	m_solution = reader.ReadString();
+	m_continueInvestigation = reader.ReadString();
+
+	SetDefaultUnknownLines();
+}
+
+
+void Scenario::WriteSettingsToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(m_name);
+	writer.WriteString(g_introMessage);
+	writer.WriteString(g_closedLocationMessage);
+	writer.WriteString(g_sameLocationMessage);
+	writer.WriteString(g_unknownCommandMessage);
+	writer.WriteString(m_currentLocation->GetName());
+	writer.WriteGameTime(m_gameTime);
+
+	writer.WriteU32(m_costToMoveToLocation);
+	writer.WriteU32(m_costToInvestigateLocation);
+	writer.WriteU32(m_costToExamineItem);
+	writer.WriteU32(m_costToInterrogateCharacter);
+	writer.WriteU32(m_costForUnknownCommand);
+
+	writer.WriteString(m_congratulations);
+	writer.WriteString(m_solution);
+	writer.WriteString(m_continueInvestigation);
+}
+
+
+void Scenario::WatchScenarioFolder(const char* folder_dir)
+{
+	m_folderDir = folder_dir;
+	m_timeSinceFileCheck = 0.0;
+
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		m_fileWriteTimes[file_idx] = GetFileWriteTime(m_folderDir + "/" + s_scenarioFileNames[file_idx]);
+		m_elementHashes[file_idx].clear();
+	}
+}
+
+
+void Scenario::RecordElementHashes(const ScenarioFile file, const XmlElement* root)
+{
+	std::vector<ScenarioElementHash>& hashes = m_elementHashes[file];
+	hashes.clear();
+
+	for (const XmlElement* child = root->FirstChildElement();
+		child;
+		child = child->NextSiblingElement())
+	{
+		ScenarioElementHash element_hash;
+		element_hash.m_name = GetElementName(child);
+		element_hash.m_hash = HashElement(child);
+		hashes.push_back(element_hash);
+	}
+}
+
+
+void Scenario::CheckForScenarioChanges(const double delta_seconds)
+{
+	if (m_folderDir.empty())
+	{
+		return;
+	}
+
+	m_timeSinceFileCheck += delta_seconds;
+	if (m_timeSinceFileCheck < SCENARIO_FILE_CHECK_SECONDS)
+	{
+		return;
+	}
+
+	m_timeSinceFileCheck = 0.0;
+	ReloadScenarioFiles(false);
+}
+
+
+// The layout of the file matches what is loaded, so element n is entity n of the list
+void Scenario::ReloadChangedElements(const ScenarioFile file, const XmlElement* root, int& out_num_rebuilt)
+{
+	std::vector<ScenarioElementHash>& hashes = m_elementHashes[file];
+	int element_idx = 0;
+
+	for (const XmlElement* child = root->FirstChildElement();
+		child;
+		child = child->NextSiblingElement(), ++element_idx)
+	{
+		const uint new_hash = HashElement(child);
+		if (new_hash == hashes[element_idx].m_hash)
+		{
+			continue;
+		}
+
+		switch (file)
+		{
+		case SCENARIO_FILE_LOCATIONS:	m_locations[element_idx].ReloadFromXml(child);	break;
+		case SCENARIO_FILE_CHARACTERS:	m_characters[element_idx].ReloadFromXml(child);	break;
+		case SCENARIO_FILE_ITEMS:		m_items[element_idx].ReloadFromXml(child);		break;
+		case SCENARIO_FILE_INCIDENTS:	m_incidents[element_idx].ReloadFromXml(child);	break;
+		}
+
+		hashes[element_idx].m_hash = new_hash;
+		out_num_rebuilt++;
+	}
+
+	// nicknames may have changed
+	switch (file)
+	{
+	case SCENARIO_FILE_LOCATIONS:
+	{
+		m_cardIndex.ClearKind(CARD_INDEX_LOCATION);
+		SetupLocationLookupTable();
+		break;
+	}
+	case SCENARIO_FILE_CHARACTERS:
+	{
+		m_cardIndex.ClearKind(CARD_INDEX_CHARACTER);
+		SetupCharacterLookupTable();
+		break;
+	}
+	case SCENARIO_FILE_ITEMS:
+	{
+		m_cardIndex.ClearKind(CARD_INDEX_ITEM);
+		SetupItemLookupTable();
+		break;
+	}
+	}
+}
+
+
+void Scenario::ReloadSettingsKeepingState(const XmlElement* root_setup)
+{
+	const GameTime game_time = m_gameTime;
+	Location* current_location = m_currentLocation;
+
+	m_unknownLocationLine.clear();
+	m_unknownCharacterLine.clear();
+	m_unknownItemLine.clear();
+	ReadSettingsXml(root_setup);
+
+	m_gameTime = game_time;
+	m_currentLocation = current_location;
+}
+
+
+void Scenario::RebuildScenarioKeepingState()
+{
+	struct CardSnapshot
+	{
+		SymbolId	m_state = SYMBOL_EMPTY;
+		bool		m_found = false;
+		bool		m_investigating = false;
+	};
+
+	struct IncidentSnapshot
+	{
+		bool		m_enabled = false;
+		GameTime	m_timeAtActive;
+	};
+
+	std::map<String, CardSnapshot> card_snapshots[NUM_CARD_TYPES];
+	std::map<String, IncidentSnapshot> incident_snapshots;
+	String folded_name;
+
+	for (const Location& loc : m_locations)
+	{
+		FoldCase(loc.GetName(), folded_name);
+		CardSnapshot& snapshot = card_snapshots[CARD_LOCATION][folded_name];
+		snapshot.m_state = loc.GetLocationState().m_nameId;
+		snapshot.m_found = loc.IsDiscovered();
+		snapshot.m_investigating = loc.IsPlayerInvestigatingRoom();
+	}
+
+	for (const Character& character : m_characters)
+	{
+		FoldCase(character.GetName(), folded_name);
+		CardSnapshot& snapshot = card_snapshots[CARD_CHARACTER][folded_name];
+		snapshot.m_state = character.GetCharacterState().m_nameId;
+		snapshot.m_found = character.IsDiscovered();
+	}
+
+	for (const Item& item : m_items)
+	{
+		FoldCase(item.GetName(), folded_name);
+		CardSnapshot& snapshot = card_snapshots[CARD_ITEM][folded_name];
+		snapshot.m_state = item.GetItemState().m_nameId;
+		snapshot.m_found = item.IsDiscovered();
+	}
+
+	for (const Incident& incident : m_incidents)
+	{
+		FoldCase(incident.GetName(), folded_name);
+		IncidentSnapshot& snapshot = incident_snapshots[folded_name];
+		snapshot.m_enabled = incident.IsIncidentEnabled();
+		snapshot.m_timeAtActive = incident.GetActivatedTime();
+	}
+
+	const GameTime game_time = m_gameTime;
+	const String location_name = m_currentLocation != nullptr ? m_currentLocation->GetName() : "";
+	const CardType interest_type = m_currentInterest != nullptr ? m_currentInterest->GetCardType() : UNKNOWN_CARD_TYPE;
+	const String interest_name = m_currentInterest != nullptr ? m_currentInterest->GetName() : "";
+	const CardType subject_type = m_currentSubject != nullptr ? m_currentSubject->GetCardType() : UNKNOWN_CARD_TYPE;
+	const String subject_name = m_currentSubject != nullptr ? m_currentSubject->GetName() : "";
+
+	// throw the old scenario away
+	m_currentLocation = nullptr;
+	m_currentInterest = nullptr;
+	m_currentSubject = nullptr;
+	m_victoryConditions.clear();
+	m_incidents.clear();
+	m_items.clear();
+	m_characters.clear();
+	m_locations.clear();
+	m_characterLocations.clear();
+	m_cardIndex.Clear();
+	m_fuzzyIndex.Clear();
+	m_nameMatcher.Clear();
+	m_incidentProgram.Clear();
+	m_arena.Release();
+	m_unknownLocationLine.clear();
+	m_unknownCharacterLine.clear();
+	m_unknownItemLine.clear();
+
+	const String folder_dir = m_folderDir;
+	LoadInScenarioFile(folder_dir.c_str());
+
+	// put the live state back on everything that still exists
+	for (Location& loc : m_locations)
+	{
+		FoldCase(loc.GetName(), folded_name);
+		const std::map<String, CardSnapshot>::iterator snapshot = card_snapshots[CARD_LOCATION].find(folded_name);
+		if (snapshot != card_snapshots[CARD_LOCATION].end())
+		{
+			if (loc.HasState(snapshot->second.m_state))
+			{
+				loc.SetState(snapshot->second.m_state);
+			}
+			loc.SetDiscovery(snapshot->second.m_found);
+			loc.SetInvestigation(snapshot->second.m_investigating);
+		}
+	}
+
+	for (Character& character : m_characters)
+	{
+		FoldCase(character.GetName(), folded_name);
+		const std::map<String, CardSnapshot>::iterator snapshot = card_snapshots[CARD_CHARACTER].find(folded_name);
+		if (snapshot != card_snapshots[CARD_CHARACTER].end())
+		{
+			if (character.HasState(snapshot->second.m_state))
+			{
+				character.SetState(snapshot->second.m_state);
+			}
+			character.SetDiscovery(snapshot->second.m_found);
+		}
+	}
+
+	for (Item& item : m_items)
+	{
+		FoldCase(item.GetName(), folded_name);
+		const std::map<String, CardSnapshot>::iterator snapshot = card_snapshots[CARD_ITEM].find(folded_name);
+		if (snapshot != card_snapshots[CARD_ITEM].end())
+		{
+			if (item.HasState(snapshot->second.m_state))
+			{
+				item.SetState(snapshot->second.m_state);
+			}
+			item.SetDiscovery(snapshot->second.m_found);
+		}
+	}
+
+	for (Incident& incident : m_incidents)
+	{
+		FoldCase(incident.GetName(), folded_name);
+		const std::map<String, IncidentSnapshot>::iterator snapshot = incident_snapshots.find(folded_name);
+		if (snapshot != incident_snapshots.end())
+		{
+			incident.SetActiveSince(snapshot->second.m_enabled, snapshot->second.m_timeAtActive);
+		}
+	}
+
+	m_gameTime = game_time;
+
+	int loc_idx = -1;
+	if (IsLocationInLookupTable(loc_idx, location_name))
+	{
+		m_currentLocation = &m_locations[loc_idx];
+	}
+
+	m_currentInterest = GetCardByName(interest_type, interest_name);
+	m_currentSubject = GetCardByName(subject_type, subject_name);
+
+	// the shared conditions start from the states and the location put back above, not the ones just loaded
+	m_incidentProgram.Compile(*this);
+}
+
+
+Card* Scenario::GetCardByName(const CardType type, const String& name)
+{
+	int card_idx = -1;
+
+	switch (type)
+	{
+	case CARD_LOCATION:
+	{
+		return IsLocationInLookupTable(card_idx, name) ? GetLocationFromList(card_idx) : nullptr;
+	}
+	case CARD_CHARACTER:
+	{
+		return IsCharacterInLookupTable(card_idx, name) ? GetCharacterFromList(card_idx) : nullptr;
+	}
+	case CARD_ITEM:
+	{
+		return IsItemInLookupTable(card_idx, name) ? GetItemFromList(card_idx) : nullptr;
+	}
+	}
+
+	return nullptr;
+}
+
+
 void Scenario::SetupLocationLookupTable()
 {
 	const int num_locations = static_cast<int>(m_locations.size());
@@ -1594,7 +3014,7 @@ void Scenario::SetupLocationLookupTable()
 		AddToLocationLookupTable(m_locations[loc_idx].GetName(), loc_idx);
 
 		//reference for every nickname
-		StringList nickname_list = m_locations[loc_idx].GetListOfNicknames();
+		const StringList& nickname_list = m_locations[loc_idx].GetListOfNicknames();
 		const int num_nicknames = static_cast<int>(nickname_list.size());
 		for (int nn_idx = 0; nn_idx < num_nicknames; ++nn_idx)
 		{
@@ -1613,7 +3033,7 @@ void Scenario::SetupCharacterLookupTable()
 		AddToCharacterLookupTable(m_characters[char_idx].GetName(), char_idx);
 
 		//reference for every nickname
-		StringList nickname_list = m_characters[char_idx].GetListOfNicknames();
+		const StringList& nickname_list = m_characters[char_idx].GetListOfNicknames();
 		const int num_nicknames = static_cast<int>(nickname_list.size());
 		for (int nn_idx = 0; nn_idx < num_nicknames; ++nn_idx)
 		{
@@ -1632,7 +3052,7 @@ void Scenario::SetupItemLookupTable()
 		AddToItemLookupTable(m_items[item_idx].GetName(), item_idx);
 
 		//reference for every nickname
-		StringList nickname_list = m_items[item_idx].GetListOfNicknames();
+		const StringList& nickname_list = m_items[item_idx].GetListOfNicknames();
 		const int num_nicknames = static_cast<int>(nickname_list.size());
 		for (int nn_idx = 0; nn_idx < num_nicknames; ++nn_idx)
 		{
@@ -1655,58 +3075,59 @@ void Scenario::SetupIncidentLookupTable()
 
 void Scenario::AddToLocationLookupTable(const String& key_loc_name, int value_idx)
 {
-	LookupItr loc_itr;
-	String name_to_lower = StringToLower(key_loc_name);
-	const bool in_list_already = IsLocationInLookupTable(loc_itr, name_to_lower);
-	ASSERT_OR_DIE(!in_list_already, Stringf("Duplicate Location name: %s", loc_itr->first.c_str()));
-	m_locationLookup.insert(Lookup(name_to_lower, value_idx));
+	const bool is_new_name = m_cardIndex.Insert(CARD_INDEX_LOCATION, key_loc_name, value_idx);
+	ASSERT_OR_DIE(is_new_name, Stringf("Duplicate Location name: %s", StringToLower(key_loc_name).c_str()));
 }
 
 
 void Scenario::AddToCharacterLookupTable(const String& key_loc_name, int value_idx)
 {
-	LookupItr char_itr;
-	String name_to_lower = StringToLower(key_loc_name);
-	const bool in_list_already = IsCharacterInLookupTable(char_itr, name_to_lower);
-	ASSERT_OR_DIE(!in_list_already, Stringf("Duplicate Character name: %s", char_itr->first.c_str()));
-	m_characterLookup.insert(Lookup(name_to_lower, value_idx));
+	const bool is_new_name = m_cardIndex.Insert(CARD_INDEX_CHARACTER, key_loc_name, value_idx);
+	ASSERT_OR_DIE(is_new_name, Stringf("Duplicate Character name: %s", StringToLower(key_loc_name).c_str()));
 }
 
 
 void Scenario::AddToItemLookupTable(const String& key_loc_name, int value_idx)
 {
-	LookupItr item_itr;
-	String name_to_lower = StringToLower(key_loc_name);
-	const bool in_list_already = IsItemInLookupTable(item_itr, name_to_lower);
-	ASSERT_OR_DIE(!in_list_already, Stringf("Duplicate Item name: %s", item_itr->first.c_str()));
-	m_itemLookup.insert(Lookup(name_to_lower, value_idx));
+	const bool is_new_name = m_cardIndex.Insert(CARD_INDEX_ITEM, key_loc_name, value_idx);
+	ASSERT_OR_DIE(is_new_name, Stringf("Duplicate Item name: %s", StringToLower(key_loc_name).c_str()));
 }
 
 
 void Scenario::AddToIncidentLookupTable(const String& key_loc_name, int value_idx)
 {
-	LookupItr incident_itr;
-	String name_to_lower = StringToLower(key_loc_name);
-	const bool in_list_already = IsIncidentInLookupTable(incident_itr, name_to_lower);
-	ASSERT_OR_DIE(!in_list_already, Stringf("Duplicate Incident name: %s", incident_itr->first.c_str()));
-	m_incidentLookup.insert(Lookup(name_to_lower, value_idx));
+	const bool is_new_name = m_cardIndex.Insert(CARD_INDEX_INCIDENT, key_loc_name, value_idx);
+	ASSERT_OR_DIE(is_new_name, Stringf("Duplicate Incident name: %s", StringToLower(key_loc_name).c_str()));
 }
 
 
 void Scenario::OpenXmlFile(tinyxml2::XMLDocument* out, const String& file_path)
+{
+	LoadXmlFile(out, file_path);
+	ValidateXmlFile(out, file_path);
+}
+
+
+void Scenario::ValidateXmlFile(const tinyxml2::XMLDocument* doc, const String& file_path)
 {
 	const char* file_path_c_str = file_path.c_str();
-	out->LoadFile(file_path_c_str);
 
-	if (out->ErrorID() != tinyxml2::XML_SUCCESS)
+	if (doc->ErrorID() != tinyxml2::XML_SUCCESS)
 	{
 		std::string error_message = "\n";
 
 		error_message.append(Stringf(">> ERROR loading XML doc \"%s\"\n", file_path_c_str));
-		error_message.append(Stringf(">> errorID = %i\n", out->ErrorID()));
-		error_message.append(Stringf(">> errorLineNum = %i\n", out->ErrorLineNum()));
-		error_message.append(Stringf(">> errorName = \"%s\"\n", out->ErrorName()));
+		error_message.append(Stringf(">> errorID = %i\n", doc->ErrorID()));
+		error_message.append(Stringf(">> errorLineNum = %i\n", doc->ErrorLineNum()));
+		error_message.append(Stringf(">> errorName = \"%s\"\n", doc->ErrorName()));
 
 		ERROR_AND_DIE(error_message);
 	}
 }
+
+
+void Scenario::PrintLoadStageTime(const char* stage_name, const double stage_start_seconds) const
+{
+	const double stage_ms = (GetCurrentTimeSeconds() - stage_start_seconds) * 1000.0;
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("Scenario load %s: %.3f ms", stage_name, stage_ms));
+}
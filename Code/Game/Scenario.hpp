@@ -1,9 +1,17 @@
 #pragma once
 #include "Game/GameCommon.hpp"
+#include "Game/SymbolTable.hpp"
+#include "Game/ScenarioArena.hpp"
+#include "Game/CardIndex.hpp"
+#include "Game/FuzzyNameIndex.hpp"
+#include "Game/NameMatcher.hpp"
+#include "Game/IncidentProgram.hpp"
 
 #include "Engine/Math/Matrix44.hpp"
 #include "Engine/Core/EventSystem.hpp"
 
+#include <filesystem>
+
 
 class Game;
 class Material;
@@ -11,11 +19,39 @@ class Shader;
 class GPUMesh;
 class DialogueSystem;
 
+enum ScenarioFile
+{
+	SCENARIO_FILE_LOCATIONS,
+	SCENARIO_FILE_CHARACTERS,
+	SCENARIO_FILE_ITEMS,
+	SCENARIO_FILE_SETTINGS,
+	SCENARIO_FILE_INCIDENTS,
+	SCENARIO_FILE_VICTORY_CONDITIONS,
+
+	NUM_SCENARIO_FILES
+};
+
+// What a top level xml element looked like when it was loaded, used to find what a hot reload needs to rebuild
+struct ScenarioElementHash
+{
+public:
+	String	m_name = "";
+	uint	m_hash = 0;
+};
+
+constexpr double SCENARIO_FILE_CHECK_SECONDS = 0.5;
+
+// Bump whenever loading the xml produces something different, it invalidates every ScenarioCache.cocs
+constexpr uint SCENARIO_LOADER_VERSION = 1;
+
 //Debugging
 static bool DumpLocations(EventArgs& args);
 static bool DumpCharacter(EventArgs& args);
 static bool DumpItems(EventArgs& args);
 static bool DumpIncident(EventArgs& args);
+static bool CompileScenario(EventArgs& args);
+static bool ReloadScenario(EventArgs& args);
+static bool PrintScenarioArena(EventArgs& args);
 
 // Scenario interaction functions
 static bool TravelToLocation(EventArgs& args);
@@ -43,24 +79,54 @@ public:
 
 	void Startup();
 	void Shutdown();
+	static void SubscribeDialogueCommands(DialogueCommandTable& commands);	// the handler of every verb the player types
 
 	void Update(const double delta_seconds);
 	void Render() const;
 
 	void LoadInScenarioManually();
 	void LoadInScenarioFile(const char* folder_dir);
-
-	bool IsLocationInLookupTable(LookupItr& out, const String& name);
-	bool IsCharacterInLookupTable(LookupItr& out, const String& name);
-	bool IsItemInLookupTable(LookupItr& out, const String& name);
-	bool IsIncidentInLookupTable(LookupItr& out, const String& name);
-	bool IsCardInLookupTable(LookupItr& out_itr, CardType& out_type, const String& name);
+	void LoadInScenarioFileParallel(const char* folder_dir);
+	bool LoadInScenarioImage(const char* image_path);
+	static const char* GetScenarioFileName(ScenarioFile file);
+	bool SaveScenarioImage(const char* image_path) const;
+	void ReloadScenarioFiles(bool force_all);
+
+	bool IsLocationInLookupTable(int& out_idx, std::string_view name) const;
+	bool IsCharacterInLookupTable(int& out_idx, std::string_view name) const;
+	bool IsItemInLookupTable(int& out_idx, std::string_view name) const;
+	bool IsIncidentInLookupTable(int& out_idx, std::string_view name) const;
+	bool IsCardInLookupTable(int& out_idx, CardType& out_type, std::string_view name) const;
+	bool IsCardNearLookupTable(int& out_idx, CardIndexKind& out_kind, uint kind_mask, std::string_view name) const;	// one typo away, two for long names
+	void GetCardNames(std::vector<CardIndexName>& out_names) const;
+	void FindNameMentions(std::string_view text, std::vector<NameMention>& out_mentions) const;
 
 	Location*	GetLocationFromList(int idx);
 	Character*	GetCharacterFromList(int idx);
 	Item*		GetItemFromList(int idx);
 	Incident*	GetIncidentFromList(int idx);
 
+	// Where each character is, kept by Location::Add/RemoveCharacterFromLocation
+	int			GetLocationListIdx(const Location* loc) const;
+	int			GetCharacterListIdx(const Character* character) const;
+	int			GetItemListIdx(const Item* item) const;
+	int			GetIncidentListIdx(const Incident* incident) const;
+	Location*	GetCharacterLocation(int char_idx);						// nullptr when the character is nowhere
+	void		SetCharacterLocation(int char_idx, int loc_idx);
+
+	SymbolTable&	GetSymbolTable();
+	ScenarioArena&	GetArena();
+	IncidentProgram&	GetIncidentProgram();
+	void			PrintArenaStats() const;
+	SymbolId		InternName(const String& name);
+	const String&	GetSymbolName(SymbolId id) const;
+
+	// Link pass, every name reference is bound to a list index once after loading. Dangling ones come back as -1
+	// and are added to out_errors so they can be reported together.
+	int		LinkCardReference(CardType type, SymbolId name_id, const String& referrer, StringList& out_errors);
+	int		LinkStateReference(CardType type, int card_idx, SymbolId state_id, const String& referrer, StringList& out_errors);
+	int		LinkIncidentReference(const String& incident_name, const String& referrer, StringList& out_errors);
+
 	String& GetUnknownLocation();
 	String& GetUnknownCharacter();
 	String& GetUnknownItem();
@@ -71,6 +137,9 @@ public:
 	StringList GetListOfKnownLocations();
 	StringList GetListOfKnownItems();
 	StringList GetListOfKnownCharacters();
+	void	GetKnownCardNames(CardType type, StringList& out_names) const;	// names and nicknames of what the journal lists
+	uint	GetNumLinks() const;
+	const String&	GetName() const;
 
 	Location*	GetCurrentLocation();
 	Card*		GetCurrentInterest();
@@ -86,7 +155,9 @@ public:
 	uint		GetExamineItemChangeTime() const;
 	uint		GetInterrogateChangeTime() const;
 	uint		GetWastingTime() const;
-	void		TestIncidents();
+	void		TestIncidents();												// only the incidents reading something that changed
+	void		OnCardStateChanged(CardType type, int card_idx);
+	void		OnIncidentChanged(const Incident* incident);
 	void		TestVictoryConditions();
 	bool		AreAllVictoryConditionsMet() const;
 	bool		IsScenarioSolved() const;
@@ -106,16 +177,41 @@ private:
 	void ManuallySetScenarioSettings();
 
 
-	void ReadLocationsXml(const String& file_path);
-	void ReadCharactersXml(const String& file_path);
-	void ReadItemsXml(const String& file_path);
-	void ReadSettingsXml(const String& file_path);
-	void ReadIncidentsXml(const String& file_path);
-	void ReadVictoryConditionsXml(const String& file_path);
+	void ReadLocationsXml(const XmlElement* root_loc);
+	void ReadCharactersXml(const XmlElement* root_characters);
+	void ReadItemsXml(const XmlElement* root_items);
+	void ReadSettingsXml(const XmlElement* root_setup);
+	void ReadIncidentsXml(const XmlElement* root_incidents);
+	void ReadVictoryConditionsXml(const XmlElement* root_conditions);
 
 	void ReadScenarioSettingsAttributes(const XmlElement* element);
 	void ReadScenarioTimeCostForActions(const XmlElement* element);
 	void ReadScenarioDefaultEnding(const XmlElement* element);
+	void SetDefaultUnknownLines();
+	void LinkScenario();
+
+	// The journal's rules for which cards the player knows about
+	bool IsLocationKnown(const Location& loc) const;
+	bool IsCharacterKnown(const Character& character, SymbolId not_found_state) const;
+	bool IsItemKnown(const Item& item, SymbolId found_state) const;
+
+	// Hot reload
+	void WatchScenarioFolder(const char* folder_dir);
+	void RecordElementHashes(ScenarioFile file, const XmlElement* root);
+	void CheckForScenarioChanges(double delta_seconds);
+	void ReloadChangedElements(ScenarioFile file, const XmlElement* root, int& out_num_rebuilt);
+	void ReloadSettingsKeepingState(const XmlElement* root_setup);
+	void RebuildScenarioKeepingState();
+	Card* GetCardByName(CardType type, const String& name);
+
+	void ReadSettingsFromImage(ScenarioImageReader& reader);
+	void WriteSettingsToImage(ScenarioImageWriter& writer) const;
+	void ReadScenarioFromImage(ScenarioImageReader& reader);
+	void WriteScenarioToImage(ScenarioImageWriter& writer) const;
+
+	// Preprocessed cache of the xml folder, keyed by the hash of its contents
+	bool LoadInScenarioCache(const char* folder_dir, uint source_hash);
+	void SaveScenarioCache(const char* folder_dir, uint source_hash) const;
 	
 
 	// Database manipulation
@@ -132,6 +228,8 @@ private:
 
 
 	void OpenXmlFile(tinyxml2::XMLDocument* out, const String& file_path);
+	void ValidateXmlFile(const tinyxml2::XMLDocument* doc, const String& file_path);
+	void PrintLoadStageTime(const char* stage_name, double stage_start_seconds) const;
 
 private:
 	// Owner
@@ -156,6 +254,9 @@ private:
 	uint		m_costForUnknownCommand = 5;
 
 
+	// Triggers, conditions and actions, declared before the entities that point into it
+	ScenarioArena		m_arena;
+
 	// Physical representation of Entities in the game
 	LocationList		m_locations;
 	CharacterList		m_characters;
@@ -163,12 +264,24 @@ private:
 	IncidentList		m_incidents;
 	VictoryConditions	m_victoryConditions;
 
+	std::vector<int>	m_characterLocations;	// character list idx to location list idx, -1 when nowhere
+
+	// The incidents compiled by every link, TestIncidents runs this instead of the triggers
+	IncidentProgram		m_incidentProgram;
+
 
-	// To quickly lookup where an item is in it's respective list
-	LookupTable		m_locationLookup;
-	LookupTable		m_characterLookup;
-	LookupTable		m_itemLookup;
-	LookupTable		m_incidentLookup;
+	// To quickly lookup where a card or incident is in it's respective list
+	CardIndex		m_cardIndex;
+
+	// Resolves misspelled names once the exact lookup fails, rebuilt on every link
+	FuzzyNameIndex	m_fuzzyIndex;
+
+	// Every name and nickname mentioned in a command, rebuilt on every link
+	NameMatcher		m_nameMatcher;
+	uint			m_numLinks = 0;				// lets the input box notice the names changed
+
+	// Every card name, state name and dialogue key, case folded
+	SymbolTable		m_symbols;
 
 
 	// Random lines to say when the player writes an unknown name
@@ -176,6 +289,12 @@ private:
 	StringList		m_unknownCharacterLine;
 	StringList		m_unknownItemLine;
 
+	// Hot reload
+	String								m_folderDir = "";
+	double								m_timeSinceFileCheck = 0.0;
+	std::filesystem::file_time_type		m_fileWriteTimes[NUM_SCENARIO_FILES];
+	std::vector<ScenarioElementHash>	m_elementHashes[NUM_SCENARIO_FILES];
+
 	// ImGUI settings
 	bool	m_show = true;
 	bool	m_imguiError = false;
@@ -0,0 +1,84 @@
+#include "Game/ScenarioArena.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+
+//------------------------------------------------------------
+ScenarioArena::ScenarioArena(const size_t block_size) : m_blockSize(block_size)
+{
+	ASSERT_OR_DIE(m_blockSize > 0, "ScenarioArena needs a block size");
+}
+
+
+ScenarioArena::~ScenarioArena()
+{
+	Release();
+}
+
+
+// Destroys in reverse so anything built from an earlier object goes first
+void ScenarioArena::Release()
+{
+	for (size_t destructor_idx = m_destructors.size(); destructor_idx > 0; --destructor_idx)
+	{
+		const Destructor& destructor = m_destructors[destructor_idx - 1];
+		destructor.m_destroy(destructor.m_object);
+	}
+	m_destructors.clear();
+
+	const uint num_blocks = static_cast<uint>(m_blocks.size());
+	for (uint block_idx = 0; block_idx < num_blocks; ++block_idx)
+	{
+		::operator delete(m_blocks[block_idx]);
+	}
+	m_blocks.clear();
+
+	m_blockUsed = 0;
+	m_bytesUsed = 0;
+	m_bytesReserved = 0;
+	m_numObjects = 0;
+}
+
+
+uint ScenarioArena::GetNumObjects() const
+{
+	return m_numObjects;
+}
+
+
+uint ScenarioArena::GetNumBlocks() const
+{
+	return static_cast<uint>(m_blocks.size());
+}
+
+
+size_t ScenarioArena::GetBytesUsed() const
+{
+	return m_bytesUsed;
+}
+
+
+size_t ScenarioArena::GetBytesReserved() const
+{
+	return m_bytesReserved;
+}
+
+
+void* ScenarioArena::Allocate(const size_t size, const size_t alignment)
+{
+	size_t offset = (m_blockUsed + alignment - 1) & ~(alignment - 1);
+
+	if (m_blocks.empty() || offset + size > m_blockSize)
+	{
+		// anything bigger than a block gets a block of its own
+		const size_t new_block_size = size > m_blockSize ? size : m_blockSize;
+		m_blocks.push_back(static_cast<unsigned char*>(::operator new(new_block_size)));
+		m_bytesReserved += new_block_size;
+		offset = 0;
+	}
+
+	m_blockUsed = offset + size;
+	m_bytesUsed += size;
+
+	return m_blocks.back() + offset;
+}
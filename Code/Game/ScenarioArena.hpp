@@ -0,0 +1,79 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Triggers, conditions and actions never change once the scenario is loaded, so they are placed one after another in
+// big blocks owned by the scenario instead of being new'd and deleted one at a time.
+// Nothing is freed on its own, Release runs every destructor and gives the blocks back in one go.
+
+constexpr size_t SCENARIO_ARENA_BLOCK_SIZE = 16 * 1024;
+
+class ScenarioArena
+{
+public:
+	explicit ScenarioArena(size_t block_size = SCENARIO_ARENA_BLOCK_SIZE);
+	~ScenarioArena();
+
+	ScenarioArena(const ScenarioArena&) = delete;
+	ScenarioArena& operator=(const ScenarioArena&) = delete;
+
+	template <typename T, typename ...ARGS>
+	T*		Create(ARGS&& ...args);
+	void	Release();
+
+	uint	GetNumObjects() const;
+	uint	GetNumBlocks() const;
+	size_t	GetBytesUsed() const;
+	size_t	GetBytesReserved() const;
+
+private:
+	void*	Allocate(size_t size, size_t alignment);
+
+	template <typename T>
+	static void DestroyObject(void* object);
+
+private:
+	struct Destructor
+	{
+		void	(*m_destroy)(void*) = nullptr;
+		void*	m_object = nullptr;
+	};
+
+	size_t						m_blockSize = SCENARIO_ARENA_BLOCK_SIZE;
+	std::vector<unsigned char*>	m_blocks;
+	size_t						m_blockUsed = 0;	// bytes used in the last block
+	size_t						m_bytesUsed = 0;
+	size_t						m_bytesReserved = 0;
+	std::vector<Destructor>		m_destructors;
+	uint						m_numObjects = 0;
+};
+
+
+//------------------------------------------------------------
+template <typename T, typename ...ARGS>
+T* ScenarioArena::Create(ARGS&& ...args)
+{
+	void* memory = Allocate(sizeof(T), alignof(T));
+	T* object = new (memory) T(std::forward<ARGS>(args)...);
+
+	if constexpr (!std::is_trivially_destructible<T>::value)
+	{
+		Destructor destructor;
+		destructor.m_destroy = &ScenarioArena::DestroyObject<T>;
+		destructor.m_object = object;
+		m_destructors.push_back(destructor);
+	}
+
+	m_numObjects++;
+	return object;
+}
+
+
+template <typename T>
+void ScenarioArena::DestroyObject(void* object)
+{
+	static_cast<T*>(object)->~T();
+}
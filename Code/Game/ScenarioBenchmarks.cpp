@@ -0,0 +1,338 @@
+#include "Game/ScenarioBenchmarks.hpp"
+#include "Game/Scenario.hpp"
+#include "Game/Location.hpp"
+#include "Game/Character.hpp"
+#include "Game/Item.hpp"
+#include "Game/Incident.hpp"
+#include "Game/Trigger.hpp"
+#include "Game/CardIndex.hpp"
+#include "Game/FuzzyNameIndex.hpp"
+#include "Game/CompletionIndex.hpp"
+#include "Game/DialogueCommand.hpp"
+#include "Game/DialogueSystem.hpp"
+
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+	#include <crtdbg.h>
+#endif
+
+
+//------------------------------------------------------------
+// Runs on the names of the loaded scenario, then on synthetic names spread over the four lists
+void BenchmarkScenarioCardLookup(const Scenario& the_scenario, const uint num_synthetic_names, const uint num_queries)
+{
+	std::vector<CardIndexName> names;
+	the_scenario.GetCardNames(names);
+
+	BenchmarkCardIndex(the_scenario.GetName().c_str(), names, num_queries);
+
+	names.clear();
+	names.reserve(num_synthetic_names);
+	for (uint name_idx = 0; name_idx < num_synthetic_names; ++name_idx)
+	{
+		const CardIndexKind kind = static_cast<CardIndexKind>(name_idx % NUM_CARD_INDEX_KINDS);
+		names.push_back({ kind, Stringf("Synthetic Card Name %u", name_idx), static_cast<int>(name_idx / NUM_CARD_INDEX_KINDS) });
+	}
+
+	BenchmarkCardIndex("synthetic", names, num_queries);
+}
+
+
+// Synthetic names are made of syllables so they are as far apart as real ones, numbered names would all be near misses
+static void MakeSyntheticCardNames(const uint num_names, std::vector<CardIndexName>& out_names)
+{
+	static const char* const syllables[] = { "al", "bar", "cor", "dun", "el", "fen", "gar", "hol", "is", "jor", "kel", "lan",
+		"mor", "nes", "or", "pel", "quin", "ros", "sil", "tam", "ur", "vel", "wen", "yar", "zan" };
+	const uint num_syllables = static_cast<uint>(std::size(syllables));
+
+	std::mt19937 rng(1);
+	out_names.reserve(out_names.size() + num_names);
+	for (uint name_idx = 0; name_idx < num_names; ++name_idx)
+	{
+		String name;
+		const uint num_name_syllables = 3 + rng() % 3;
+		for (uint syllable_idx = 0; syllable_idx < num_name_syllables; ++syllable_idx)
+		{
+			name += syllables[rng() % num_syllables];
+			if (syllable_idx == 1)
+			{
+				name += ' ';
+			}
+		}
+
+		const CardIndexKind kind = static_cast<CardIndexKind>(name_idx % NUM_CARD_INDEX_KINDS);
+		out_names.push_back({ kind, name, static_cast<int>(name_idx / NUM_CARD_INDEX_KINDS) });
+	}
+}
+
+
+void BenchmarkScenarioFuzzyMatch(const Scenario& the_scenario, const uint num_synthetic_names, const uint num_queries)
+{
+	std::vector<CardIndexName> names;
+	the_scenario.GetCardNames(names);
+	BenchmarkFuzzyNameIndex(the_scenario.GetName().c_str(), names, num_queries);
+
+	names.clear();
+	MakeSyntheticCardNames(num_synthetic_names, names);
+	BenchmarkFuzzyNameIndex("synthetic", names, num_queries);
+}
+
+
+void BenchmarkScenarioCompletion(const Scenario& the_scenario, const uint num_synthetic_names)
+{
+	std::vector<CardIndexName> names;
+	the_scenario.GetCardNames(names);
+
+	StringList completions;
+	for (const CardIndexName& entry : names)
+	{
+		completions.push_back(entry.m_name);
+	}
+	BenchmarkCompletionIndex(the_scenario.GetName().c_str(), completions);
+
+	names.clear();
+	completions.clear();
+	MakeSyntheticCardNames(num_synthetic_names, names);
+	for (const CardIndexName& entry : names)
+	{
+		completions.push_back(entry.m_name);
+	}
+	BenchmarkCompletionIndex("synthetic", completions);
+}
+
+
+// Total bytes the CRT has handed out so far, only the debug CRT keeps the count
+static bool GetTotalBytesAllocated(size_t& out_bytes)
+{
+#if defined(_MSC_VER) && defined(_DEBUG)
+	_CrtMemState mem_state;
+	_CrtMemCheckpoint(&mem_state);
+	out_bytes = mem_state.lTotalCount;
+	return true;
+#else
+	out_bytes = 0;
+	return false;
+#endif
+}
+
+
+// One turn of play per location, the player walks in, searches, looks at an item, then questions someone about it
+static void MakeScriptedTurns(const Scenario& the_scenario, const uint num_turns, std::vector<ValidCommands>& out_verbs, StringList& out_lines)
+{
+	const LocationList& locations = *the_scenario.GetLocationList();
+	const CharacterList& characters = *the_scenario.GetCharacterList();
+	const ItemList& items = *the_scenario.GetItemList();
+
+	const auto add_command = [&out_verbs, &out_lines](const ValidCommands verb, const String& line)
+	{
+		out_verbs.push_back(verb);
+		out_lines.push_back(line);
+	};
+
+	for (uint turn_idx = 0; turn_idx < num_turns; ++turn_idx)
+	{
+		add_command(GOTO_LOCATION, locations[turn_idx % locations.size()].GetName());
+		add_command(INVESTIGATE_ROOM, String());
+
+		String item_name;
+		if (!items.empty())
+		{
+			item_name = items[turn_idx % items.size()].GetName();
+			add_command(VIEW_ITEM, item_name);
+		}
+
+		if (!characters.empty())
+		{
+			const String& character_name = characters[turn_idx % characters.size()].GetName();
+			add_command(TALK_TO_CHARACTER, character_name);
+			add_command(ASK_CHARACTER, item_name.empty() ? character_name : Stringf("%s about the %s", character_name.c_str(), item_name.c_str()));
+			add_command(SAY_GOODBYE, String());
+		}
+
+		add_command(LEAVE_ROOM, String());
+	}
+}
+
+
+// Plays scripted turns on the loaded scenario through the real command handlers, the same way a typed line is fired,
+// and reports the bytes the CRT hands out and the time per turn. The turns change the scenario and fill the log, so
+// reload_scenario afterwards. Running it on both sides of an accessor change shows what the change saves in play.
+void BenchmarkScenarioTurns(Scenario& the_scenario, DialogueSystem& dialogue_system, const uint num_turns)
+{
+	if (num_turns == 0)
+	{
+		g_theDevConsole->PrintString(Rgba::RED, "bench_turn needs at least one turn");
+		return;
+	}
+	if (g_theDialogueCommands == nullptr || the_scenario.GetLocationList()->empty())
+	{
+		g_theDevConsole->PrintString(Rgba::RED, "bench_turn needs a started scenario with at least one location");
+		return;
+	}
+
+	// the lines are made up front so the script is not counted as part of the turns
+	std::vector<ValidCommands> verbs;
+	StringList lines;
+	MakeScriptedTurns(the_scenario, num_turns, verbs, lines);
+
+	size_t bytes_before = 0;
+	const bool has_byte_count = GetTotalBytesAllocated(bytes_before);
+
+	uint num_handled = 0;
+	const double start = GetCurrentTimeSeconds();
+	for (size_t command_idx = 0; command_idx < verbs.size(); ++command_idx)
+	{
+		DialogueCommand command;
+		command.m_verb = verbs[command_idx];
+		command.m_line = lines[command_idx];
+		command.m_scenario = &the_scenario;
+		command.m_dialogueSystem = &dialogue_system;
+		dialogue_system.SetMentions(command);
+
+		if (g_theDialogueCommands->Fire(command))
+		{
+			num_handled++;
+		}
+
+		if (command.m_verb == LEAVE_ROOM)
+		{
+			the_scenario.TestIncidents();
+		}
+	}
+	const double seconds = GetCurrentTimeSeconds() - start;
+
+	size_t bytes_after = 0;
+	GetTotalBytesAllocated(bytes_after);
+
+	const String bytes_line = has_byte_count
+		? Stringf("%.1f bytes/turn", static_cast<double>(bytes_after - bytes_before) / static_cast<double>(num_turns))
+		: String("bytes/turn needs the debug CRT");
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("%s: %u turns, %u of %u commands handled",
+		the_scenario.GetName().c_str(), num_turns, num_handled, static_cast<uint>(verbs.size())));
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("\t %s  %.2f us/turn", bytes_line.c_str(), seconds * 1e6 / static_cast<double>(num_turns)));
+}
+
+
+// The triggers tested without their actions, so a pass leaves the scenario as it was
+static uint TestIncidentTriggers(const IncidentList& incidents)
+{
+	uint num_fired = 0;
+	for (const Incident& incident : incidents)
+	{
+		if (!incident.IsIncidentEnabled())
+		{
+			continue;
+		}
+
+		for (const Trigger* trigger : *incident.GetTriggerList())
+		{
+			if (trigger->TestConditions())
+			{
+				num_fired++;
+				break;
+			}
+		}
+	}
+
+	return num_fired;
+}
+
+
+// Every incident tested through the virtual conditions and through the compiled program, then only the incidents
+// a card changing state marks through the shared conditions, one card a pass. None of them run the actions, and the
+// scenario's own program is put back the way it was after.
+// generate_scenario incidents=10000 conditions=3 writes a scenario big enough to see the difference, and with the
+// default card counts most of its conditions are shared by hundreds of incidents.
+void BenchmarkScenarioIncidentTests(Scenario& the_scenario, const uint num_passes)
+{
+	if (num_passes == 0)
+	{
+		g_theDevConsole->PrintString(Rgba::RED, "bench_incidents needs at least one pass");
+		return;
+	}
+
+	const IncidentList& incidents = *the_scenario.GetIncidentList();
+	IncidentProgram& program = the_scenario.GetIncidentProgram();
+
+	uint virtual_fired = 0;
+	const double virtual_start = GetCurrentTimeSeconds();
+	for (uint pass_idx = 0; pass_idx < num_passes; ++pass_idx)
+	{
+		virtual_fired += TestIncidentTriggers(incidents);
+	}
+	const double virtual_seconds = GetCurrentTimeSeconds() - virtual_start;
+
+	uint program_fired = 0;
+	const double program_start = GetCurrentTimeSeconds();
+	for (uint pass_idx = 0; pass_idx < num_passes; ++pass_idx)
+	{
+		program_fired += program.Run(the_scenario, false);
+	}
+	const double program_seconds = GetCurrentTimeSeconds() - program_start;
+
+	// the tracked passes start with nothing dirty, what this clears is marked again at the end
+	program.RunDirty(the_scenario, false);
+
+	// every card leaves its state and comes back, so each pass makes and breaks the joins reading it
+	const uint num_cards[NUM_CARD_TYPES] = { static_cast<uint>(the_scenario.GetLocationList()->size()),
+		static_cast<uint>(the_scenario.GetCharacterList()->size()), static_cast<uint>(the_scenario.GetItemList()->size()) };
+	CardType last_changed_type = UNKNOWN_CARD_TYPE;
+	int last_changed_idx = -1;
+	uint num_tracked_tests = 0;
+	double tracked_seconds = 0.0;
+	for (uint pass_idx = 0; pass_idx < num_passes; ++pass_idx)
+	{
+		const CardType changed_type = static_cast<CardType>((pass_idx / 2) % NUM_CARD_TYPES);
+		if (num_cards[changed_type] > 0)
+		{
+			const int card_idx = static_cast<int>((pass_idx / (2 * NUM_CARD_TYPES)) % num_cards[changed_type]);
+			const bool is_leaving = (pass_idx % 2) == 0;
+
+			if (is_leaving)
+			{
+				program.UpdateCardState(changed_type, card_idx, INVALID_SYMBOL);
+			}
+			else
+			{
+				the_scenario.OnCardStateChanged(changed_type, card_idx);
+			}
+
+			last_changed_type = changed_type;
+			last_changed_idx = card_idx;
+		}
+		num_tracked_tests += program.GetNumDirty();
+
+		const double tracked_start = GetCurrentTimeSeconds();
+		program.RunDirty(the_scenario, false);
+		tracked_seconds += GetCurrentTimeSeconds() - tracked_start;
+	}
+
+	// the last card back in its state, and every incident tested for real next turn since none of these ran actions
+	the_scenario.OnCardStateChanged(last_changed_type, last_changed_idx);
+	program.MarkAllDirty();
+
+	const double num_tests = static_cast<double>(num_passes) * static_cast<double>(std::max<size_t>(incidents.size(), 1));
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("%s: %u incidents, %u instructions, %u conditions left virtual, %u passes",
+		the_scenario.GetName().c_str(), static_cast<uint>(incidents.size()), program.GetNumInstructions(),
+		program.GetNumVirtualConditions(), num_passes));
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("\t %u shared conditions read by %u tests",
+		program.GetNumSharedConditions(), program.GetNumSharedUses()));
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("\t virtual conditions: %.2f ms/pass  %.1f ns/incident  (%u fired)",
+		virtual_seconds * 1000.0 / static_cast<double>(num_passes), virtual_seconds * 1e9 / num_tests, virtual_fired));
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("\t compiled program: %.2f ms/pass  %.1f ns/incident  (%u fired)",
+		program_seconds * 1000.0 / static_cast<double>(num_passes), program_seconds * 1e9 / num_tests, program_fired));
+	g_theDevConsole->PrintString(Rgba::GREEN, Stringf("\t shared conditions: %.2f ms/pass  %.1f incidents tested/pass",
+		tracked_seconds * 1000.0 / static_cast<double>(num_passes), static_cast<double>(num_tracked_tests) / static_cast<double>(num_passes)));
+
+	if (virtual_fired != program_fired)
+	{
+		g_theDevConsole->PrintString(Rgba::RED, "The compiled incidents and the triggers disagree on what fires");
+	}
+}
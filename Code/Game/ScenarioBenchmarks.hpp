@@ -0,0 +1,14 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+class Scenario;
+class DialogueSystem;
+
+// The bench_ dev console commands, run against the loaded scenario through its public interface. Each one runs on
+// the scenario's own names or cards first, then on synthetic ones where the scenario is too small to tell.
+
+void BenchmarkScenarioCardLookup(const Scenario& the_scenario, uint num_synthetic_names, uint num_queries);
+void BenchmarkScenarioFuzzyMatch(const Scenario& the_scenario, uint num_synthetic_names, uint num_queries);
+void BenchmarkScenarioCompletion(const Scenario& the_scenario, uint num_synthetic_names);
+void BenchmarkScenarioTurns(Scenario& the_scenario, DialogueSystem& dialogue_system, uint num_turns);
+void BenchmarkScenarioIncidentTests(Scenario& the_scenario, uint num_passes);
@@ -0,0 +1,381 @@
+#include "Game/ScenarioCatalog.hpp"
+#include "Game/ScenarioImage.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+
+// Reads just far enough into an xml file to return its root start tag, skipping the prolog and comments
+static bool ReadRootStartTag(const String& file_path, String& out_tag)
+{
+	FILE* file = fopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	String text;
+	char chunk[1024];
+	size_t scan_pos = 0;
+	size_t tag_start = String::npos;
+	char open_quote = 0;
+	bool found_end = false;
+
+	while (!found_end)
+	{
+		const size_t bytes_read = fread(chunk, 1, sizeof(chunk), file);
+		if (bytes_read == 0)
+		{
+			break;
+		}
+		text.append(chunk, bytes_read);
+
+		while (scan_pos < text.size() && !found_end)
+		{
+			if (tag_start == String::npos)
+			{
+				const size_t open_pos = text.find('<', scan_pos);
+				if (open_pos == String::npos)
+				{
+					scan_pos = text.size();
+					break;
+				}
+
+				// need a few characters to tell a declaration or comment from the root
+				if (open_pos + 4 > text.size())
+				{
+					scan_pos = open_pos;
+					break;
+				}
+
+				const char* skip_to = nullptr;
+				if (text[open_pos + 1] == '?')
+				{
+					skip_to = "?>";
+				}
+				else if (text.compare(open_pos + 1, 3, "!--") == 0)
+				{
+					skip_to = "-->";
+				}
+				else if (text[open_pos + 1] == '!')
+				{
+					skip_to = ">";
+				}
+
+				if (skip_to == nullptr)
+				{
+					tag_start = open_pos;
+					scan_pos = open_pos + 1;
+					continue;
+				}
+
+				const size_t close_pos = text.find(skip_to, open_pos + 2);
+				if (close_pos == String::npos)
+				{
+					scan_pos = open_pos;
+					break;
+				}
+				scan_pos = close_pos + strlen(skip_to);
+			}
+			else
+			{
+				// attribute values are allowed to hold a raw '>'
+				const char c = text[scan_pos++];
+				if (open_quote != 0)
+				{
+					if (c == open_quote)
+					{
+						open_quote = 0;
+					}
+				}
+				else if (c == '"' || c == '\'')
+				{
+					open_quote = c;
+				}
+				else if (c == '>')
+				{
+					found_end = true;
+				}
+			}
+		}
+	}
+
+	fclose(file);
+
+	if (!found_end)
+	{
+		return false;
+	}
+
+	out_tag = text.substr(tag_start, scan_pos - tag_start);
+	return true;
+}
+
+
+//------------------------------------------------------------
+ScenarioCatalog::ScenarioCatalog() = default;
+ScenarioCatalog::~ScenarioCatalog() = default;
+
+
+void ScenarioCatalog::Scan(const String& root_dir)
+{
+	const double start_time = GetCurrentTimeSeconds();
+
+	m_rootDir = root_dir;
+	m_entries.clear();
+	m_numHeadersRead = 0;
+
+	const String index_path = m_rootDir + "/" + SCENARIO_CATALOG_FILE_NAME;
+	std::map<String, ScenarioCatalogEntry> cached_entries;
+	ReadCatalogIndex(index_path, cached_entries);
+
+	std::error_code error;
+	std::filesystem::directory_iterator folder_itr(m_rootDir, error);
+	if (error)
+	{
+		ERROR_RECOVERABLE(Stringf("Could not open the scenario folder %s", m_rootDir.c_str()));
+		return;
+	}
+
+	bool is_index_stale = false;
+	for (; folder_itr != std::filesystem::directory_iterator(); folder_itr.increment(error))
+	{
+		if (error)
+		{
+			break;
+		}
+
+		std::error_code entry_error;
+		if (!folder_itr->is_directory(entry_error))
+		{
+			continue;
+		}
+
+		ScenarioCatalogEntry entry;
+		entry.m_folderName = folder_itr->path().filename().string();
+		entry.m_folderDir = m_rootDir + "/" + entry.m_folderName;
+
+		// folders without settings are not scenarios
+		const String settings_path = entry.m_folderDir + "/Settings.xml";
+		const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(settings_path, entry_error);
+		if (entry_error)
+		{
+			continue;
+		}
+		entry.m_settingsWriteTime = static_cast<int64_t>(write_time.time_since_epoch().count());
+		entry.m_settingsFileSize = static_cast<uint32_t>(std::filesystem::file_size(settings_path, entry_error));
+
+		const std::map<String, ScenarioCatalogEntry>::const_iterator cached_itr = cached_entries.find(entry.m_folderName);
+		if (cached_itr != cached_entries.end()
+			&& cached_itr->second.m_settingsWriteTime == entry.m_settingsWriteTime
+			&& cached_itr->second.m_settingsFileSize == entry.m_settingsFileSize)
+		{
+			entry.m_name = cached_itr->second.m_name;
+			entry.m_introMessage = cached_itr->second.m_introMessage;
+			entry.m_startingLocation = cached_itr->second.m_startingLocation;
+			m_entries.push_back(entry);
+			continue;
+		}
+
+		is_index_stale = true;
+		if (!ReadSettingsHeader(settings_path, entry))
+		{
+			g_theDevConsole->PrintString(Rgba::RED, Stringf("Could not read the ScenarioSettings tag of %s", settings_path.c_str()));
+			continue;
+		}
+
+		m_numHeadersRead++;
+		m_entries.push_back(entry);
+	}
+
+	// directory order is up to the file system
+	std::sort(m_entries.begin(), m_entries.end(), [](const ScenarioCatalogEntry& a, const ScenarioCatalogEntry& b)
+	{
+		return a.m_folderName < b.m_folderName;
+	});
+
+	if (is_index_stale || cached_entries.size() != m_entries.size())
+	{
+		if (!WriteCatalogIndex(index_path))
+		{
+			g_theDevConsole->PrintString(Rgba::RED, Stringf("Could not write the scenario index %s", index_path.c_str()));
+		}
+	}
+
+	m_lastScanSeconds = GetCurrentTimeSeconds() - start_time;
+}
+
+
+uint ScenarioCatalog::GetNumEntries() const
+{
+	return static_cast<uint>(m_entries.size());
+}
+
+
+const ScenarioCatalogEntry& ScenarioCatalog::GetEntry(const uint entry_idx) const
+{
+	ASSERT_OR_DIE(entry_idx < m_entries.size(), Stringf("Scenario catalog has no entry %u", entry_idx));
+	return m_entries[entry_idx];
+}
+
+
+int ScenarioCatalog::FindEntry(const String& folder_or_name) const
+{
+	const String lowered_key = StringToLower(folder_or_name);
+
+	const int num_entries = static_cast<int>(m_entries.size());
+	for (int entry_idx = 0; entry_idx < num_entries; ++entry_idx)
+	{
+		const ScenarioCatalogEntry& entry = m_entries[entry_idx];
+		if (StringToLower(entry.m_folderName) == lowered_key || StringToLower(entry.m_name) == lowered_key)
+		{
+			return entry_idx;
+		}
+	}
+
+	return -1;
+}
+
+
+int ScenarioCatalog::GetDefaultEntryIndex() const
+{
+	const int default_idx = FindEntry(DEFAULT_SCENARIO_FOLDER_NAME);
+	if (default_idx >= 0)
+	{
+		return default_idx;
+	}
+
+	return m_entries.empty() ? -1 : 0;
+}
+
+
+double ScenarioCatalog::GetLastScanSeconds() const
+{
+	return m_lastScanSeconds;
+}
+
+
+uint ScenarioCatalog::GetNumHeadersReadOnLastScan() const
+{
+	return m_numHeadersRead;
+}
+
+
+// Parses only the root start tag, the rest of Settings.xml is left for the full load
+STATIC bool ScenarioCatalog::ReadSettingsHeader(const String& settings_path, ScenarioCatalogEntry& out_entry)
+{
+	String root_tag;
+	if (!ReadRootStartTag(settings_path, root_tag))
+	{
+		return false;
+	}
+
+	// close the tag so it parses as a document on its own
+	if (root_tag.size() < 2 || root_tag[root_tag.size() - 2] != '/')
+	{
+		root_tag.insert(root_tag.size() - 1, "/");
+	}
+
+	tinyxml2::XMLDocument doc;
+	if (doc.Parse(root_tag.c_str(), root_tag.size()) != tinyxml2::XML_SUCCESS)
+	{
+		return false;
+	}
+
+	const XmlElement* root = doc.RootElement();
+	for (const XmlAttribute* attribute = root->FirstAttribute();
+		attribute;
+		attribute = attribute->Next()
+		)
+	{
+		const String attribute_name = StringToLower(attribute->Name());
+
+		if (attribute_name == "name")
+		{
+			out_entry.m_name = attribute->Value();
+		}
+		else if (attribute_name == "intromessage")
+		{
+			out_entry.m_introMessage = attribute->Value();
+		}
+		else if (attribute_name == "startinglocation")
+		{
+			out_entry.m_startingLocation = attribute->Value();
+		}
+	}
+
+	if (out_entry.m_name.empty())
+	{
+		out_entry.m_name = out_entry.m_folderName;
+	}
+
+	return true;
+}
+
+
+void ScenarioCatalog::ReadCatalogIndex(const String& index_path, std::map<String, ScenarioCatalogEntry>& out_cached) const
+{
+	if (!std::filesystem::exists(index_path))
+	{
+		return;
+	}
+
+	ScenarioImageReader reader;
+	if (!reader.OpenFile(index_path) || reader.ReadU32() != SCENARIO_CATALOG_VERSION)
+	{
+		return;
+	}
+
+	const uint32_t num_entries = reader.ReadU32();
+	for (uint32_t entry_idx = 0; entry_idx < num_entries && reader.IsValid(); ++entry_idx)
+	{
+		ScenarioCatalogEntry entry;
+		entry.m_folderName = reader.ReadString();
+		entry.m_name = reader.ReadString();
+		entry.m_introMessage = reader.ReadString();
+		entry.m_startingLocation = reader.ReadString();
+
+		const uint64_t write_time_low = reader.ReadU32();
+		const uint64_t write_time_high = reader.ReadU32();
+		entry.m_settingsWriteTime = static_cast<int64_t>((write_time_high << 32) | write_time_low);
+		entry.m_settingsFileSize = reader.ReadU32();
+
+		out_cached[entry.m_folderName] = entry;
+	}
+
+	// a partial index is no better than none
+	if (!reader.IsValid())
+	{
+		out_cached.clear();
+	}
+}
+
+
+bool ScenarioCatalog::WriteCatalogIndex(const String& index_path) const
+{
+	ScenarioImageWriter writer;
+	writer.WriteU32(SCENARIO_CATALOG_VERSION);
+	writer.WriteU32(static_cast<uint32_t>(m_entries.size()));
+
+	for (const ScenarioCatalogEntry& entry : m_entries)
+	{
+		writer.WriteString(entry.m_folderName);
+		writer.WriteString(entry.m_name);
+		writer.WriteString(entry.m_introMessage);
+		writer.WriteString(entry.m_startingLocation);
+
+		const uint64_t write_time = static_cast<uint64_t>(entry.m_settingsWriteTime);
+		writer.WriteU32(static_cast<uint32_t>(write_time & 0xFFFFFFFFu));
+		writer.WriteU32(static_cast<uint32_t>(write_time >> 32));
+		writer.WriteU32(entry.m_settingsFileSize);
+	}
+
+	return writer.SaveToFile(index_path);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <cstdint>
+
+// Lists the installed scenarios without loading them. Each folder under the scenario root contributes the
+// attributes of its Settings.xml root tag, nothing past that tag is read. Results are kept in a small index
+// file next to the folders so a rescan only opens the Settings.xml files that changed since the last one.
+
+constexpr char		SCENARIO_ROOT_FOLDER[] = "Data/Scenarios";
+constexpr char		SCENARIO_CATALOG_FILE_NAME[] = "Catalog.cocs";
+constexpr uint32_t	SCENARIO_CATALOG_VERSION = 1;
+constexpr char		DEFAULT_SCENARIO_FOLDER_NAME[] = "Tutorial";
+
+struct ScenarioCatalogEntry
+{
+	String		m_folderName = "";
+	String		m_folderDir = "";
+	String		m_name = "";
+	String		m_introMessage = "";
+	String		m_startingLocation = "";
+
+	// Settings.xml stamp the entry was read from
+	int64_t		m_settingsWriteTime = 0;
+	uint32_t	m_settingsFileSize = 0;
+};
+
+
+//------------------------------------------------------------
+class ScenarioCatalog
+{
+public:
+	ScenarioCatalog();
+	~ScenarioCatalog();
+
+	void Scan(const String& root_dir = SCENARIO_ROOT_FOLDER);
+
+	uint						GetNumEntries() const;
+	const ScenarioCatalogEntry&	GetEntry(uint entry_idx) const;
+	int							FindEntry(const String& folder_or_name) const;	// -1 when nothing matches
+	int							GetDefaultEntryIndex() const;
+
+	double	GetLastScanSeconds() const;
+	uint	GetNumHeadersReadOnLastScan() const;
+
+	static bool ReadSettingsHeader(const String& settings_path, ScenarioCatalogEntry& out_entry);
+
+private:
+	void ReadCatalogIndex(const String& index_path, std::map<String, ScenarioCatalogEntry>& out_cached) const;
+	bool WriteCatalogIndex(const String& index_path) const;
+
+private:
+	String								m_rootDir = SCENARIO_ROOT_FOLDER;
+	std::vector<ScenarioCatalogEntry>	m_entries;
+	double								m_lastScanSeconds = 0.0;
+	uint								m_numHeadersRead = 0;
+};
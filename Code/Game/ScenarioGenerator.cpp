@@ -0,0 +1,498 @@
+#include "Game/ScenarioGenerator.hpp"
+#include "Game/Scenario.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+
+
+// Reuse the tutorial art so the generated cards can be shown
+static const char* s_locationImages[] = { "Location/Scotland yard.png", "Location/Notting Hill.png", "Location/Leicester Square and Hyde Park.png" };
+static const char* s_characterImages[] = { "Character/Chief.png", "Character/Anna.png", "Character/Rose.png", "Character/Jenny.png", "Character/Doctor.png" };
+static const char* s_itemImages[] = { "Item/Cake.png", "Item/DeadCat.png", "Item/Bridge.png", "Item/OldPhone.png", "Item/Letter.png" };
+
+static const char* s_cardTypeNames[NUM_CARD_TYPES] = { "Location", "Character", "Item" };
+
+
+//------------------------------------------------------------
+void ScenarioGeneratorSettings::ScaleCounts(const uint scale)
+{
+	m_numLocations *= scale;
+	m_numCharacters *= scale;
+	m_numItems *= scale;
+	m_numIncidents *= scale;
+	m_numVictoryConditions *= scale;
+}
+
+
+//------------------------------------------------------------
+ScenarioGenerator::ScenarioGenerator(const ScenarioGeneratorSettings& settings) :
+	m_settings(settings),
+	m_rng(settings.m_seed)
+{
+	// the starting location and the states the game looks up by name always have to exist
+	m_settings.m_numLocations = std::max(m_settings.m_numLocations, 1u);
+	m_settings.m_statesPerCard = std::max(m_settings.m_statesPerCard, 2u);
+}
+
+
+bool ScenarioGenerator::WriteScenarioFolder(const String& folder_dir)
+{
+	std::error_code error;
+	std::filesystem::create_directories(folder_dir, error);
+	if (error)
+	{
+		ERROR_RECOVERABLE(Stringf("Could not create the scenario folder %s", folder_dir.c_str()));
+		return false;
+	}
+
+	const String scenario_name = std::filesystem::path(folder_dir).filename().string();
+
+	for (int file_idx = 0; file_idx < NUM_SCENARIO_FILES; ++file_idx)
+	{
+		const ScenarioFile scenario_file = static_cast<ScenarioFile>(file_idx);
+		const String file_path = folder_dir + "/" + Scenario::GetScenarioFileName(scenario_file);
+
+		FILE* file = fopen(file_path.c_str(), "w");
+		if (file == nullptr)
+		{
+			ERROR_RECOVERABLE(Stringf("Could not open %s to write the generated scenario", file_path.c_str()));
+			return false;
+		}
+
+		tinyxml2::XMLPrinter printer(file);
+		switch (scenario_file)
+		{
+			case SCENARIO_FILE_LOCATIONS:			WriteLocations(printer);					break;
+			case SCENARIO_FILE_CHARACTERS:			WriteCharacters(printer);					break;
+			case SCENARIO_FILE_ITEMS:				WriteItems(printer);						break;
+			case SCENARIO_FILE_SETTINGS:			WriteSettings(printer, scenario_name);		break;
+			case SCENARIO_FILE_INCIDENTS:			WriteIncidents(printer);					break;
+			case SCENARIO_FILE_VICTORY_CONDITIONS:	WriteVictoryConditions(printer);			break;
+			default:																			break;
+		}
+
+		fclose(file);
+	}
+
+	return true;
+}
+
+
+void ScenarioGenerator::WriteLocations(tinyxml2::XMLPrinter& printer)
+{
+	printer.OpenElement("Locations");
+
+	for (uint loc_idx = 0; loc_idx < m_settings.m_numLocations; ++loc_idx)
+	{
+		// the starting location is always open
+		const uint starting_state = loc_idx == 0 ? 1 : RandomIndex(m_settings.m_statesPerCard);
+
+		printer.OpenElement("Location");
+		printer.PushAttribute("Name", GetCardName(CARD_LOCATION, loc_idx).c_str());
+		printer.PushAttribute("StartingState", GetStateName(CARD_LOCATION, starting_state).c_str());
+		printer.PushAttribute("ImageDir", s_locationImages[loc_idx % std::size(s_locationImages)]);
+
+		printer.OpenElement("Nicknames");
+		printer.PushAttribute("List", Stringf("Loc%u", loc_idx).c_str());
+		printer.CloseElement();
+
+		WriteStates(printer, CARD_LOCATION);
+
+		printer.OpenElement("IntroduceCharacter");
+		for (uint rule_idx = 0; rule_idx < m_settings.m_scanRulesPerCard; ++rule_idx)
+		{
+			WriteScanRule(printer, CARD_LOCATION, CARD_CHARACTER, rule_idx == 0);
+		}
+		printer.CloseElement();
+
+		printer.OpenElement("IntroduceItem");
+		for (uint rule_idx = 0; rule_idx < m_settings.m_scanRulesPerCard; ++rule_idx)
+		{
+			WriteScanRule(printer, CARD_LOCATION, CARD_ITEM, rule_idx == 0);
+		}
+		printer.CloseElement();
+
+		printer.CloseElement();
+	}
+
+	printer.CloseElement();
+}
+
+
+void ScenarioGenerator::WriteCharacters(tinyxml2::XMLPrinter& printer)
+{
+	printer.OpenElement("Characters");
+
+	for (uint char_idx = 0; char_idx < m_settings.m_numCharacters; ++char_idx)
+	{
+		printer.OpenElement("Character");
+		printer.PushAttribute("Name", GetCardName(CARD_CHARACTER, char_idx).c_str());
+		printer.PushAttribute("StartingState", GetRandomStateName(CARD_CHARACTER).c_str());
+		printer.PushAttribute("StartLoc", GetRandomCardName(CARD_LOCATION).c_str());
+		printer.PushAttribute("ImageDir", s_characterImages[char_idx % std::size(s_characterImages)]);
+
+		printer.OpenElement("Nicknames");
+		printer.PushAttribute("List", Stringf("Char%u", char_idx).c_str());
+		printer.CloseElement();
+
+		WriteStates(printer, CARD_CHARACTER);
+
+		printer.OpenElement("CharDialogue");
+		for (uint rule_idx = 0; rule_idx < m_settings.m_scanRulesPerCard; ++rule_idx)
+		{
+			WriteScanRule(printer, CARD_CHARACTER, CARD_CHARACTER, rule_idx == 0);
+		}
+		printer.CloseElement();
+
+		printer.OpenElement("ItemDialogue");
+		for (uint rule_idx = 0; rule_idx < m_settings.m_scanRulesPerCard; ++rule_idx)
+		{
+			WriteScanRule(printer, CARD_CHARACTER, CARD_ITEM, rule_idx == 0);
+		}
+		printer.CloseElement();
+
+		printer.CloseElement();
+	}
+
+	printer.CloseElement();
+}
+
+
+void ScenarioGenerator::WriteItems(tinyxml2::XMLPrinter& printer)
+{
+	printer.OpenElement("Items");
+
+	for (uint item_idx = 0; item_idx < m_settings.m_numItems; ++item_idx)
+	{
+		printer.OpenElement("Item");
+		printer.PushAttribute("Name", GetCardName(CARD_ITEM, item_idx).c_str());
+		printer.PushAttribute("StartingState", GetStateName(CARD_ITEM, 0).c_str());
+		printer.PushAttribute("ImageDir", s_itemImages[item_idx % std::size(s_itemImages)]);
+
+		printer.OpenElement("Nicknames");
+		printer.PushAttribute("List", Stringf("Itm%u", item_idx).c_str());
+		printer.CloseElement();
+
+		WriteStates(printer, CARD_ITEM);
+
+		printer.CloseElement();
+	}
+
+	printer.CloseElement();
+}
+
+
+void ScenarioGenerator::WriteSettings(tinyxml2::XMLPrinter& printer, const String& scenario_name)
+{
+	printer.OpenElement("ScenarioSettings");
+	printer.PushAttribute("Name", scenario_name.c_str());
+	printer.PushAttribute("IntroMessage", Stringf("> Generated scenario, seed %u.", m_settings.m_seed).c_str());
+	printer.PushAttribute("ClosedLocationDefaultMessage", "> That location is closed.");
+	printer.PushAttribute("SameLocationMessage", "> You are already in this location.");
+	printer.PushAttribute("UnknownCommand", "> That is not a valid command for the game.");
+	printer.PushAttribute("StartingLocation", GetCardName(CARD_LOCATION, 0).c_str());
+	printer.PushAttribute("StartupEvent", "");
+	printer.PushAttribute("StartingTimeInMilitary", "09:00");
+
+	printer.OpenElement("TimeCostForActions");
+	printer.PushAttribute("MoveToLocation", 20);
+	printer.PushAttribute("InvestigateLocation", 5);
+	printer.PushAttribute("ExamineItem", 5);
+	printer.PushAttribute("InterrogateCharacter", 5);
+	printer.PushAttribute("UnknownCommand", 5);
+	printer.CloseElement();
+
+	printer.OpenElement("DefaultEnding");
+	printer.PushAttribute("Congratulations", "Generated scenario solved.");
+	printer.PushAttribute("Solution", "There is no story, the cards are random.");
+	printer.PushAttribute("ContinueInvestigation", "Keep looking.");
+	printer.CloseElement();
+
+	printer.CloseElement();
+}
+
+
+void ScenarioGenerator::WriteIncidents(tinyxml2::XMLPrinter& printer)
+{
+	printer.OpenElement("Incidents");
+
+	for (uint inc_idx = 0; inc_idx < m_settings.m_numIncidents; ++inc_idx)
+	{
+		printer.OpenElement("Incident");
+		printer.PushAttribute("name", Stringf("Incident %u", inc_idx).c_str());
+		printer.PushAttribute("type", RandomChance(50) ? "OneShot" : "Multiple");
+		printer.PushAttribute("isEnabled", RandomChance(80));
+
+		for (uint trigger_idx = 0; trigger_idx < m_settings.m_triggersPerIncident; ++trigger_idx)
+		{
+			printer.OpenElement("Trigger");
+			printer.PushAttribute("name", Stringf("Trigger %u of incident %u", trigger_idx, inc_idx).c_str());
+
+			printer.OpenElement("Conditions");
+			for (uint cond_idx = 0; cond_idx < m_settings.m_conditionsPerTrigger; ++cond_idx)
+			{
+				WriteCondition(printer);
+			}
+			printer.CloseElement();
+
+			printer.OpenElement("Actions");
+			for (uint action_idx = 0; action_idx < m_settings.m_actionsPerTrigger; ++action_idx)
+			{
+				WriteAction(printer);
+			}
+			printer.CloseElement();
+
+			printer.CloseElement();
+		}
+
+		printer.CloseElement();
+	}
+
+	printer.CloseElement();
+}
+
+
+void ScenarioGenerator::WriteVictoryConditions(tinyxml2::XMLPrinter& printer)
+{
+	printer.OpenElement("VictoryConditions");
+
+	for (uint cond_idx = 0; cond_idx < m_settings.m_numVictoryConditions; ++cond_idx)
+	{
+		const CardType type = GetRandomCardType();
+
+		printer.OpenElement("Condition");
+		printer.PushAttribute("CardType", s_cardTypeNames[type]);
+		printer.PushAttribute("CardName", GetRandomCardName(type).c_str());
+		printer.PushAttribute("CardState", GetRandomStateName(type).c_str());
+		printer.CloseElement();
+	}
+
+	printer.CloseElement();
+}
+
+
+void ScenarioGenerator::WriteStates(tinyxml2::XMLPrinter& printer, const CardType type)
+{
+	printer.OpenElement("States");
+
+	for (uint state_idx = 0; state_idx < m_settings.m_statesPerCard; ++state_idx)
+	{
+		printer.OpenElement("State");
+		printer.PushAttribute("Name", GetStateName(type, state_idx).c_str());
+		printer.PushAttribute("AddGameTime", true);
+
+		if (type == CARD_LOCATION)
+		{
+			printer.PushAttribute("CanMoveHere", state_idx != 0);
+			printer.PushAttribute("SpcialAction", state_idx == 0 ? "None" : "InvestigateLocation");
+			printer.PushAttribute("Description", Stringf("> %s description.", GetStateName(type, state_idx).c_str()).c_str());
+		}
+		else if (type == CARD_CHARACTER)
+		{
+			printer.PushAttribute("ContextMode", state_idx == 0 ? "None" : "Interrogation");
+		}
+
+		printer.CloseElement();
+	}
+
+	printer.CloseElement();
+}
+
+
+// The first rule of every list is the catch all, the rest point at random cards and sometimes change a card's state
+void ScenarioGenerator::WriteScanRule(tinyxml2::XMLPrinter& printer, const CardType owner_type, const CardType subject_type, const bool is_catch_all)
+{
+	const String subject_name = is_catch_all ? "*" : GetRandomCardName(subject_type);
+	const String subject_state = is_catch_all || RandomChance(50) ? "*" : GetRandomStateName(subject_type);
+
+	printer.OpenElement("Scan");
+	printer.PushAttribute("State", RandomChance(75) ? "*" : GetRandomStateName(owner_type).c_str());
+
+	if (owner_type == CARD_LOCATION)
+	{
+		printer.PushAttribute(subject_type == CARD_CHARACTER ? "Character" : "Item", subject_name.c_str());
+		printer.PushAttribute(subject_type == CARD_CHARACTER ? "CharacterState" : "ItemState", subject_state.c_str());
+	}
+	else
+	{
+		const bool any_location = RandomChance(75);
+		printer.PushAttribute("Loc", any_location ? "*" : GetRandomCardName(CARD_LOCATION).c_str());
+		printer.PushAttribute("LocState", any_location ? "*" : GetRandomStateName(CARD_LOCATION).c_str());
+		printer.PushAttribute(subject_type == CARD_CHARACTER ? "Char" : "Item", subject_name.c_str());
+		printer.PushAttribute(subject_type == CARD_CHARACTER ? "CharState" : "ItemState", subject_state.c_str());
+	}
+
+	printer.PushAttribute("Line", is_catch_all ? "Nothing to say about that." : Stringf("Line about %s.", subject_name.c_str()).c_str());
+
+	if (!is_catch_all && RandomChance(25))
+	{
+		WriteSetCardState(printer);
+	}
+
+	printer.CloseElement();
+}
+
+
+void ScenarioGenerator::WriteCondition(tinyxml2::XMLPrinter& printer)
+{
+	const CardType type = GetRandomCardType();
+
+	switch (RandomIndex(4))
+	{
+		case 0:
+		{
+			printer.OpenElement("TimePassed");
+			printer.PushAttribute("since", "EventEnabled");
+			printer.PushAttribute("daysPassed", 0);
+			printer.PushAttribute("hoursPassed", RandomIndex(4));
+			printer.PushAttribute("minutesPassed", RandomIndex(60));
+			break;
+		}
+		case 1:
+		{
+			printer.OpenElement("LocationCheck");
+			printer.PushAttribute("location", GetRandomCardName(CARD_LOCATION).c_str());
+			printer.PushAttribute("condition", RandomChance(50) ? "Inside" : "Outside");
+			break;
+		}
+		case 2:
+		{
+			printer.OpenElement("ContextCheck");
+			printer.PushAttribute("object", GetRandomCardName(type).c_str());
+			printer.PushAttribute("type", s_cardTypeNames[type]);
+			printer.PushAttribute("condition", RandomChance(50) ? "Is" : "Is not");
+			break;
+		}
+		default:
+		{
+			printer.OpenElement("ObjectStateCheck");
+			printer.PushAttribute("object", GetRandomCardName(type).c_str());
+			printer.PushAttribute("type", s_cardTypeNames[type]);
+			printer.PushAttribute("operation", RandomChance(50) ? "Is" : "Is not");
+			printer.PushAttribute("State", GetRandomStateName(type).c_str());
+			break;
+		}
+	}
+
+	printer.CloseElement();
+}
+
+
+void ScenarioGenerator::WriteAction(tinyxml2::XMLPrinter& printer)
+{
+	switch (RandomIndex(3))
+	{
+		case 0:
+		{
+			printer.OpenElement("DisplayText");
+			printer.PushAttribute("type", "Tutorial");
+			printer.PushAttribute("message", "> Something happened.");
+			printer.CloseElement();
+			break;
+		}
+		case 1:
+		{
+			printer.OpenElement("ActivateIncident");
+			printer.PushAttribute("incident", Stringf("Incident %u", RandomIndex(m_settings.m_numIncidents)).c_str());
+			printer.PushAttribute("set", RandomChance(50) ? "Enable" : "Disable");
+			printer.CloseElement();
+			break;
+		}
+		default:
+		{
+			WriteSetCardState(printer);
+			break;
+		}
+	}
+}
+
+
+void ScenarioGenerator::WriteSetCardState(tinyxml2::XMLPrinter& printer)
+{
+	const CardType type = GetRandomCardType();
+
+	printer.OpenElement("SetCardState");
+	printer.PushAttribute("type", s_cardTypeNames[type]);
+	printer.PushAttribute("name", GetRandomCardName(type).c_str());
+	printer.PushAttribute("fromState", GetRandomStateName(type).c_str());
+	printer.PushAttribute("toState", GetRandomStateName(type).c_str());
+	printer.CloseElement();
+}
+
+
+uint ScenarioGenerator::GetNumCards(const CardType type) const
+{
+	switch (type)
+	{
+		case CARD_LOCATION:		return m_settings.m_numLocations;
+		case CARD_CHARACTER:	return m_settings.m_numCharacters;
+		case CARD_ITEM:			return m_settings.m_numItems;
+		default:				return 0;
+	}
+}
+
+
+String ScenarioGenerator::GetCardName(const CardType type, const uint card_idx) const
+{
+	return Stringf("%s %u", s_cardTypeNames[type], card_idx);
+}
+
+
+// The first two states are the ones the game looks for by name, open locations and found evidence
+String ScenarioGenerator::GetStateName(const CardType type, const uint state_idx) const
+{
+	if (state_idx == 0)
+	{
+		return type == CARD_LOCATION ? "Closed" : "Not Found";
+	}
+
+	if (state_idx == 1)
+	{
+		return type == CARD_LOCATION ? "Open" : "Found";
+	}
+
+	return Stringf("State %u", state_idx);
+}
+
+
+String ScenarioGenerator::GetRandomCardName(const CardType type)
+{
+	return GetCardName(type, RandomIndex(GetNumCards(type)));
+}
+
+
+String ScenarioGenerator::GetRandomStateName(const CardType type)
+{
+	return GetStateName(type, RandomIndex(m_settings.m_statesPerCard));
+}
+
+
+// Only picks types that have cards
+CardType ScenarioGenerator::GetRandomCardType()
+{
+	CardType type = static_cast<CardType>(RandomIndex(NUM_CARD_TYPES));
+	while (GetNumCards(type) == 0)
+	{
+		type = static_cast<CardType>((type + 1) % NUM_CARD_TYPES);
+	}
+
+	return type;
+}
+
+
+// Plain modulo instead of the std distributions, those differ between standard libraries and would break reproducibility
+uint ScenarioGenerator::RandomIndex(const uint count)
+{
+	return count == 0 ? 0 : static_cast<uint>(m_rng() % count);
+}
+
+
+bool ScenarioGenerator::RandomChance(const uint percent)
+{
+	return RandomIndex(100) < percent;
+}
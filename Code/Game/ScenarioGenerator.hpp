@@ -0,0 +1,71 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <random>
+
+namespace tinyxml2
+{
+	class XMLPrinter;
+}
+
+// Writes a valid scenario folder of any size for profiling and stress tests. The defaults are roughly the size of the
+// tutorial, ScaleCounts multiplies the number of cards and incidents while the per card counts stay the same.
+// The same settings and seed always write the same files.
+
+struct ScenarioGeneratorSettings
+{
+public:
+	void ScaleCounts(uint scale);
+
+public:
+	uint	m_seed = 1;
+
+	uint	m_numLocations = 3;
+	uint	m_numCharacters = 8;
+	uint	m_numItems = 9;
+	uint	m_statesPerCard = 3;
+	uint	m_scanRulesPerCard = 8;			// dialogue rules per character, introduction rules per location
+	uint	m_numIncidents = 19;
+	uint	m_triggersPerIncident = 1;
+	uint	m_conditionsPerTrigger = 1;
+	uint	m_actionsPerTrigger = 1;
+	uint	m_numVictoryConditions = 4;
+};
+
+
+//------------------------------------------------------------
+class ScenarioGenerator
+{
+public:
+	explicit ScenarioGenerator(const ScenarioGeneratorSettings& settings);
+
+	bool WriteScenarioFolder(const String& folder_dir);
+
+private:
+	void WriteLocations(tinyxml2::XMLPrinter& printer);
+	void WriteCharacters(tinyxml2::XMLPrinter& printer);
+	void WriteItems(tinyxml2::XMLPrinter& printer);
+	void WriteSettings(tinyxml2::XMLPrinter& printer, const String& scenario_name);
+	void WriteIncidents(tinyxml2::XMLPrinter& printer);
+	void WriteVictoryConditions(tinyxml2::XMLPrinter& printer);
+
+	void WriteStates(tinyxml2::XMLPrinter& printer, CardType type);
+	void WriteScanRule(tinyxml2::XMLPrinter& printer, CardType owner_type, CardType subject_type, bool is_catch_all);
+	void WriteCondition(tinyxml2::XMLPrinter& printer);
+	void WriteAction(tinyxml2::XMLPrinter& printer);
+	void WriteSetCardState(tinyxml2::XMLPrinter& printer);
+
+	uint	GetNumCards(CardType type) const;
+	String	GetCardName(CardType type, uint card_idx) const;
+	String	GetStateName(CardType type, uint state_idx) const;
+	String	GetRandomCardName(CardType type);
+	String	GetRandomStateName(CardType type);
+	CardType GetRandomCardType();
+
+	uint RandomIndex(uint count);
+	bool RandomChance(uint percent);
+
+private:
+	ScenarioGeneratorSettings	m_settings;
+	std::mt19937				m_rng;
+};
@@ -0,0 +1,449 @@
+#include "Game/ScenarioImage.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+#include <cstdio>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//------------------------------------------------------------
+ScenarioImageWriter::ScenarioImageWriter()
+{
+	// index 0 is always the empty string
+	AddToStringTable("");
+}
+
+
+ScenarioImageWriter::~ScenarioImageWriter() = default;
+
+
+void ScenarioImageWriter::WriteU32(const uint32_t value)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+	m_body.insert(m_body.end(), bytes, bytes + sizeof(uint32_t));
+}
+
+
+void ScenarioImageWriter::WriteI32(const int value)
+{
+	WriteU32(static_cast<uint32_t>(value));
+}
+
+
+void ScenarioImageWriter::WriteBool(const bool value)
+{
+	WriteU32(value ? 1u : 0u);
+}
+
+
+void ScenarioImageWriter::WriteString(const String& value)
+{
+	WriteU32(AddToStringTable(value));
+}
+
+
+void ScenarioImageWriter::WriteStringList(const StringList& values)
+{
+	const uint32_t num_values = static_cast<uint32_t>(values.size());
+	WriteU32(num_values);
+
+	for (uint32_t value_idx = 0; value_idx < num_values; ++value_idx)
+	{
+		WriteString(values[value_idx]);
+	}
+}
+
+
+void ScenarioImageWriter::WriteGameTime(const GameTime& time)
+{
+	WriteU32(time.m_min);
+	WriteU32(time.m_hour);
+	WriteU32(time.m_day);
+}
+
+
+bool ScenarioImageWriter::SaveToFile(const String& file_path, const uint32_t source_hash) const
+{
+	// build the string table
+	std::vector<uint32_t> string_offsets;
+	std::vector<unsigned char> string_data;
+	string_offsets.reserve(m_strings.size());
+
+	const uint32_t num_strings = static_cast<uint32_t>(m_strings.size());
+	for (uint32_t string_idx = 0; string_idx < num_strings; ++string_idx)
+	{
+		const String& value = m_strings[string_idx];
+		string_offsets.push_back(static_cast<uint32_t>(string_data.size()));
+		string_data.insert(string_data.end(), value.begin(), value.end());
+		string_data.push_back('\0');
+	}
+
+	// keep the body 4 byte aligned
+	while (string_data.size() % sizeof(uint32_t) != 0)
+	{
+		string_data.push_back('\0');
+	}
+
+	std::vector<unsigned char> payload;
+	payload.reserve(string_offsets.size() * sizeof(uint32_t) + string_data.size() + m_body.size());
+
+	const unsigned char* offset_bytes = reinterpret_cast<const unsigned char*>(string_offsets.data());
+	payload.insert(payload.end(), offset_bytes, offset_bytes + string_offsets.size() * sizeof(uint32_t));
+	payload.insert(payload.end(), string_data.begin(), string_data.end());
+	payload.insert(payload.end(), m_body.begin(), m_body.end());
+
+	ScenarioImageHeader header;
+	memcpy(header.m_magic, SCENARIO_IMAGE_MAGIC, sizeof(header.m_magic));
+	header.m_version = SCENARIO_IMAGE_VERSION;
+	header.m_fileSize = static_cast<uint32_t>(sizeof(ScenarioImageHeader) + payload.size());
+	header.m_checksum = HashBytes(payload.data(), payload.size());
+	header.m_sourceHash = source_hash;
+	header.m_stringCount = num_strings;
+	header.m_stringDataSize = static_cast<uint32_t>(string_data.size());
+	header.m_bodySize = static_cast<uint32_t>(m_body.size());
+
+	// the caller says what failed, a cache that could not be written is only a warning
+	FILE* file = fopen(file_path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fwrite(&header, sizeof(ScenarioImageHeader), 1, file);
+	fwrite(payload.data(), 1, payload.size(), file);
+	fclose(file);
+
+	return true;
+}
+
+
+uint32_t ScenarioImageWriter::AddToStringTable(const String& value)
+{
+	const std::map<String, uint32_t>::iterator string_itr = m_stringLookup.find(value);
+	if (string_itr != m_stringLookup.end())
+	{
+		return string_itr->second;
+	}
+
+	const uint32_t string_idx = static_cast<uint32_t>(m_strings.size());
+	m_strings.push_back(value);
+	m_stringLookup.insert(std::pair<String, uint32_t>(value, string_idx));
+
+	return string_idx;
+}
+
+
+//------------------------------------------------------------
+ScenarioImageReader::ScenarioImageReader() = default;
+
+
+ScenarioImageReader::~ScenarioImageReader()
+{
+	Close();
+}
+
+
+bool ScenarioImageReader::OpenFile(const String& file_path)
+{
+	Close();
+
+	if (!MapFile(file_path))
+	{
+		return false;
+	}
+
+	if (m_imageSize < sizeof(ScenarioImageHeader))
+	{
+		ERROR_RECOVERABLE(Stringf("Scenario image %s is too small to be valid", file_path.c_str()));
+		Close();
+		return false;
+	}
+
+	const ScenarioImageHeader* header = reinterpret_cast<const ScenarioImageHeader*>(m_image);
+	const size_t string_offsets_size = static_cast<size_t>(header->m_stringCount) * sizeof(uint32_t);
+	const size_t payload_size = m_imageSize - sizeof(ScenarioImageHeader);
+	const unsigned char* payload = m_image + sizeof(ScenarioImageHeader);
+
+	if (memcmp(header->m_magic, SCENARIO_IMAGE_MAGIC, sizeof(header->m_magic)) != 0)
+	{
+		ERROR_RECOVERABLE(Stringf("%s is not a compiled scenario", file_path.c_str()));
+		Close();
+		return false;
+	}
+
+	if (header->m_version != SCENARIO_IMAGE_VERSION)
+	{
+		ERROR_RECOVERABLE(Stringf("Scenario image %s is version %u, expected version %u. Recompile the scenario.",
+			file_path.c_str(), header->m_version, SCENARIO_IMAGE_VERSION));
+		Close();
+		return false;
+	}
+
+	if (header->m_fileSize != m_imageSize
+		|| string_offsets_size + header->m_stringDataSize + header->m_bodySize != payload_size
+		|| HashBytes(payload, payload_size) != header->m_checksum)
+	{
+		ERROR_RECOVERABLE(Stringf("Scenario image %s is corrupt", file_path.c_str()));
+		Close();
+		return false;
+	}
+
+	// a string read later is a pointer into the block, so every one has to start and end inside it
+	const uint32_t* string_offsets = reinterpret_cast<const uint32_t*>(payload);
+	const char* string_data = reinterpret_cast<const char*>(payload + string_offsets_size);
+	bool strings_in_block = header->m_stringCount == 0
+		|| (header->m_stringDataSize > 0 && string_data[header->m_stringDataSize - 1] == '\0');
+	for (uint32_t string_idx = 0; string_idx < header->m_stringCount && strings_in_block; ++string_idx)
+	{
+		strings_in_block = string_offsets[string_idx] < header->m_stringDataSize;
+	}
+
+	if (!strings_in_block)
+	{
+		ERROR_RECOVERABLE(Stringf("Scenario image %s has a string outside its string table", file_path.c_str()));
+		Close();
+		return false;
+	}
+
+	m_stringCount = header->m_stringCount;
+	m_stringOffsets = string_offsets;
+	m_stringData = string_data;
+	m_cursor = payload + string_offsets_size + header->m_stringDataSize;
+	m_bodyEnd = m_cursor + header->m_bodySize;
+	m_overrun = false;
+
+	return true;
+}
+
+
+// Lets a cache be rejected without mapping the whole file
+STATIC bool ScenarioImageReader::ReadSourceHash(const String& file_path, uint32_t& out_source_hash)
+{
+	FILE* file = fopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	ScenarioImageHeader header;
+	const bool read_header = fread(&header, sizeof(ScenarioImageHeader), 1, file) == 1;
+	fclose(file);
+
+	if (!read_header
+		|| memcmp(header.m_magic, SCENARIO_IMAGE_MAGIC, sizeof(header.m_magic)) != 0
+		|| header.m_version != SCENARIO_IMAGE_VERSION)
+	{
+		return false;
+	}
+
+	out_source_hash = header.m_sourceHash;
+	return true;
+}
+
+
+void ScenarioImageReader::Close()
+{
+	UnmapFile();
+
+	m_image = nullptr;
+	m_imageSize = 0;
+	m_stringOffsets = nullptr;
+	m_stringData = nullptr;
+	m_stringCount = 0;
+	m_cursor = nullptr;
+	m_bodyEnd = nullptr;
+}
+
+
+bool ScenarioImageReader::IsValid() const
+{
+	return m_image != nullptr && !m_overrun;
+}
+
+
+uint32_t ScenarioImageReader::ReadU32()
+{
+	if (m_cursor == nullptr || m_cursor + sizeof(uint32_t) > m_bodyEnd)
+	{
+		m_overrun = true;
+		return 0;
+	}
+
+	uint32_t value;
+	memcpy(&value, m_cursor, sizeof(uint32_t));
+	m_cursor += sizeof(uint32_t);
+
+	return value;
+}
+
+
+int ScenarioImageReader::ReadI32()
+{
+	return static_cast<int>(ReadU32());
+}
+
+
+bool ScenarioImageReader::ReadBool()
+{
+	return ReadU32() != 0;
+}
+
+
+const char* ScenarioImageReader::ReadString()
+{
+	const uint32_t string_idx = ReadU32();
+
+	if (string_idx >= m_stringCount)
+	{
+		m_overrun = true;
+		return "";
+	}
+
+	return m_stringData + m_stringOffsets[string_idx];
+}
+
+
+StringList ScenarioImageReader::ReadStringList()
+{
+	const uint32_t num_values = ReadU32();
+
+	StringList values;
+	values.reserve(num_values);
+
+	for (uint32_t value_idx = 0; value_idx < num_values && !m_overrun; ++value_idx)
+	{
+		values.emplace_back(ReadString());
+	}
+
+	return values;
+}
+
+
+GameTime ScenarioImageReader::ReadGameTime()
+{
+	GameTime time;
+	time.m_min = ReadU32();
+	time.m_hour = ReadU32();
+	time.m_day = ReadU32();
+
+	return time;
+}
+
+
+#if defined(_WIN32)
+bool ScenarioImageReader::MapFile(const String& file_path)
+{
+	HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_fileHandle = file;
+	m_mappingHandle = mapping;
+	m_image = static_cast<const unsigned char*>(view);
+	m_imageSize = static_cast<size_t>(file_size.QuadPart);
+
+	return true;
+}
+
+
+void ScenarioImageReader::UnmapFile()
+{
+	if (m_image != nullptr)
+	{
+		UnmapViewOfFile(m_image);
+	}
+
+	if (m_mappingHandle != nullptr)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = nullptr;
+	}
+
+	if (m_fileHandle != nullptr)
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle = nullptr;
+	}
+}
+#else
+bool ScenarioImageReader::MapFile(const String& file_path)
+{
+	const int file = open(file_path.c_str(), O_RDONLY);
+
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat file_stats;
+	if (fstat(file, &file_stats) != 0 || file_stats.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(file_stats.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	if (view == MAP_FAILED)
+	{
+		close(file);
+		return false;
+	}
+
+	m_fileDescriptor = file;
+	m_image = static_cast<const unsigned char*>(view);
+	m_imageSize = static_cast<size_t>(file_stats.st_size);
+
+	return true;
+}
+
+
+void ScenarioImageReader::UnmapFile()
+{
+	if (m_image != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(m_image), m_imageSize);
+	}
+
+	if (m_fileDescriptor >= 0)
+	{
+		close(m_fileDescriptor);
+		m_fileDescriptor = -1;
+	}
+}
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <cstdint>
+
+// A compiled scenario is a single versioned binary file that holds everything the six scenario xml files
+// describe. Every string is stored once in the string table and referenced by index from the entity tables.
+//
+// Layout:
+//	ScenarioImageHeader
+//	string offsets		uint32[m_stringCount]		(relative to the start of the string data)
+//	string data			null terminated utf-8 strings
+//	body				settings, locations, characters, items, incidents, victory conditions
+
+constexpr char		SCENARIO_IMAGE_MAGIC[4] = { 'C', 'O', 'C', 'S' };
+constexpr uint32_t	SCENARIO_IMAGE_VERSION = 2;
+constexpr char		SCENARIO_IMAGE_FILE_NAME[] = "Scenario.cocs";
+constexpr char		SCENARIO_CACHE_FILE_NAME[] = "ScenarioCache.cocs";
+
+struct ScenarioImageHeader
+{
+	char		m_magic[4];
+	uint32_t	m_version = 0;
+	uint32_t	m_fileSize = 0;
+	uint32_t	m_checksum = 0;			// FNV-1a of everything after the header
+	uint32_t	m_sourceHash = 0;		// hash of the xml the image was built from, 0 when it is not a cache
+	uint32_t	m_stringCount = 0;
+	uint32_t	m_stringDataSize = 0;
+	uint32_t	m_bodySize = 0;
+};
+
+
+//------------------------------------------------------------
+class ScenarioImageWriter
+{
+public:
+	ScenarioImageWriter();
+	~ScenarioImageWriter();
+
+	void WriteU32(uint32_t value);
+	void WriteI32(int value);
+	void WriteBool(bool value);
+	void WriteString(const String& value);
+	void WriteStringList(const StringList& values);
+	void WriteGameTime(const GameTime& time);
+
+	bool SaveToFile(const String& file_path, uint32_t source_hash = 0) const;
+
+private:
+	uint32_t AddToStringTable(const String& value);
+
+private:
+	std::vector<unsigned char>		m_body;
+	std::map<String, uint32_t>		m_stringLookup;
+	StringList						m_strings;
+};
+
+
+//------------------------------------------------------------
+// Maps a compiled scenario into memory and hands out its records in the order they were written.
+// Strings returned by ReadString point straight into the mapped image.
+class ScenarioImageReader
+{
+public:
+	ScenarioImageReader();
+	~ScenarioImageReader();
+
+	bool OpenFile(const String& file_path);
+	static bool ReadSourceHash(const String& file_path, uint32_t& out_source_hash);	// reads only the header
+	void Close();
+	bool IsValid() const;
+
+	uint32_t	ReadU32();
+	int			ReadI32();
+	bool		ReadBool();
+	const char*	ReadString();
+	StringList	ReadStringList();
+	GameTime	ReadGameTime();
+
+private:
+	bool MapFile(const String& file_path);
+	void UnmapFile();
+
+private:
+	const unsigned char*	m_image = nullptr;
+	size_t					m_imageSize = 0;
+
+	const uint32_t*			m_stringOffsets = nullptr;
+	const char*				m_stringData = nullptr;
+	uint32_t				m_stringCount = 0;
+
+	const unsigned char*	m_cursor = nullptr;
+	const unsigned char*	m_bodyEnd = nullptr;
+	bool					m_overrun = false;
+
+	// platform handles for the mapping
+	void*	m_fileHandle = nullptr;
+	void*	m_mappingHandle = nullptr;
+	int		m_fileDescriptor = -1;
+};
@@ -0,0 +1,60 @@
+#include "Game/SymbolTable.hpp"
+#include "Game/CaseFold.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+
+//------------------------------------------------------------
+SymbolTable::SymbolTable()
+{
+	const SymbolId empty_id = Intern("");
+	const SymbolId wildcard_id = Intern("*");
+
+	ASSERT_OR_DIE(empty_id == SYMBOL_EMPTY && wildcard_id == SYMBOL_WILDCARD, "SymbolTable reserved ids are out of order");
+}
+
+
+SymbolId SymbolTable::Intern(const String& text)
+{
+	FoldCase(text, m_foldBuffer);
+
+	const std::map<String, SymbolId>::iterator id_itr = m_ids.find(m_foldBuffer);
+	if (id_itr != m_ids.end())
+	{
+		return id_itr->second;
+	}
+
+	const SymbolId new_id = static_cast<SymbolId>(m_strings.size());
+	m_strings.push_back(m_foldBuffer);
+	m_ids.insert(std::pair<String, SymbolId>(m_foldBuffer, new_id));
+
+	return new_id;
+}
+
+
+SymbolId SymbolTable::Find(const String& text) const
+{
+	FoldCase(text, m_foldBuffer);
+
+	const std::map<String, SymbolId>::const_iterator id_itr = m_ids.find(m_foldBuffer);
+	if (id_itr == m_ids.end())
+	{
+		return INVALID_SYMBOL;
+	}
+
+	return id_itr->second;
+}
+
+
+const String& SymbolTable::GetString(const SymbolId id) const
+{
+	ASSERT_OR_DIE(id < m_strings.size(), Stringf("Symbol id %u was never interned", id));
+	return m_strings[id];
+}
+
+
+uint SymbolTable::GetNumSymbols() const
+{
+	return static_cast<uint>(m_strings.size());
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <deque>
+
+// Card names, state names and dialogue keys are case folded once at load time and handed out as dense ids.
+// Everything that used to compare StringToLower'd strings on a turn compares ids instead.
+// Ids are never released, so ones handed out before a hot reload stay valid after it.
+// Not thread safe, the parallel loader only parses xml on its workers and interns on the main thread.
+
+class SymbolTable
+{
+public:
+	SymbolTable();
+
+	SymbolId		Intern(const String& text);
+	SymbolId		Find(const String& text) const;		// INVALID_SYMBOL when the text was never interned
+	const String&	GetString(SymbolId id) const;
+	uint			GetNumSymbols() const;
+
+private:
+	std::deque<String>			m_strings;		// deque so GetString references survive later interns
+	std::map<String, SymbolId>	m_ids;
+	mutable String				m_foldBuffer;	// so a lookup folds without allocating
+};
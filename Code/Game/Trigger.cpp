@@ -1,6 +1,10 @@
 #include "Game/Trigger.hpp"
 #include "Game/Condition.hpp"
 #include "Game/Action.hpp"
+#include "Game/Incident.hpp"
+#include "Game/Scenario.hpp"
+#include "Game/ScenarioImage.hpp"
+#include "Game/IncidentProgram.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
@@ -52,27 +56,22 @@ Trigger::Trigger(Incident* scenario_event, const XmlElement* element) : m_scenar
 }
 
 
-Trigger::~Trigger()
+Trigger::Trigger(Incident* scenario_event, ScenarioImageReader& reader) : m_scenarioEvent(scenario_event)
 {
-	const uint num_actions = static_cast<uint>(m_actions.size());
-	for (uint act_idx = 0; act_idx < num_actions; ++act_idx)
-	{
-		delete m_actions[act_idx];
-		m_actions[act_idx] = nullptr;
-	}
+	m_name = reader.ReadString();
+	ImportConditionsFromImage(reader);
+	ReadActionListFromImage(m_actions, m_scenarioEvent->GetOwner(), reader);
+}
 
-	const uint num_conditions = static_cast<uint>(m_conditions.size());
-	for (uint cond_idx = 0; cond_idx < num_conditions; ++cond_idx)
-	{
-		delete m_conditions[cond_idx];
-		m_conditions[cond_idx] = nullptr;
-	}
+
+// the conditions and actions belong to the scenario arena
+Trigger::~Trigger()
+{
 }
 
 
-bool Trigger::Execute()
+bool Trigger::TestConditions() const
 {
-	
 	// the set of conditions in an incident is using logical 'and'
 	const uint num_conditions = static_cast<uint>(m_conditions.size());
 	for(uint con_idx = 0; con_idx < num_conditions; ++con_idx)
@@ -85,12 +84,6 @@ bool Trigger::Execute()
 		}
 	}
 
-	const uint num_actions = static_cast<uint>(m_actions.size());
-	for (uint act_idx = 0; act_idx < num_actions; ++act_idx)
-	{
-		m_actions[act_idx]->Execute();
-	}
-
 	return true;
 }
 
@@ -101,7 +94,13 @@ Incident* Trigger::GetOwner() const
 }
 
 
-String Trigger::GetName() const
+ScenarioArena& Trigger::GetArena() const
+{
+	return m_scenarioEvent->GetOwner()->GetArena();
+}
+
+
+const String& Trigger::GetName() const
 {
 	return m_name;
 }
@@ -119,6 +118,54 @@ const ActionList* Trigger::GetActionList() const
 }
 
 
+void Trigger::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteString(m_name);
+
+	const uint num_conditions = static_cast<uint>(m_conditions.size());
+	writer.WriteU32(num_conditions);
+	for (uint cond_idx = 0; cond_idx < num_conditions; ++cond_idx)
+	{
+		writer.WriteI32(m_conditions[cond_idx]->GetType());
+		m_conditions[cond_idx]->WriteToImage(writer);
+	}
+
+	WriteActionListToImage(writer, m_actions);
+}
+
+
+void Trigger::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	const String trigger_referrer = Stringf("%s, trigger %s", referrer.c_str(), m_name.c_str());
+
+	const uint num_conditions = static_cast<uint>(m_conditions.size());
+	for (uint cond_idx = 0; cond_idx < num_conditions; ++cond_idx)
+	{
+		m_conditions[cond_idx]->LinkReferences(trigger_referrer, out_errors);
+	}
+
+	LinkActionListReferences(m_actions, trigger_referrer, out_errors);
+}
+
+
+void Trigger::CompileInto(IncidentProgram& program, const int trigger_idx) const
+{
+	program.BeginTrigger();
+
+	for (Condition* condition : m_conditions)
+	{
+		condition->CompileInto(program);
+	}
+
+	for (Action* action : m_actions)
+	{
+		program.EmitAction(action);
+	}
+
+	program.EndTrigger(trigger_idx);
+}
+
+
 void Trigger::ImportConditionsFromXml(const XmlElement* element)
 {
 	for (const XmlElement* child_element = element->FirstChildElement();
@@ -130,22 +177,22 @@ void Trigger::ImportConditionsFromXml(const XmlElement* element)
 
 		if (element_name == "objectstatecheck")
 		{
-			m_conditions.push_back(new ConditionStateCheck(this, child_element));
+			m_conditions.push_back(GetArena().Create<ConditionStateCheck>(this, child_element));
 
 		}
 		else if (element_name == "timepassed")
 		{
-			m_conditions.push_back(new ConditionTimePassed(this, child_element));
+			m_conditions.push_back(GetArena().Create<ConditionTimePassed>(this, child_element));
 
 		}
 		else if (element_name == "locationcheck")
 		{
-			m_conditions.push_back(new ConditionLocationCheck(this, child_element));
+			m_conditions.push_back(GetArena().Create<ConditionLocationCheck>(this, child_element));
 
 		}
 		else if (element_name == "contextcheck")
 		{
-			m_conditions.push_back(new ConditionContextCheck(this, child_element));
+			m_conditions.push_back(GetArena().Create<ConditionContextCheck>(this, child_element));
 
 		}
 		else
@@ -167,17 +214,17 @@ void Trigger::ImportActionsFromXml(const XmlElement* element)
 
 		if (element_name == "displaytext")
 		{
-			m_actions.push_back(new ActionDisplayText(this, child_element));
+			m_actions.push_back(GetArena().Create<ActionDisplayText>(this, child_element));
 
 		}
 		else if (element_name == "activateincident")
 		{
-			m_actions.push_back(new ActionIncidentToggle(this, child_element));
+			m_actions.push_back(GetArena().Create<ActionIncidentToggle>(this, child_element));
 
 		}
 		else if (element_name == "setcardstate")
 		{
-			m_actions.push_back(new ActionChangeCardState(this, child_element));
+			m_actions.push_back(GetArena().Create<ActionChangeCardState>(this, child_element));
 
 		}
 		else
@@ -187,3 +234,43 @@ void Trigger::ImportActionsFromXml(const XmlElement* element)
 	}
 }
 
+
+void Trigger::ImportConditionsFromImage(ScenarioImageReader& reader)
+{
+	const uint num_conditions = reader.ReadU32();
+	m_conditions.reserve(num_conditions);
+
+	for (uint cond_idx = 0; cond_idx < num_conditions; ++cond_idx)
+	{
+		const ConditionType type = static_cast<ConditionType>(reader.ReadI32());
+
+		switch (type)
+		{
+		case CONDITION_CARD_STATE:
+		{
+			m_conditions.push_back(GetArena().Create<ConditionStateCheck>(this, reader));
+			break;
+		}
+		case CONDITION_TIME_PASSED:
+		{
+			m_conditions.push_back(GetArena().Create<ConditionTimePassed>(this, reader));
+			break;
+		}
+		case CONDITION_LOCATION:
+		{
+			m_conditions.push_back(GetArena().Create<ConditionLocationCheck>(this, reader));
+			break;
+		}
+		case CONDITION_CONTEXT:
+		{
+			m_conditions.push_back(GetArena().Create<ConditionContextCheck>(this, reader));
+			break;
+		}
+		default:
+		{
+			ERROR_AND_DIE(Stringf("Unknown condition type %i in '%s' Trigger of the scenario image", type, m_name.c_str()));
+			break;
+		}
+		}
+	}
+}
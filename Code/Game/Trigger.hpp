@@ -2,24 +2,34 @@
 #include "Game/GameCommon.hpp"
 
 class Incident;
+class ScenarioArena;
+class IncidentProgram;
 
 class Trigger
 {
 public:
 	explicit Trigger(Incident* scenario_event, const XmlElement* element);
+	explicit Trigger(Incident* scenario_event, ScenarioImageReader& reader);
 	~Trigger();
 
-	bool	Execute();
+	bool	TestConditions() const;		// through the virtual Test, the program compiled from it is what play runs
 
 	Incident*				GetOwner() const;
-	String					GetName() const;
+	const String&			GetName() const;
 	const ConditionList*	GetConditionList() const;
 	const ActionList*		GetActionList() const;
 
+	void	WriteToImage(ScenarioImageWriter& writer) const;
+	void	LinkReferences(const String& referrer, StringList& out_errors);
+	void	CompileInto(IncidentProgram& program, int trigger_idx) const;
+
 
 private:
+	ScenarioArena& GetArena() const;
+
 	void ImportConditionsFromXml(const XmlElement* element);
 	void ImportActionsFromXml(const XmlElement* element);
+	void ImportConditionsFromImage(ScenarioImageReader& reader);
 
 private:
 	Incident*	m_scenarioEvent = nullptr;
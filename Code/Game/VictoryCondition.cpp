@@ -3,6 +3,7 @@
 #include "Game/Location.hpp"
 #include "Game/Character.hpp"
 #include "Game/Item.hpp"
+#include "Game/ScenarioImage.hpp"
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
@@ -41,11 +42,11 @@ VictoryCondition::VictoryCondition(Scenario* the_scenario, const XmlElement* ele
 		}
 		else if(attribute_name == "cardname")
 		{
-			m_cardName = StringToLower(attribute->Value());
+			m_cardNameId = m_scenario->InternName(attribute->Value());
 		}
 		else if(attribute_name == "cardstate")
 		{
-			m_requiredState = StringToLower(attribute->Value());
+			m_requiredStateId = m_scenario->InternName(attribute->Value());
 		}
 		else
 		{
@@ -55,6 +56,15 @@ VictoryCondition::VictoryCondition(Scenario* the_scenario, const XmlElement* ele
 }
 
 
+VictoryCondition::VictoryCondition(Scenario* the_scenario, ScenarioImageReader& reader) :
+	m_scenario(the_scenario)
+{
+	m_cardType = static_cast<CardType>(reader.ReadI32());
+	m_cardNameId = m_scenario->InternName(reader.ReadString());
+	m_requiredStateId = m_scenario->InternName(reader.ReadString());
+}
+
+
 VictoryCondition::~VictoryCondition()
 {
 }
@@ -68,52 +78,48 @@ bool VictoryCondition::HasConditionsBeenMet() const
 
 void VictoryCondition::TestCondition()
 {
-	if(!m_hasBeenMet)
+	// a dangling card was reported by the link pass and can never be met
+	if(m_hasBeenMet || m_cardIdx < 0)
 	{
-		switch (m_cardType)
-		{
-			case CARD_LOCATION: 
-			{
-				LookupItr loc_itr;
-				const bool in_scenario = m_scenario->IsLocationInLookupTable(loc_itr, m_cardName);
-				ASSERT_OR_DIE(in_scenario, Stringf("Could not find the location %s for condition check.", m_cardName.c_str()));
-
-				Location* loc_card = m_scenario->GetLocationFromList(loc_itr->second);
-				const String loc_state_name = StringToLower(loc_card->GetLocationState().m_name);
+		return;
+	}
 
-				m_hasBeenMet = loc_state_name == m_requiredState;
-				break;
-			}
-			case CARD_CHARACTER: 
-			{
-				LookupItr char_itr;
-				const bool in_scenario = m_scenario->IsCharacterInLookupTable(char_itr, m_cardName);
-				ASSERT_OR_DIE(in_scenario, Stringf("Could not find the character %s for condition check.", m_cardName.c_str()));
+	switch (m_cardType)
+	{
+		case CARD_LOCATION: 
+		{
+			m_hasBeenMet = m_scenario->GetLocationFromList(m_cardIdx)->GetLocationState().m_nameId == m_requiredStateId;
+			break;
+		}
+		case CARD_CHARACTER: 
+		{
+			m_hasBeenMet = m_scenario->GetCharacterFromList(m_cardIdx)->GetCharacterState().m_nameId == m_requiredStateId;
+			break;
+		}
+		case CARD_ITEM: 
+		{
+			m_hasBeenMet = m_scenario->GetItemFromList(m_cardIdx)->GetItemState().m_nameId == m_requiredStateId;
+			break;
+		}
+		default:
+		{
+			ERROR_AND_DIE(Stringf("Card Type was not set for %s condition", m_scenario->GetSymbolName(m_cardNameId).c_str()))
+			break;
+		}
+	}
+}
 
-				Character* char_card = m_scenario->GetCharacterFromList(char_itr->second);
-				const String char_state_name = StringToLower(char_card->GetCharacterState().m_name);
 
-				m_hasBeenMet = char_state_name == m_requiredState;
-				break;
-			}
-			case CARD_ITEM: 
-			{
-				LookupItr item_itr;
-				const bool in_scenario = m_scenario->IsItemInLookupTable(item_itr, m_cardName);
-				ASSERT_OR_DIE(in_scenario, Stringf("Could not find the item %s for condition check.", m_cardName.c_str()));
+void VictoryCondition::WriteToImage(ScenarioImageWriter& writer) const
+{
+	writer.WriteI32(m_cardType);
+	writer.WriteString(m_scenario->GetSymbolName(m_cardNameId));
+	writer.WriteString(m_scenario->GetSymbolName(m_requiredStateId));
+}
 
-				Item* item_card = m_scenario->GetItemFromList(item_itr->second);
-				const String item_state_name = StringToLower(item_card->GetItemState().m_name);
 
-				m_hasBeenMet = item_state_name == m_requiredState;
-				break;
-				break;
-			}
-			default:
-			{
-				ERROR_AND_DIE(Stringf("Card Type was not set for %s condition", m_cardName.c_str()))
-				break;
-			}
-		}
-	}
+void VictoryCondition::LinkReferences(const String& referrer, StringList& out_errors)
+{
+	m_cardIdx = m_scenario->LinkCardReference(m_cardType, m_cardNameId, referrer, out_errors);
+	m_scenario->LinkStateReference(m_cardType, m_cardIdx, m_requiredStateId, referrer, out_errors);
 }
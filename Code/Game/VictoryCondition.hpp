@@ -7,6 +7,7 @@ class VictoryCondition
 {
 public:
 	explicit VictoryCondition(Scenario* the_scenario, const XmlElement* element);
+	explicit VictoryCondition(Scenario* the_scenario, ScenarioImageReader& reader);
 	~VictoryCondition();
 
 	// ACCESSORS
@@ -14,12 +15,15 @@ public:
 
 	// MUTATORS
 	void TestCondition();
+	void WriteToImage(ScenarioImageWriter& writer) const;
+	void LinkReferences(const String& referrer, StringList& out_errors);
 
 	
 private:
 	CardType	m_cardType = UNKNOWN_CARD_TYPE;
-	String		m_cardName;
-	String		m_requiredState;
+	SymbolId	m_cardNameId = SYMBOL_EMPTY;
+	int			m_cardIdx = -1;
+	SymbolId	m_requiredStateId = SYMBOL_EMPTY;
 	bool		m_hasBeenMet = false;
 
 	Scenario*	m_scenario = nullptr;